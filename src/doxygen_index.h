@@ -102,6 +102,21 @@
  *
  * Available command line options:
  * - Screensaver mode (mouse and keyboard control deactivated!): \code --fullscreen \endcode
+ * - Demo mode (fullscreen, mouse and keyboard control remain active): \code --demo \endcode
+ * - Headless mode (offscreen rendering with fixed clock, requires the \c headless build): \code --headless \endcode
+ *   Optional parameters: \c --frames=N (default: 100), \c --fps=N (simulated frame rate, default: 20),
+ *   \c --time=T (start time in seconds since the Epoch, default: 0), \c --size=WxH (default: 800x600)
+ *   and \c --dump=PREFIX (write every frame to \c PREFIXnnnnn.ppm). The average, minimum and maximum
+ *   frame times are printed when done. Please note that the HUD clock uses local time, so use a fixed
+ *   time zone (e.g. \c TZ=UTC) when comparing frames against reference images.
+ * - Benchmark mode: \code --benchmark[=SECONDS] \endcode Renders a scripted animation of the given
+ *   length (synthetic clock at 20 fps, default: 60 seconds) as fast as possible: the camera follows a fixed
+ *   path and all features are toggled in turn. Frames per second, frame time percentiles and process CPU
+ *   time are printed when done. Can be combined with \c --demo (fullscreen). Note that buffer swaps might
+ *   be synchronized to the display refresh rate (driver setting).
+ * - Frame profiling: \code --profile[=FILE] \endcode Records per-phase frame timings and writes their
+ *   percentiles (p50/p95/p99) as CSV to \c FILE (default: \c starsphere_profile.csv) on exit. On POSIX
+ *   systems the profile can also be written while running by sending \c SIGUSR1 to the process.
  *
  * \subsubsection sec_app_install Installation
  *
@@ -23,6 +23,7 @@
 AbstractGraphicsEngine::AbstractGraphicsEngine(string sharedMemoryIdentifier) :
 	m_BoincAdapter(sharedMemoryIdentifier)
 {
+	m_FixedTime = -1.0;
 }
 
 AbstractGraphicsEngine::~AbstractGraphicsEngine()
@@ -33,3 +34,18 @@ void AbstractGraphicsEngine::refreshLocalBOINCInformation()
 {
 	m_BoincAdapter.refresh();
 }
+
+void AbstractGraphicsEngine::setFixedTime(const double timeOfDay)
+{
+	m_FixedTime = timeOfDay;
+}
+
+double AbstractGraphicsEngine::currentTime() const
+{
+	return m_FixedTime < 0.0 ? dtime() : m_FixedTime;
+}
+
+FrameProfiler& AbstractGraphicsEngine::profiler()
+{
+	return m_Profiler;
+}
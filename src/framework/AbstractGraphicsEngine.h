@@ -23,7 +23,10 @@
 
 #include <string>
 
+#include <util.h>
+
 #include "BOINCClientAdapter.h"
+#include "FrameProfiler.h"
 #include "Resource.h"
 
 using namespace std;
@@ -72,6 +75,9 @@ public:
 	/**
 	 * \brief This method is called when an implementing graphics engine should render one frame
 	 *
+	 * Note: implementations must not swap the buffers themselves, this is done by the
+	 * caller (which might not even use a window, see \ref HeadlessRenderer).
+	 *
 	 * \param timeOfDay The current time in "seconds since the Epoch" (with microsecond precision)
 	 */
 	virtual void render(const double timeOfDay) = 0;
@@ -161,16 +167,62 @@ public:
 	virtual void keyboardPressEvent(const KeyBoardKey keyPressed) = 0;
 
 	/**
-	 * \brief This method is called when the BOINC client information should be updated
+	 * \brief This method is called when the BOINC client information should be fetched
+	 *
+	 * This method is called periodically by \ref BOINCUpdateWorker on a separate thread
+	 * (or synchronously when there's no worker, e.g. for headless rendering). It should
+	 * refresh all adapters, prepare the HUD content and publish the results as a snapshot
+	 * (see \ref SnapshotBuffer) to be picked up by \ref refreshBOINCInformation().
 	 *
 	 * When you inherit from this class and implement this method, please make sure you call
 	 * \ref refreshLocalBOINCInformation() to invoke the generic default implementation which
 	 * refreshes \ref m_BoincAdapter.
 	 *
+	 * \attention This method must not issue any OpenGL calls nor touch any data used by
+	 * the render thread other than the snapshot it publishes.
+	 *
 	 * \see refreshLocalBOINCInformation()
+	 * \see refreshBOINCInformation()
+	 */
+	virtual void updateBOINCInformation() = 0;
+
+	/**
+	 * \brief This method is called when the BOINC client information should be updated
+	 *
+	 * This method is called on the render thread. It picks up the latest snapshot
+	 * published by \ref updateBOINCInformation() (if any) and applies it, which
+	 * includes regenerating dependent OpenGL objects. It must not do any file I/O or
+	 * parsing itself.
+	 *
+	 * \see updateBOINCInformation()
 	 */
 	virtual void refreshBOINCInformation() = 0;
 
+	/**
+	 * \brief Replaces the system clock by a fixed (externally driven) clock
+	 *
+	 * Once set, all time-dependent information that isn't passed to \ref render()
+	 * directly (e.g. observatory positions or clocks shown in the HUD) is derived
+	 * from the given time instead of the system clock. This yields deterministic
+	 * output, e.g. for headless rendering.
+	 *
+	 * \param timeOfDay The time in "seconds since the Epoch" to be used from now on
+	 * (a negative value reenables the system clock)
+	 *
+	 * \see currentTime()
+	 */
+	void setFixedTime(const double timeOfDay);
+
+	/**
+	 * \brief Retrieve the engine's frame profiler
+	 *
+	 * The profiler is used by the engine to time its render phases and by the
+	 * caller of \ref render() to mark frame boundaries and time buffer swapping.
+	 *
+	 * \return Reference to the frame profiler instance
+	 */
+	FrameProfiler& profiler();
+
 protected:
 	/**
 	 * \brief Constructor
@@ -189,13 +241,30 @@ protected:
 	 * \brief This method has to be called in order to update the BOINC client information
 	 *
 	 * This is the local/generic implementation which refreshes \ref m_BoincAdapter.
+	 * It's called by \ref updateBOINCInformation(), hence not on the render thread.
 	 *
-	 * \see refreshBOINCInformation()
+	 * \see updateBOINCInformation()
 	 */
 	virtual void refreshLocalBOINCInformation();
 
+	/**
+	 * \brief Retrieve the current time
+	 *
+	 * \return The fixed time (if set) or BOINC's dtime() otherwise
+	 *
+	 * \see setFixedTime()
+	 */
+	double currentTime() const;
+
 	/// BOINC client adapter instance for information retrieval
 	BOINCClientAdapter m_BoincAdapter;
+
+	/// Frame profiler instance for per-phase timing
+	FrameProfiler m_Profiler;
+
+private:
+	/// Fixed time in "seconds since the Epoch" (negative if the system clock is used)
+	double m_FixedTime;
 };
 
 /**
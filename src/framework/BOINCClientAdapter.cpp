@@ -22,12 +22,22 @@
 #include "Libxml2Adapter.h"
 
 #include <sstream>
+#include <cstring>
+#include <cstdio>
 
-BOINCClientAdapter::BOINCClientAdapter(string sharedMemoryIdentifier)
+#include <util.h>
+
+BOINCClientAdapter::BOINCClientAdapter(string sharedMemoryIdentifier) :
+	m_InitDataWatcher(INIT_DATA_FILE)
 {
 	m_Initialized = false;
 	m_SharedMemoryAreaIdentifier = sharedMemoryIdentifier;
+	m_SharedMemoryArea = NULL;
+	m_SharedMemoryAreaSize = 0;
+	m_SharedMemoryAreaRevision = 0;
 	m_SharedMemoryAreaAvailable = false;
+	m_SharedMemoryAreaNextAttach = 0.0;
+	m_SharedMemoryAreaAttachDelay = 1;
 
 	m_xmlIFace = new Libxml2Adapter();
 
@@ -35,6 +45,13 @@ BOINCClientAdapter::BOINCClientAdapter(string sharedMemoryIdentifier)
 	m_GraphicsQualitySetting = BOINCClientAdapter::LowGraphicsQualitySetting;
 	m_GraphicsWindowWidth = 800;
 	m_GraphicsWindowHeight = 600;
+
+	// compile preference queries once (order as defined by PreferenceQuery)
+	m_PreferenceQueries.resize(PreferenceQueryCount);
+	m_PreferenceQueries[PreferenceQueryFrameRate] = m_xmlIFace->compileXPath("/project_preferences/graphics/@fps");
+	m_PreferenceQueries[PreferenceQueryQuality] = m_xmlIFace->compileXPath("/project_preferences/graphics/@quality");
+	m_PreferenceQueries[PreferenceQueryWindowWidth] = m_xmlIFace->compileXPath("/project_preferences/graphics/@width");
+	m_PreferenceQueries[PreferenceQueryWindowHeight] = m_xmlIFace->compileXPath("/project_preferences/graphics/@height");
 }
 
 BOINCClientAdapter::~BOINCClientAdapter()
@@ -45,9 +62,9 @@ BOINCClientAdapter::~BOINCClientAdapter()
 void BOINCClientAdapter::initialize()
 {
 	if(!m_Initialized) {
+		// note: this also reads the project preferences
 		readUserInfo();
 		readSharedMemoryArea();
-		readProjectPreferences();
 
 		m_Initialized = true;
 	}
@@ -67,60 +84,195 @@ void BOINCClientAdapter::refresh()
 	}
 }
 
-void BOINCClientAdapter::readUserInfo()
+bool BOINCClientAdapter::refreshPreferences()
 {
+	if(m_Initialized) {
+		return readUserInfo();
+	}
+	else {
+		cerr << "The BOINC Client Adapter has not yet been initialized! Doing so now..." << endl;
+		initialize();
+		return true;
+	}
+}
+
+bool BOINCClientAdapter::readUserInfo()
+{
+	// the file is rewritten by the client only a few times a day
+	if(!m_InitDataWatcher.hasChanged()) return false;
+
 	boinc_parse_init_data_file();
 	boinc_get_init_data(m_UserData);
+
+	// parse preferences only when they changed
+	if(projectInformation() != m_ProjectPreferences) {
+		readProjectPreferences();
+		return true;
+	}
+
+	return false;
 }
 
 void BOINCClientAdapter::readSharedMemoryArea()
 {
-	// check if we already have a pointer
-	if(m_SharedMemoryAreaAvailable) {
-		// load contents
-		m_SharedMemoryAreaContents = string(m_SharedMemoryArea);
-	}
 	// the shared memory area's not available, try to get a pointer to it
-	else {
-	   m_SharedMemoryArea = (char*) boinc_graphics_get_shmem((char*)m_SharedMemoryAreaIdentifier.c_str());
-
-	    if(m_SharedMemoryArea) {
-	    	// fine, get the contents recursively
-	        m_SharedMemoryAreaAvailable = true;
-	        readSharedMemoryArea();
-	    }
-	    else {
-	    	// bad luck
-	    	m_SharedMemoryAreaContents = "";
-	        m_SharedMemoryAreaAvailable = false;
-	    }
+	if(!m_SharedMemoryAreaAvailable) {
+		const double now = dtime();
+
+		// don't try again too early (the application might not be running at all)
+		if(now < m_SharedMemoryAreaNextAttach) return;
+
+		m_SharedMemoryArea = (char*) boinc_graphics_get_shmem((char*)m_SharedMemoryAreaIdentifier.c_str());
+
+		if(!m_SharedMemoryArea) {
+			// bad luck, back off
+			m_SharedMemoryAreaNextAttach = now + m_SharedMemoryAreaAttachDelay;
+			m_SharedMemoryAreaAttachDelay *= 2;
+			if(m_SharedMemoryAreaAttachDelay > MaxAttachDelay) m_SharedMemoryAreaAttachDelay = MaxAttachDelay;
+			return;
+		}
+
+		// we'll never read more than the largest record
+		m_SharedMemoryAreaSize = sharedMemoryAreaSize(m_SharedMemoryArea, GRAPHICS_INFO_MAX_SIZE);
+
+		// fine, go ahead
+		m_SharedMemoryAreaAvailable = true;
+		m_SharedMemoryAreaAttachDelay = 1;
 	}
+
+	for(int i = 0; i < MaxReadAttempts; ++i) {
+		size_t length = 0;
+
+		// the application might provide a binary record instead of an XML string
+		if(m_SharedMemoryAreaSize >= sizeof(GraphicsInfoHeader) &&
+		   memcmp(m_SharedMemoryArea, GRAPHICS_INFO_MAGIC, GRAPHICS_INFO_MAGIC_SIZE) == 0) {
+			GraphicsInfoHeader header;
+			memcpy(&header, m_SharedMemoryArea, sizeof(header));
+
+			// record is being updated right now
+			if(header.sequence % 2) continue;
+
+			length = sizeof(header) + header.length;
+			if(header.length > GRAPHICS_INFO_MAX_SIZE || length > m_SharedMemoryAreaSize) {
+				cerr << "Invalid binary shared memory data encountered!" << endl;
+				return;
+			}
+		}
+		else {
+			// the terminating NUL has to be part of the area
+			const char *end = (const char*) memchr(m_SharedMemoryArea, '\0', m_SharedMemoryAreaSize);
+			if(!end) continue;
+
+			length = end - m_SharedMemoryArea;
+		}
+
+		// unchanged contents (the common case) don't need to be copied at all
+		if(length == m_SharedMemoryAreaContents.length() &&
+		   memcmp(m_SharedMemoryArea, m_SharedMemoryAreaContents.data(), length) == 0) {
+			return;
+		}
+
+		// copy (reusing the buffer's memory) and make sure the application didn't write meanwhile
+		m_SharedMemoryAreaBuffer.assign(m_SharedMemoryArea, length);
+		if((isBinaryApplicationInformation(m_SharedMemoryAreaBuffer) || m_SharedMemoryArea[length] == '\0') &&
+		   memcmp(m_SharedMemoryArea, m_SharedMemoryAreaBuffer.data(), length) == 0) {
+
+			// consistent copy: hand it over (no copy, just swapping buffers)
+			m_SharedMemoryAreaContents.swap(m_SharedMemoryAreaBuffer);
+			++m_SharedMemoryAreaRevision;
+			return;
+		}
+	}
+
+	// torn reads only, keep the previous contents and try again next time
+	cerr << "Shared memory area changed while being read, keeping previous contents!" << endl;
+}
+
+size_t BOINCClientAdapter::sharedMemoryAreaSize(const char *area, const size_t limit)
+{
+	size_t size = 0;
+
+#ifdef _WIN32
+	MEMORY_BASIC_INFORMATION info;
+	if(VirtualQuery(area, &info, sizeof(info)) == sizeof(info) && info.State == MEM_COMMIT) {
+		size = (const char*) info.BaseAddress + info.RegionSize - area;
+	}
+#elif defined(__APPLE__)
+	vm_address_t address = (vm_address_t) area;
+	vm_size_t regionSize = 0;
+	vm_region_basic_info_data_64_t info;
+	mach_msg_type_number_t count = VM_REGION_BASIC_INFO_COUNT_64;
+	mach_port_t object;
+	if(vm_region_64(mach_task_self(), &address, &regionSize, VM_REGION_BASIC_INFO_64,
+					(vm_region_info_t) &info, &count, &object) == KERN_SUCCESS &&
+	   address <= (vm_address_t) area) {
+		size = address + regionSize - (vm_address_t) area;
+	}
+#else
+	// find the mapping in our address space
+	ifstream maps("/proc/self/maps");
+	string line;
+	while(getline(maps, line)) {
+		unsigned long start = 0, end = 0;
+		if(sscanf(line.c_str(), "%lx-%lx", &start, &end) == 2 &&
+		   start <= (unsigned long) area && (unsigned long) area < end) {
+			size = end - (unsigned long) area;
+			break;
+		}
+	}
+#endif
+
+	// the area was mapped at a page boundary, so there's always at least one page
+	if(size == 0) {
+#ifdef _WIN32
+		SYSTEM_INFO system;
+		GetSystemInfo(&system);
+		size = system.dwPageSize;
+#else
+		size = sysconf(_SC_PAGESIZE);
+#endif
+	}
+
+	return size < limit ? size : limit;
 }
 
 void BOINCClientAdapter::readProjectPreferences()
 {
-	string temp;
+	vector<string> values;
 	istringstream converter;
 	converter.exceptions(ios_base::badbit | ios_base::failbit);
 
+	m_ProjectPreferences = projectInformation();
+
+	// cached feature states refer to the previous preferences
+	m_GraphicsFeatures.clear();
+
+	// reset to defaults (settings might have been removed)
+	m_GraphicsFrameRate = 20;
+	m_GraphicsQualitySetting = BOINCClientAdapter::LowGraphicsQualitySetting;
+	m_GraphicsWindowWidth = 800;
+	m_GraphicsWindowHeight = 600;
+
 	// prepare xml document
-	m_xmlIFace->setXmlDocument(projectInformation(), "http://einstein.phys.uwm.edu");
+	m_xmlIFace->setXmlDocument(m_ProjectPreferences, "http://einstein.phys.uwm.edu");
+
+	// use (pre-compiled) XPath queries to get all attributes at once
+	if(!m_xmlIFace->getNodeContentsByXPath(m_PreferenceQueries, values)) return;
 
-	// use XPath queries to get attributes
 	try {
-		temp = m_xmlIFace->getSingleNodeContentByXPath("/project_preferences/graphics/@fps");
-		if(temp.length() > 0) {
+		const string &frameRate = values[PreferenceQueryFrameRate];
+		if(frameRate.length() > 0) {
 			converter.clear();
-			converter.str(temp);
+			converter.str(frameRate);
 			converter >> dec >> m_GraphicsFrameRate;
 		}
 
-		temp = m_xmlIFace->getSingleNodeContentByXPath("/project_preferences/graphics/@quality");
-		if(temp.length() > 0) {
-			if(temp == "high") {
+		const string &quality = values[PreferenceQueryQuality];
+		if(quality.length() > 0) {
+			if(quality == "high") {
 				m_GraphicsQualitySetting = BOINCClientAdapter::HighGraphicsQualitySetting;
 			}
-			else if(temp == "medium") {
+			else if(quality == "medium") {
 				m_GraphicsQualitySetting = BOINCClientAdapter::MediumGraphicsQualitySetting;
 			}
 			else {
@@ -128,17 +280,17 @@ void BOINCClientAdapter::readProjectPreferences()
 			}
 		}
 
-		temp = m_xmlIFace->getSingleNodeContentByXPath("/project_preferences/graphics/@width");
-		if(temp.length() > 0) {
+		const string &windowWidth = values[PreferenceQueryWindowWidth];
+		if(windowWidth.length() > 0) {
 			converter.clear();
-			converter.str(temp);
+			converter.str(windowWidth);
 			converter >> dec >> m_GraphicsWindowWidth;
 		}
 
-		temp = m_xmlIFace->getSingleNodeContentByXPath("/project_preferences/graphics/@height");
-		if(temp.length() > 0) {
+		const string &windowHeight = values[PreferenceQueryWindowHeight];
+		if(windowHeight.length() > 0) {
 			converter.clear();
-			converter.str(temp);
+			converter.str(windowHeight);
 			converter >> dec >> m_GraphicsWindowHeight;
 		}
 	}
@@ -147,11 +299,22 @@ void BOINCClientAdapter::readProjectPreferences()
 	}
 }
 
-string BOINCClientAdapter::applicationInformation() const
+const string& BOINCClientAdapter::applicationInformation() const
 {
 	return m_SharedMemoryAreaContents;
 }
 
+bool BOINCClientAdapter::isBinaryApplicationInformation(const string &information)
+{
+	return information.length() >= sizeof(GraphicsInfoHeader) &&
+		   information.compare(0, GRAPHICS_INFO_MAGIC_SIZE, GRAPHICS_INFO_MAGIC) == 0;
+}
+
+unsigned long BOINCClientAdapter::applicationInformationRevision() const
+{
+	return m_SharedMemoryAreaRevision;
+}
+
 string BOINCClientAdapter::projectInformation() const
 {
 	string temp("<project_preferences />\n");
@@ -184,6 +347,30 @@ int BOINCClientAdapter::graphicsWindowHeight() const
 	return m_GraphicsWindowHeight;
 }
 
+bool BOINCClientAdapter::graphicsFeature(const string &engine, const string &feature, const bool defaultState)
+{
+	// features are only looked up once per preference change
+	const string key = engine + "/" + feature;
+	map<string, bool>::const_iterator cached = m_GraphicsFeatures.find(key);
+	if(cached != m_GraphicsFeatures.end()) return cached->second;
+
+	// the document of the last readProjectPreferences() call is still loaded (missing features are fine)
+	vector<int> query(1, m_xmlIFace->compileXPath(
+							"/project_preferences/graphics/engine[@name='" + engine +
+							"']/feature[@id='" + feature + "']/@enabled"));
+	vector<string> values;
+	m_xmlIFace->getNodeContentsByXPath(query, values);
+	const string &state = values[0];
+
+	bool result = defaultState;
+	if(state == "true") result = true;
+	else if(state == "false") result = false;
+
+	m_GraphicsFeatures[key] = result;
+
+	return result;
+}
+
 string BOINCClientAdapter::coreVersion() const
 {
 	stringstream buffer;
@@ -24,11 +24,25 @@
 #include <iostream>
 #include <string>
 #include <sstream>
+#include <map>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <unistd.h>
+#endif
 
 #include "boinc_api.h"
 #include "graphics2.h"
 
 #include "XMLProcessorInterface.h"
+#include "FileWatcher.h"
+#include "GraphicsInfo.h"
 
 using namespace std;
 
@@ -88,11 +102,29 @@ public:
 	 * You want to call this method periodically to refresh any volatile client information.
 	 * Please make sure that you call initialize() first!
 	 *
+	 * Note: \c init_data.xml is only parsed again if it changed on disk. The project
+	 * preferences contained therein are only parsed again if they changed as well.
+	 *
 	 * \see AbstractGraphicsEngine::refreshBOINCInformation
 	 * \see initialize
 	 */
 	void refresh();
 
+	/**
+	 * \brief Refreshes the project preferences only
+	 *
+	 * Use this method instead of refresh() if you're only interested in the project
+	 * preferences (e.g. the graphics settings). It's cheap to call periodically as
+	 * \c init_data.xml is only parsed again if it changed on disk.
+	 * Please make sure that you call initialize() first!
+	 *
+	 * \return TRUE if the project preferences changed, otherwise FALSE
+	 *
+	 * \see BOINCUpdateWorker
+	 * \see initialize
+	 */
+	bool refreshPreferences();
+
 	/**
 	 * \brief Retrieves the BOINC core client version of the currently active client
 	 *
@@ -215,11 +247,39 @@ public:
     /**
      * \brief Retrieves information provided by the running science application
      *
-     * \return The application specific information string (i.e. XML) found in APP_INIT_DATA
+     * The returned reference stays valid (and its contents consistent) until the next
+     * call of refresh(), so there's no need to copy it just for parsing.
      *
-     * \see m_UserData
+     * \return The application specific information (i.e. XML or a binary record) found in the shared memory area
+     *
+     * \see applicationInformationRevision()
+     * \see isBinaryApplicationInformation()
+     */
+    const string& applicationInformation() const;
+
+    /**
+     * \brief Checks whether the given application information is a binary record
+     *
+     * \param information The application information as returned by applicationInformation()
+     *
+     * \return TRUE if it's a binary record (see \ref GraphicsInfoHeader), FALSE if it's legacy XML
+     *
+     * \see GraphicsInfoWriter
      */
-    string applicationInformation() const;
+    static bool isBinaryApplicationInformation(const string &information);
+
+    /**
+     * \brief Retrieves the revision of the information provided by the running science application
+     *
+     * The revision is incremented whenever refresh() finds new contents in the shared
+     * memory area. Compare it with the revision seen last time to skip parsing unchanged
+     * information.
+     *
+     * \return The revision of the application specific information (0 if none is available yet)
+     *
+     * \see applicationInformation()
+     */
+    unsigned long applicationInformationRevision() const;
 
     /**
      * \brief Retrieves specific information provided by the currently active project
@@ -312,16 +372,36 @@ public:
      */
     int graphicsWindowHeight() const;
 
+    /**
+     * \brief Retrieves the state of a graphics engine specific feature
+     *
+     * Engine specific settings are stored as recommended in the description of
+     * \ref projectInformation(), i.e. as \c feature tags with \c id and \c enabled
+     * attributes that are children of the respective \c engine tag.
+     *
+     * \param engine The name of the graphics engine (e.g. \c starsphere)
+     * \param feature The ID of the feature
+     * \param defaultState The state to be returned if the feature isn't configured
+     *
+     * \return TRUE if the feature is enabled, FALSE if it's disabled
+     *
+     * \see projectInformation
+     * \see m_GraphicsFeatures
+     */
+    bool graphicsFeature(const string &engine, const string &feature, const bool defaultState);
+
 private:
     /**
      * \brief Fetch the contents of \c init_data.xml
      *
      * This method uses the BOINC API in order to fill the \c APP_INIT_DATA structure m_UserData
-     * with initial information about the current work unit computation session (slot). The data
-     * in \c init_data.xml is refreshed only at the beginning of a session, hence this method doesn't
-     * need to be called periodically.
+     * with information about the user and the current work unit computation session (slot).
+     * The file is only parsed when \ref m_InitDataWatcher reports a change. If the project
+     * preferences changed as well, they're parsed again too.
+     *
+     * \return TRUE if the project preferences changed, otherwise FALSE
      */
-	void readUserInfo();
+	bool readUserInfo();
 
 	/**
 	 * \brief Fetch the contents of the shared memory area provided by the \b Einstein\@Home application
@@ -330,10 +410,33 @@ private:
 	 * and work unit computation. The contents have to be considered as volatile, hence should be refreshed
 	 * periodically.
 	 *
+	 * The contents are only copied if they changed. As the application might write to the area
+	 * at any time, the copy is verified against the area afterwards and only accepted if both
+	 * still match (otherwise the previous contents are retained). Binary records (see
+	 * \ref GraphicsInfoHeader) are detected and also discarded while being written. All reads are bounded
+	 * by the size of the area (see \ref sharedMemoryAreaSize()). Failed attempts to attach
+	 * to the area are retried with exponential backoff.
+	 *
 	 * \see refresh()
+	 * \see applicationInformationRevision()
 	 */
 	void readSharedMemoryArea();
 
+	/**
+	 * \brief Determines the accessible size of the attached shared memory area
+	 *
+	 * BOINC doesn't tell the size of the area it attached to, so it's determined by
+	 * querying the memory region (mapping) containing it. This bounds all reads, even
+	 * if the area contains a corrupt or half-written record. Should the query fail,
+	 * only the first page is considered accessible.
+	 *
+	 * \param area Pointer to the shared memory area (as returned by \c boinc_graphics_get_shmem)
+	 * \param limit The maximum size of interest
+	 *
+	 * \return The accessible size (at most \c limit)
+	 */
+	static size_t sharedMemoryAreaSize(const char *area, const size_t limit);
+
 	/**
 	 * \brief Parse the project-specific preferences (XML)
 	 *
@@ -357,12 +460,33 @@ private:
 	/// Pointer to the shared memory area
 	char *m_SharedMemoryArea;
 
-	/// The contents of the shared memory area after the last refresh
+	/// Accessible size of the shared memory area
+	size_t m_SharedMemoryAreaSize;
+
+	/// The (consistent) contents of the shared memory area after the last refresh
 	string m_SharedMemoryAreaContents;
 
+	/// Scratch buffer for copies of the shared memory area yet to be verified
+	string m_SharedMemoryAreaBuffer;
+
+	/// Revision of the shared memory area contents (incremented on every change)
+	unsigned long m_SharedMemoryAreaRevision;
+
 	/// Flag to indicate whether the shared memory area is available or not
 	bool m_SharedMemoryAreaAvailable;
 
+	/// Time (see dtime()) of the next attempt to attach to the shared memory area
+	double m_SharedMemoryAreaNextAttach;
+
+	/// Current delay (in seconds) between attempts to attach to the shared memory area
+	int m_SharedMemoryAreaAttachDelay;
+
+	/// Maximum delay (in seconds) between attempts to attach to the shared memory area
+	static const int MaxAttachDelay = 32;
+
+	/// Number of attempts to get a consistent copy of the shared memory area per refresh
+	static const int MaxReadAttempts = 3;
+
 	/// Frame rate at which the project's graphics application should be rendered
 	int m_GraphicsFrameRate;
 
@@ -375,6 +499,12 @@ private:
 	/// Initial window height when running in windowed mode
 	int m_GraphicsWindowHeight;
 
+	/// The project preferences (XML) parsed by the last call of readProjectPreferences()
+	string m_ProjectPreferences;
+
+	/// Change detection for \c init_data.xml
+	FileWatcher m_InitDataWatcher;
+
 	/**
 	 * \brief Information structure returned by the BOINC client API.
 	 *
@@ -385,6 +515,21 @@ private:
 
 	/// Pointer to the XML processor
 	XMLProcessorInterface* m_xmlIFace;
+
+	/// Indices of the project preference queries
+	enum PreferenceQuery {
+		PreferenceQueryFrameRate,
+		PreferenceQueryQuality,
+		PreferenceQueryWindowWidth,
+		PreferenceQueryWindowHeight,
+		PreferenceQueryCount
+	};
+
+	/// Handles of the compiled XPath queries used by readProjectPreferences() (index: PreferenceQuery)
+	vector<int> m_PreferenceQueries;
+
+	/// Engine feature states queried since the project preferences were parsed last time (key: engine/feature)
+	map<string, bool> m_GraphicsFeatures;
 };
 
 /**
@@ -0,0 +1,94 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "BOINCUpdateWorker.h"
+
+BOINCUpdateWorker::BOINCUpdateWorker(AbstractGraphicsEngine *engine, BOINCClientAdapter *preferences, const int interval)
+{
+	m_Engine = engine;
+	m_Preferences = preferences;
+	m_Interval = interval;
+	m_Thread = NULL;
+	m_Running = false;
+}
+
+BOINCUpdateWorker::~BOINCUpdateWorker()
+{
+	stop();
+}
+
+bool BOINCUpdateWorker::start()
+{
+	if(m_Thread) return true;
+
+	m_Running = true;
+	m_Thread = SDL_CreateThread(&run, this);
+
+	if(!m_Thread) {
+		cerr << "BOINC update thread could not be created: " << SDL_GetError() << endl;
+		m_Running = false;
+		return false;
+	}
+
+	return true;
+}
+
+void BOINCUpdateWorker::stop()
+{
+	if(!m_Thread) return;
+
+	m_Running = false;
+	SDL_WaitThread(m_Thread, NULL);
+	m_Thread = NULL;
+}
+
+int BOINCUpdateWorker::run(void *data)
+{
+	BOINCUpdateWorker *worker = static_cast<BOINCUpdateWorker*>(data);
+
+	while(worker->m_Running) {
+		worker->m_Engine->updateBOINCInformation();
+
+		// cheap unless init_data.xml changed
+		if(worker->m_Preferences && worker->m_Preferences->refreshPreferences()) {
+			PreferencesSnapshot &snapshot = worker->m_PreferencesSnapshots.writeBuffer();
+			snapshot.frameRate = worker->m_Preferences->graphicsFrameRate();
+			snapshot.qualitySetting = worker->m_Preferences->graphicsQualitySetting();
+			worker->m_PreferencesSnapshots.publish();
+		}
+
+		// wait in small steps to keep stop() responsive
+		for(int waited = 0; waited < worker->m_Interval && worker->m_Running; waited += WaitStep) {
+			SDL_Delay(WaitStep);
+		}
+	}
+
+	return 0;
+}
+
+bool BOINCUpdateWorker::acquirePreferences()
+{
+	return m_PreferencesSnapshots.acquire();
+}
+
+const BOINCUpdateWorker::PreferencesSnapshot& BOINCUpdateWorker::preferences() const
+{
+	return m_PreferencesSnapshots.readBuffer();
+}
@@ -0,0 +1,143 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef BOINCUPDATEWORKER_H_
+#define BOINCUPDATEWORKER_H_
+
+#include <iostream>
+
+#include <SDL.h>
+#include <SDL_thread.h>
+
+#include "AbstractGraphicsEngine.h"
+#include "BOINCClientAdapter.h"
+#include "SnapshotBuffer.h"
+
+using namespace std;
+
+/**
+ * \addtogroup framework Framework
+ * @{
+ */
+
+/**
+ * \brief Background thread fetching BOINC information for a graphics engine
+ *
+ * %BOINCUpdateWorker periodically calls \ref AbstractGraphicsEngine::updateBOINCInformation()
+ * on a separate thread. This way reading the init data file, copying the shared
+ * memory area, parsing and string formatting never take place while a frame is
+ * rendered. The engine publishes its results as a snapshot which is picked up by
+ * \ref AbstractGraphicsEngine::refreshBOINCInformation() on the render thread.
+ *
+ * Optionally the worker also refreshes the project preferences of a second adapter
+ * (the window manager's) and publishes them as a \ref PreferencesSnapshot. This way
+ * BOINC's process-global init data is only ever parsed on this thread.
+ *
+ * \author Oliver Bock\n
+ * Max-Planck-Institute for Gravitational Physics\n
+ * Hannover, Germany
+ */
+class BOINCUpdateWorker
+{
+public:
+	/**
+	 * \brief Constructor
+	 *
+	 * \param engine The graphics engine to be updated
+	 * \param preferences The adapter whose project preferences should be watched (optional)
+	 * \param interval The update interval in milliseconds
+	 */
+	BOINCUpdateWorker(AbstractGraphicsEngine *engine, BOINCClientAdapter *preferences = NULL, const int interval = 1000);
+
+	/// Destructor (stops the worker thread)
+	virtual ~BOINCUpdateWorker();
+
+	/**
+	 * \brief Starts the worker thread
+	 *
+	 * \return TRUE if successful, otherwise FALSE
+	 */
+	bool start();
+
+	/**
+	 * \brief Stops the worker thread and waits for it to finish
+	 */
+	void stop();
+
+	/// Project preferences relevant for the window manager
+	struct PreferencesSnapshot {
+		/// The preferred frame rate
+		int frameRate;
+
+		/// The preferred quality setting
+		BOINCClientAdapter::GraphicsQualitySetting qualitySetting;
+	};
+
+	/**
+	 * \brief Picks up changed project preferences, if any (consumer thread only)
+	 *
+	 * \return TRUE if changed preferences are available via \ref preferences(), otherwise FALSE
+	 */
+	bool acquirePreferences();
+
+	/**
+	 * \brief Retrieve the preferences picked up by the last \ref acquirePreferences()
+	 *
+	 * \return Const reference to the preferences snapshot
+	 */
+	const PreferencesSnapshot& preferences() const;
+
+private:
+	/**
+	 * \brief The worker thread's main function
+	 *
+	 * \param data Pointer to the %BOINCUpdateWorker instance
+	 *
+	 * \return Always zero
+	 */
+	static int run(void *data);
+
+	/// Granularity of the interval wait in milliseconds (determines the stop latency)
+	static const int WaitStep = 50;
+
+	/// The graphics engine to be updated
+	AbstractGraphicsEngine *m_Engine;
+
+	/// The adapter whose project preferences are watched (NULL if none)
+	BOINCClientAdapter *m_Preferences;
+
+	/// Hand-over of changed project preferences
+	SnapshotBuffer<PreferencesSnapshot> m_PreferencesSnapshots;
+
+	/// The update interval in milliseconds
+	int m_Interval;
+
+	/// The worker thread handle
+	SDL_Thread *m_Thread;
+
+	/// Run indicator (cleared to stop the worker thread)
+	volatile bool m_Running;
+};
+
+/**
+ * @}
+ */
+
+#endif /*BOINCUPDATEWORKER_H_*/
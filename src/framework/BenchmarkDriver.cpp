@@ -0,0 +1,139 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "BenchmarkDriver.h"
+
+/// Keys toggling all features (each one is pressed twice per script cycle)
+static const AbstractGraphicsEngine::KeyBoardKey c_FeatureKeys[] = {
+	AbstractGraphicsEngine::KeyS,
+	AbstractGraphicsEngine::KeyC,
+	AbstractGraphicsEngine::KeyO,
+	AbstractGraphicsEngine::KeyX,
+	AbstractGraphicsEngine::KeyP,
+	AbstractGraphicsEngine::KeyR,
+	AbstractGraphicsEngine::KeyG,
+	AbstractGraphicsEngine::KeyA,
+	AbstractGraphicsEngine::KeyI,
+	AbstractGraphicsEngine::KeyL,
+	AbstractGraphicsEngine::KeyM,
+	AbstractGraphicsEngine::KeyW
+};
+
+/// Number of feature keys
+static const int c_FeatureKeyCount = sizeof(c_FeatureKeys) / sizeof(c_FeatureKeys[0]);
+
+/// Frames between two feature toggles
+static const int c_FeatureTogglePeriod = 40;
+
+/// Frames per camera zoom cycle (zoom in, pause, zoom out, pause)
+static const int c_ZoomPeriod = 400;
+
+BenchmarkDriver::BenchmarkDriver(const double duration, const double frameRate)
+{
+	m_FrameRate = frameRate > 0.0 ? frameRate : 20.0;
+	m_FrameCount = duration > 0.0 ? (int)(duration * m_FrameRate) : 0;
+	m_CurrentFrame = 0;
+	m_WallStartTime = 0.0;
+	m_CPUStartTime = 0;
+
+	m_FrameTimes.reserve(m_FrameCount);
+}
+
+BenchmarkDriver::~BenchmarkDriver()
+{
+}
+
+double BenchmarkDriver::prepareFrame(AbstractGraphicsEngine *engine)
+{
+	const int frame = m_CurrentFrame;
+
+	if(frame == 0) {
+		m_WallStartTime = FrameProfiler::timestamp();
+		m_CPUStartTime = clock();
+	}
+
+	// camera path: steady rotation with alternating elevation...
+	const int elevation = (frame / 50) % 2 ? 1 : -1;
+	engine->mouseMoveEvent(2, elevation, AbstractGraphicsEngine::MouseButtonLeft);
+
+	// ...and periodic zoom in/out
+	const int zoomPhase = frame % c_ZoomPeriod;
+	if(zoomPhase < c_ZoomPeriod / 4) {
+		engine->mouseMoveEvent(0, 1, AbstractGraphicsEngine::MouseButtonRight);
+	}
+	else if(zoomPhase >= c_ZoomPeriod / 2 && zoomPhase < 3 * c_ZoomPeriod / 4) {
+		engine->mouseMoveEvent(0, -1, AbstractGraphicsEngine::MouseButtonRight);
+	}
+
+	// toggle features in turn (first pass: off/on, second pass: restore)
+	if(frame > 0 && frame % c_FeatureTogglePeriod == 0) {
+		engine->keyboardPressEvent(c_FeatureKeys[(frame / c_FeatureTogglePeriod) % c_FeatureKeyCount]);
+	}
+
+	const double timeOfDay = frame / m_FrameRate;
+	engine->setFixedTime(timeOfDay);
+
+	return timeOfDay;
+}
+
+void BenchmarkDriver::completeFrame(const double frameTime)
+{
+	m_FrameTimes.push_back(frameTime);
+	m_CurrentFrame++;
+}
+
+bool BenchmarkDriver::isFinished() const
+{
+	return m_CurrentFrame >= m_FrameCount;
+}
+
+void BenchmarkDriver::report() const
+{
+	if(m_FrameTimes.empty()) {
+		cout << "Benchmark: no frames rendered!" << endl;
+		return;
+	}
+
+	const double wallTime = FrameProfiler::timestamp() - m_WallStartTime;
+	const double cpuTime = (double)(clock() - m_CPUStartTime) / CLOCKS_PER_SEC;
+	const size_t frames = m_FrameTimes.size();
+
+	vector<float> sortedTimes(m_FrameTimes);
+	sort(sortedTimes.begin(), sortedTimes.end());
+
+	// don't change the formatting of subsequent output
+	const ios_base::fmtflags flags = cout.flags();
+	const streamsize precision = cout.precision();
+
+	cout << "Benchmark results:" << endl;
+	cout << fixed << setprecision(3);
+	cout << "Frames rendered: " << frames << endl;
+	cout << "Wall clock time (s): " << wallTime << endl;
+	cout << "Frames per second: " << frames / wallTime << endl;
+	cout << "Frame time (ms): p50 " << 1000.0 * FrameProfiler::percentile(sortedTimes, 50)
+		 << ", p95 " << 1000.0 * FrameProfiler::percentile(sortedTimes, 95)
+		 << ", p99 " << 1000.0 * FrameProfiler::percentile(sortedTimes, 99)
+		 << ", max " << 1000.0 * sortedTimes.back() << endl;
+	cout << "Process CPU time (s): " << cpuTime
+		 << " (" << 1000.0 * cpuTime / frames << " ms/frame)" << endl;
+
+	cout.flags(flags);
+	cout.precision(precision);
+}
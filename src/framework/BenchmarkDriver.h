@@ -0,0 +1,127 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef BENCHMARKDRIVER_H_
+#define BENCHMARKDRIVER_H_
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <ctime>
+
+#include "AbstractGraphicsEngine.h"
+#include "FrameProfiler.h"
+
+using namespace std;
+
+/**
+ * \addtogroup framework Framework
+ * @{
+ */
+
+/**
+ * \brief Scripted, reproducible workload for graphics engine benchmarks
+ *
+ * %BenchmarkDriver replaces the system clock and the user by a synthetic clock
+ * and a fixed script: frame \c n is rendered for the time <tt>n / frameRate</tt>
+ * (no matter how long rendering actually takes), the camera follows a fixed path
+ * (using the engine's mouse event handler) and all features are toggled off and
+ * on again in turn (using the engine's keyboard event handler). Hence every run
+ * performs exactly the same work which makes results comparable across drivers
+ * and build configurations.
+ *
+ * The actual frame times (render plus buffer swap) are collected and reported
+ * as frames per second, percentiles and process CPU time.
+ *
+ * \author Oliver Bock\n
+ * Max-Planck-Institute for Gravitational Physics\n
+ * Hannover, Germany
+ */
+class BenchmarkDriver
+{
+public:
+	/**
+	 * \brief Constructor
+	 *
+	 * \param duration The length of the scripted animation in (synthetic) seconds
+	 * \param frameRate The synthetic frame rate (determines the number of frames)
+	 */
+	BenchmarkDriver(const double duration = 60.0, const double frameRate = 20.0);
+
+	/// Destructor
+	virtual ~BenchmarkDriver();
+
+	/**
+	 * \brief Prepares the given engine for the next frame
+	 *
+	 * Applies the scripted camera movement and feature changes for the next
+	 * frame and sets the engine's fixed clock accordingly.
+	 *
+	 * \param engine The graphics engine to be driven
+	 *
+	 * \return The synthetic time of the next frame (to be passed to \ref AbstractGraphicsEngine::render())
+	 */
+	double prepareFrame(AbstractGraphicsEngine *engine);
+
+	/**
+	 * \brief Records the measured duration of the frame just rendered
+	 *
+	 * \param frameTime The frame duration in seconds
+	 */
+	void completeFrame(const double frameTime);
+
+	/**
+	 * \brief Query the benchmark state
+	 *
+	 * \return TRUE if all scripted frames have been rendered, otherwise FALSE
+	 */
+	bool isFinished() const;
+
+	/**
+	 * \brief Prints the benchmark results to stdout
+	 */
+	void report() const;
+
+private:
+	/// Total number of frames to render
+	int m_FrameCount;
+
+	/// Index of the next frame
+	int m_CurrentFrame;
+
+	/// The synthetic frame rate
+	double m_FrameRate;
+
+	/// Measured frame times (seconds)
+	vector<float> m_FrameTimes;
+
+	/// Wall clock time of the first frame
+	double m_WallStartTime;
+
+	/// Process CPU time of the first frame
+	clock_t m_CPUStartTime;
+};
+
+/**
+ * @}
+ */
+
+#endif /*BENCHMARKDRIVER_H_*/
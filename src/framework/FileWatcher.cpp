@@ -0,0 +1,146 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "FileWatcher.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/inotify.h>
+#endif
+
+FileWatcher::FileWatcher(const string filename)
+{
+	m_Filename = filename;
+	m_FirstQuery = true;
+	m_NotifyDescriptor = -1;
+	m_WatchDescriptor = -1;
+	m_LastModification = 0;
+	m_LastSize = -1;
+
+	// split off directory (inotify watches the parent directory)
+	const size_t separator = m_Filename.find_last_of("/\\");
+	m_BaseName = separator == string::npos ? m_Filename : m_Filename.substr(separator + 1);
+
+	if(!initializeNotification()) {
+		cerr << "File change notification unavailable, polling \"" << m_Filename << "\" instead" << endl;
+	}
+}
+
+FileWatcher::~FileWatcher()
+{
+#ifdef __linux__
+	if(m_NotifyDescriptor >= 0) close(m_NotifyDescriptor);
+#endif
+}
+
+bool FileWatcher::hasChanged()
+{
+	// always report the initial state as changed
+	if(m_FirstQuery) {
+		m_FirstQuery = false;
+		pollStatus();
+		if(m_WatchDescriptor >= 0) readNotifications();
+		return true;
+	}
+
+	if(m_WatchDescriptor >= 0) {
+		return readNotifications();
+	}
+	else {
+		return pollStatus();
+	}
+}
+
+bool FileWatcher::initializeNotification()
+{
+#ifdef __linux__
+	m_NotifyDescriptor = inotify_init();
+	if(m_NotifyDescriptor < 0) return false;
+
+	// we must never block the caller
+	fcntl(m_NotifyDescriptor, F_SETFL, fcntl(m_NotifyDescriptor, F_GETFL) | O_NONBLOCK);
+
+	const size_t separator = m_Filename.find_last_of('/');
+	const string directory = separator == string::npos ? "." : m_Filename.substr(0, separator + 1);
+
+	m_WatchDescriptor = inotify_add_watch(m_NotifyDescriptor, directory.c_str(),
+										  IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE);
+	if(m_WatchDescriptor < 0) {
+		close(m_NotifyDescriptor);
+		m_NotifyDescriptor = -1;
+		return false;
+	}
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool FileWatcher::readNotifications()
+{
+	bool changed = false;
+
+#ifdef __linux__
+	// buffer aligned for struct inotify_event
+	union {
+		struct inotify_event event;
+		char data[4096];
+	} buffer;
+
+	ssize_t length;
+	while((length = read(m_NotifyDescriptor, buffer.data, sizeof(buffer))) > 0) {
+		ssize_t offset = 0;
+		while(offset < length) {
+			const struct inotify_event *event = (const struct inotify_event*) (buffer.data + offset);
+			if(event->len > 0 && m_BaseName == event->name) {
+				changed = true;
+			}
+			else if(event->mask & IN_Q_OVERFLOW) {
+				// events got lost, better be safe
+				changed = true;
+			}
+			offset += sizeof(struct inotify_event) + event->len;
+		}
+	}
+#endif
+
+	return changed;
+}
+
+bool FileWatcher::pollStatus()
+{
+	struct stat status;
+	time_t modification = 0;
+	off_t size = -1;
+
+	if(stat(m_Filename.c_str(), &status) == 0) {
+		modification = status.st_mtime;
+		size = status.st_size;
+	}
+
+	const bool changed = modification != m_LastModification || size != m_LastSize;
+
+	m_LastModification = modification;
+	m_LastSize = size;
+
+	return changed;
+}
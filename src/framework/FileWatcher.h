@@ -0,0 +1,121 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef FILEWATCHER_H_
+#define FILEWATCHER_H_
+
+#include <iostream>
+#include <string>
+#include <ctime>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+/**
+ * \addtogroup framework Framework
+ * @{
+ */
+
+/**
+ * \brief Cheap change detection for a single file
+ *
+ * %FileWatcher tells whether a file changed since the last query, so that its
+ * contents only need to be parsed again when it actually did. On Linux the kernel
+ * notifies us via inotify (the parent directory is watched as files tend to be
+ * replaced rather than rewritten). Everywhere else, or if inotify isn't available,
+ * the file's modification time and size are compared instead.
+ *
+ * \author Oliver Bock\n
+ * Max-Planck-Institute for Gravitational Physics\n
+ * Hannover, Germany
+ */
+class FileWatcher
+{
+public:
+	/**
+	 * \brief Constructor
+	 *
+	 * \param filename The name (path) of the file to be watched
+	 */
+	FileWatcher(const string filename);
+
+	/// Destructor
+	virtual ~FileWatcher();
+
+	/**
+	 * \brief Query whether the file changed since the last call
+	 *
+	 * The first call always returns TRUE.
+	 *
+	 * \return TRUE if the file changed (or might have changed), otherwise FALSE
+	 */
+	bool hasChanged();
+
+private:
+	/**
+	 * \brief Sets up the inotify watch (Linux only)
+	 *
+	 * \return TRUE if successful, otherwise FALSE (polling is used instead)
+	 */
+	bool initializeNotification();
+
+	/**
+	 * \brief Drains all pending inotify events (Linux only)
+	 *
+	 * \return TRUE if one of them refers to the watched file, otherwise FALSE
+	 */
+	bool readNotifications();
+
+	/**
+	 * \brief Compares the file's modification time and size with the previous ones
+	 *
+	 * \return TRUE if either of them changed, otherwise FALSE
+	 */
+	bool pollStatus();
+
+	/// The name (path) of the watched file
+	string m_Filename;
+
+	/// The name of the watched file without directory
+	string m_BaseName;
+
+	/// Indicator whether there has been a query yet
+	bool m_FirstQuery;
+
+	/// The inotify instance (negative if unavailable)
+	int m_NotifyDescriptor;
+
+	/// The inotify watch of the parent directory (negative if unavailable)
+	int m_WatchDescriptor;
+
+	/// The file's modification time at the previous query
+	time_t m_LastModification;
+
+	/// The file's size at the previous query (negative if it didn't exist)
+	off_t m_LastSize;
+};
+
+/**
+ * @}
+ */
+
+#endif /*FILEWATCHER_H_*/
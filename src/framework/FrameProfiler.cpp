@@ -0,0 +1,190 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "FrameProfiler.h"
+
+volatile sig_atomic_t FrameProfiler::m_DumpRequested = 0;
+
+static const char *c_PhaseNames[FrameProfiler::PhaseCount] = {
+	"clear",
+	"layers",
+	"observatories",
+	"searchmarker",
+	"hud",
+	"powerspectrum",
+	"swap",
+	"frame"
+};
+
+FrameProfiler::FrameProfiler()
+{
+	m_Enabled = false;
+	m_WriteCount = 0;
+
+	for(int i = 0; i < PhaseCount; ++i) {
+		m_CurrentFrame.phases[i] = 0.0;
+		m_PhaseStart[i] = 0.0;
+	}
+}
+
+FrameProfiler::~FrameProfiler()
+{
+}
+
+void FrameProfiler::enable(const string filename)
+{
+	// allocate ring buffer only when actually needed
+	if(m_RingBuffer.empty()) {
+		m_RingBuffer.resize(RingBufferSize);
+	}
+
+	m_Filename = filename;
+	m_Enabled = true;
+}
+
+void FrameProfiler::beginFrame()
+{
+	if(!m_Enabled) return;
+
+	for(int i = 0; i < PhaseCount; ++i) {
+		m_CurrentFrame.phases[i] = 0.0;
+	}
+
+	startPhase(PhaseFrame);
+}
+
+void FrameProfiler::endFrame()
+{
+	if(!m_Enabled) return;
+
+	stopPhase(PhaseFrame);
+
+	// store sample before publishing it (single producer)
+	m_RingBuffer[m_WriteCount & (RingBufferSize - 1)] = m_CurrentFrame;
+	__sync_synchronize();
+	m_WriteCount = m_WriteCount + 1;
+}
+
+bool FrameProfiler::dump() const
+{
+	if(!m_Enabled) return false;
+
+	// skip the slot that's going to be written next (might be in use)
+	const unsigned int writeCount = m_WriteCount;
+	__sync_synchronize();
+	const unsigned int sampleCount = min(writeCount, RingBufferSize - 1);
+
+	ofstream file(m_Filename.c_str(), ios::out | ios::trunc);
+	if(!file) {
+		cerr << "Frame profile could not be written: " << m_Filename << endl;
+		return false;
+	}
+
+	file << "phase,samples,mean_ms,p50_ms,p95_ms,p99_ms,max_ms" << endl;
+	file << fixed << setprecision(4);
+
+	vector<float> values(sampleCount);
+	for(int phase = 0; phase < PhaseCount; ++phase) {
+		double sum = 0.0;
+		for(unsigned int i = 0; i < sampleCount; ++i) {
+			values[i] = m_RingBuffer[(writeCount - 1 - i) & (RingBufferSize - 1)].phases[phase];
+			sum += values[i];
+		}
+
+		file << c_PhaseNames[phase] << "," << sampleCount;
+
+		if(sampleCount > 0) {
+			sort(values.begin(), values.end());
+
+			file << "," << 1000.0 * sum / sampleCount
+				 << "," << 1000.0 * percentile(values, 50)
+				 << "," << 1000.0 * percentile(values, 95)
+				 << "," << 1000.0 * percentile(values, 99)
+				 << "," << 1000.0 * values[sampleCount - 1];
+		}
+		else {
+			file << ",0,0,0,0,0";
+		}
+
+		file << endl;
+	}
+
+	cerr << "Frame profile (" << sampleCount << " frames) written to: " << m_Filename << endl;
+
+	return file.good();
+}
+
+void FrameProfiler::installSignalHandler()
+{
+#ifndef _WIN32
+	signal(SIGUSR1, &signalHandler);
+#endif
+}
+
+bool FrameProfiler::isDumpRequested()
+{
+	if(m_DumpRequested) {
+		m_DumpRequested = 0;
+		return true;
+	}
+
+	return false;
+}
+
+void FrameProfiler::signalHandler(int)
+{
+	// only set the indicator, the dump happens in the render loop
+	m_DumpRequested = 1;
+}
+
+float FrameProfiler::percentile(const vector<float> &sortedValues, const unsigned int percentage)
+{
+	if(sortedValues.empty()) return 0.0;
+
+	// nearest-rank method
+	size_t rank = (sortedValues.size() * percentage + 99) / 100;
+	if(rank < 1) rank = 1;
+	if(rank > sortedValues.size()) rank = sortedValues.size();
+
+	return sortedValues[rank - 1];
+}
+
+double FrameProfiler::timestamp()
+{
+#ifdef _WIN32
+	static LARGE_INTEGER frequency = {{0, 0}};
+	if(frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+
+	return (double) counter.QuadPart / frequency.QuadPart;
+#elif defined(__APPLE__)
+	static mach_timebase_info_data_t timebase = {0, 0};
+	if(timebase.denom == 0) mach_timebase_info(&timebase);
+
+	return 1e-9 * mach_absolute_time() * timebase.numer / timebase.denom;
+#else
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return now.tv_sec + 1e-9 * now.tv_nsec;
+#endif
+}
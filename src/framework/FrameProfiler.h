@@ -0,0 +1,228 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef FRAMEPROFILER_H_
+#define FRAMEPROFILER_H_
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <csignal>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <mach/mach_time.h>
+#else
+#include <time.h>
+#endif
+
+using namespace std;
+
+/**
+ * \addtogroup framework Framework
+ * @{
+ */
+
+/**
+ * \brief Per-phase frame timing instrumentation
+ *
+ * %FrameProfiler measures the time spent in the individual phases of a frame
+ * using a high-resolution monotonic timer. The timings of each completed frame
+ * are stored as one sample in a fixed-size lock-free ring buffer (single producer:
+ * the render loop). \ref dump() aggregates the most recent samples into percentiles
+ * (p50/p95/p99) per phase and writes them as CSV.
+ *
+ * Phases may be nested (e.g. the power spectrum is part of the HUD), the
+ * reported times are always inclusive. Phases that occur more than once per
+ * frame are accumulated.
+ *
+ * The profiler is inactive (and therefore almost free) until \ref enable()
+ * has been called.
+ *
+ * \author Oliver Bock\n
+ * Max-Planck-Institute for Gravitational Physics\n
+ * Hannover, Germany
+ */
+class FrameProfiler
+{
+public:
+	/// Instrumented frame phases
+	enum Phase {
+		PhaseClear = 0,
+		PhaseLayers,
+		PhaseObservatories,
+		PhaseSearchMarker,
+		PhaseHUD,
+		PhasePowerSpectrum,
+		PhaseSwap,
+		PhaseFrame,
+		PhaseCount
+	};
+
+	/// Default constructor
+	FrameProfiler();
+
+	/// Destructor
+	virtual ~FrameProfiler();
+
+	/**
+	 * \brief Enables the profiler
+	 *
+	 * \param filename The name of the CSV file written by \ref dump()
+	 */
+	void enable(const string filename);
+
+	/**
+	 * \brief Query the profiler state
+	 *
+	 * \return TRUE if the profiler is enabled, otherwise FALSE
+	 */
+	inline bool isEnabled() const;
+
+	/**
+	 * \brief Marks the start of a new frame
+	 *
+	 * Resets the timings of the current frame and starts \ref PhaseFrame.
+	 */
+	void beginFrame();
+
+	/**
+	 * \brief Completes the current frame and stores its timings in the ring buffer
+	 */
+	void endFrame();
+
+	/**
+	 * \brief Starts the timer of the given phase
+	 *
+	 * \param phase The phase to be started
+	 */
+	inline void startPhase(const Phase phase);
+
+	/**
+	 * \brief Stops the timer of the given phase and accumulates the elapsed time
+	 *
+	 * \param phase The phase to be stopped
+	 */
+	inline void stopPhase(const Phase phase);
+
+	/**
+	 * \brief Aggregates the recorded samples and writes them as CSV file
+	 *
+	 * Columns: phase, samples, mean, p50, p95, p99, max (all times in milliseconds)
+	 *
+	 * \return TRUE if successful, otherwise FALSE
+	 *
+	 * \see enable()
+	 */
+	bool dump() const;
+
+	/**
+	 * \brief Installs a signal handler requesting a dump (SIGUSR1, POSIX only)
+	 *
+	 * \see isDumpRequested()
+	 */
+	static void installSignalHandler();
+
+	/**
+	 * \brief Checks (and resets) the dump request indicator set by the signal handler
+	 *
+	 * \return TRUE if a dump has been requested, otherwise FALSE
+	 */
+	static bool isDumpRequested();
+
+	/**
+	 * \brief Nearest-rank percentile of a sorted sample
+	 *
+	 * \param sortedValues The sample values (sorted in ascending order)
+	 * \param percentage The requested percentile (1-100)
+	 *
+	 * \return The percentile value (0 for an empty sample)
+	 */
+	static float percentile(const vector<float> &sortedValues, const unsigned int percentage);
+
+	/**
+	 * \brief High-resolution monotonic timestamp
+	 *
+	 * \return The current timestamp in seconds (arbitrary origin)
+	 */
+	static double timestamp();
+
+private:
+	/// Signal handler (sets \ref m_DumpRequested)
+	static void signalHandler(int signum);
+
+	/// Number of frames kept in the ring buffer (power of two)
+	static const unsigned int RingBufferSize = 4096;
+
+	/// Timings of a single frame (seconds)
+	struct Sample {
+		float phases[PhaseCount];
+	};
+
+	/// Profiler state
+	bool m_Enabled;
+
+	/// The name of the CSV output file
+	string m_Filename;
+
+	/// Ring buffer of completed frames
+	vector<Sample> m_RingBuffer;
+
+	/// Total number of frames written (the producer's write index)
+	volatile unsigned int m_WriteCount;
+
+	/// Timings of the current frame
+	Sample m_CurrentFrame;
+
+	/// Start timestamps of all running phases
+	double m_PhaseStart[PhaseCount];
+
+	/// Dump request indicator
+	static volatile sig_atomic_t m_DumpRequested;
+};
+
+// inline implementations
+
+inline bool FrameProfiler::isEnabled() const
+{
+	return m_Enabled;
+}
+
+inline void FrameProfiler::startPhase(const Phase phase)
+{
+	if(!m_Enabled) return;
+	m_PhaseStart[phase] = timestamp();
+}
+
+inline void FrameProfiler::stopPhase(const Phase phase)
+{
+	if(!m_Enabled) return;
+	m_CurrentFrame.phases[phase] += timestamp() - m_PhaseStart[phase];
+}
+
+/**
+ * @}
+ */
+
+#endif /*FRAMEPROFILER_H_*/
@@ -0,0 +1,150 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "FrameScheduler.h"
+
+FrameScheduler::FrameScheduler(const double frameRate)
+{
+	m_FrameCount = 0;
+	m_IntervalCount = 0;
+	m_IntervalSum = 0.0;
+	m_IntervalMax = 0.0;
+	m_OverrunCount = 0;
+	m_DroppedCount = 0;
+	m_BackOffCount = 0;
+
+	setFrameRate(frameRate);
+	reset();
+}
+
+FrameScheduler::~FrameScheduler()
+{
+}
+
+void FrameScheduler::setFrameRate(const double frameRate)
+{
+	m_TargetInterval = 1.0 / (frameRate > 0.0 ? frameRate : 20.0);
+	m_CurrentInterval = m_TargetInterval;
+	m_ConsecutiveOverruns = 0;
+	m_ConsecutiveShortFrames = 0;
+}
+
+void FrameScheduler::reset()
+{
+	m_NextFrameTime = FrameProfiler::timestamp();
+	m_FrameStartTime = m_NextFrameTime;
+	m_LastFrameStartTime = -1.0;
+}
+
+bool FrameScheduler::isFrameDue() const
+{
+	return FrameProfiler::timestamp() >= m_NextFrameTime;
+}
+
+int FrameScheduler::sleepTime() const
+{
+	const double remaining = m_NextFrameTime - FrameProfiler::timestamp();
+	if(remaining <= 0.0) return 0;
+
+	// round up to avoid busy waiting for the last fraction of a millisecond
+	const int milliseconds = (int)(remaining * 1000.0) + 1;
+
+	return milliseconds < MaxSleepTime ? milliseconds : MaxSleepTime;
+}
+
+void FrameScheduler::frameStarted()
+{
+	m_FrameStartTime = FrameProfiler::timestamp();
+
+	// measure actual interval
+	if(m_LastFrameStartTime >= 0.0) {
+		const double interval = m_FrameStartTime - m_LastFrameStartTime;
+		m_IntervalSum += interval;
+		m_IntervalCount++;
+		if(interval > m_IntervalMax) m_IntervalMax = interval;
+	}
+	m_LastFrameStartTime = m_FrameStartTime;
+
+	// schedule next deadline (absolute, no drift)
+	m_NextFrameTime += m_CurrentInterval;
+
+	// we're more than a whole interval behind: drop stale deadlines
+	if(m_NextFrameTime <= m_FrameStartTime) {
+		m_DroppedCount += (unsigned int)((m_FrameStartTime - m_NextFrameTime) / m_CurrentInterval) + 1;
+		m_NextFrameTime = m_FrameStartTime + m_CurrentInterval;
+	}
+}
+
+void FrameScheduler::frameCompleted()
+{
+	const double duration = FrameProfiler::timestamp() - m_FrameStartTime;
+	m_FrameCount++;
+
+	if(duration > m_CurrentInterval) {
+		m_OverrunCount++;
+		m_ConsecutiveOverruns++;
+		m_ConsecutiveShortFrames = 0;
+
+		// back off (at most down to a quarter of the target frame rate)
+		if(m_ConsecutiveOverruns >= BackOffThreshold && m_CurrentInterval < 4.0 * m_TargetInterval) {
+			m_CurrentInterval *= 1.5;
+			if(m_CurrentInterval > 4.0 * m_TargetInterval) m_CurrentInterval = 4.0 * m_TargetInterval;
+			m_ConsecutiveOverruns = 0;
+			m_BackOffCount++;
+		}
+	}
+	else if(duration < 0.5 * m_CurrentInterval) {
+		m_ConsecutiveOverruns = 0;
+		m_ConsecutiveShortFrames++;
+
+		// recover gradually
+		if(m_ConsecutiveShortFrames >= RecoveryThreshold && m_CurrentInterval > m_TargetInterval) {
+			m_CurrentInterval *= 0.9;
+			if(m_CurrentInterval < m_TargetInterval) m_CurrentInterval = m_TargetInterval;
+			m_ConsecutiveShortFrames = 0;
+		}
+	}
+	else {
+		m_ConsecutiveOverruns = 0;
+		m_ConsecutiveShortFrames = 0;
+	}
+}
+
+void FrameScheduler::report() const
+{
+	if(m_IntervalCount == 0) return;
+
+	// don't change the formatting of subsequent diagnostics
+	const ios_base::fmtflags flags = cerr.flags();
+	const streamsize precision = cerr.precision();
+
+	cerr << fixed << setprecision(2)
+		 << "Frame pacing: " << m_FrameCount << " frames, interval (ms): target "
+		 << 1000.0 * m_TargetInterval
+		 << ", actual average " << 1000.0 * m_IntervalSum / m_IntervalCount
+		 << ", max " << 1000.0 * m_IntervalMax
+		 << ", current " << 1000.0 * m_CurrentInterval
+		 << "; overruns: " << m_OverrunCount
+		 << ", dropped deadlines: " << m_DroppedCount
+		 << ", back-offs: " << m_BackOffCount << endl;
+
+	cerr.flags(flags);
+	cerr.precision(precision);
+}
@@ -0,0 +1,167 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef FRAMESCHEDULER_H_
+#define FRAMESCHEDULER_H_
+
+#include <iostream>
+#include <iomanip>
+
+#include "FrameProfiler.h"
+
+using namespace std;
+
+/**
+ * \addtogroup framework Framework
+ * @{
+ */
+
+/**
+ * \brief Adaptive frame pacing based on a monotonic clock
+ *
+ * %FrameScheduler decides when the next frame is due. Frame deadlines are kept
+ * on an absolute schedule (<tt>previous deadline + interval</tt>, computed with
+ * sub-millisecond precision) so there's neither drift nor jitter caused by
+ * integer millisecond timer intervals. If the renderer falls behind by more than
+ * a whole interval, the missed deadlines are dropped instead of being rendered
+ * in a burst.
+ *
+ * The scheduler also measures the actual time between frames and the time spent
+ * per frame. When frames repeatedly overrun their interval, the interval is
+ * increased (back-off) to leave CPU time to the science application. It's reduced
+ * again towards the target interval once frames fit comfortably.
+ *
+ * \author Oliver Bock\n
+ * Max-Planck-Institute for Gravitational Physics\n
+ * Hannover, Germany
+ */
+class FrameScheduler
+{
+public:
+	/**
+	 * \brief Constructor
+	 *
+	 * \param frameRate The target frame rate (frames per second)
+	 */
+	FrameScheduler(const double frameRate = 20.0);
+
+	/// Destructor
+	virtual ~FrameScheduler();
+
+	/**
+	 * \brief Sets a new target frame rate (resets the back-off)
+	 *
+	 * \param frameRate The target frame rate (frames per second)
+	 */
+	void setFrameRate(const double frameRate);
+
+	/**
+	 * \brief Restarts the schedule (the next frame is due immediately)
+	 */
+	void reset();
+
+	/**
+	 * \brief Query whether the next frame is due
+	 *
+	 * \return TRUE if the next frame should be rendered now, otherwise FALSE
+	 */
+	bool isFrameDue() const;
+
+	/**
+	 * \brief Retrieve the time to wait before checking again
+	 *
+	 * \return The time until the next frame is due in milliseconds, limited to
+	 * \ref MaxSleepTime to keep the input latency low
+	 */
+	int sleepTime() const;
+
+	/**
+	 * \brief Has to be called right before a frame is rendered
+	 */
+	void frameStarted();
+
+	/**
+	 * \brief Has to be called right after a frame has been rendered (and swapped)
+	 */
+	void frameCompleted();
+
+	/**
+	 * \brief Prints the pacing statistics (actual vs. target interval) to stderr
+	 */
+	void report() const;
+
+private:
+	/// Maximum sleep time in milliseconds
+	static const int MaxSleepTime = 10;
+
+	/// Consecutive overruns that trigger a back-off
+	static const int BackOffThreshold = 3;
+
+	/// Consecutive short frames that trigger a recovery step
+	static const int RecoveryThreshold = 10;
+
+	/// The target frame interval in seconds
+	double m_TargetInterval;
+
+	/// The current (possibly backed off) frame interval in seconds
+	double m_CurrentInterval;
+
+	/// The deadline of the next frame (monotonic clock)
+	double m_NextFrameTime;
+
+	/// The start time of the current frame (monotonic clock)
+	double m_FrameStartTime;
+
+	/// The start time of the previous frame (monotonic clock, negative if none)
+	double m_LastFrameStartTime;
+
+	/// Number of consecutive frames that overran the current interval
+	int m_ConsecutiveOverruns;
+
+	/// Number of consecutive frames that used less than half of the current interval
+	int m_ConsecutiveShortFrames;
+
+	/// Number of frames rendered
+	unsigned int m_FrameCount;
+
+	/// Number of measured intervals (between two frame starts)
+	unsigned int m_IntervalCount;
+
+	/// Sum of all measured intervals (seconds)
+	double m_IntervalSum;
+
+	/// Longest measured interval (seconds)
+	double m_IntervalMax;
+
+	/// Number of frames that overran the current interval
+	unsigned int m_OverrunCount;
+
+	/// Number of dropped deadlines
+	unsigned int m_DroppedCount;
+
+	/// Number of back-off steps
+	unsigned int m_BackOffCount;
+};
+
+/**
+ * @}
+ */
+
+#endif /*FRAMESCHEDULER_H_*/
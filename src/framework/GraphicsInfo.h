@@ -0,0 +1,151 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef GRAPHICSINFO_H_
+#define GRAPHICSINFO_H_
+
+/*
+ * Note: this header is used by the science applications as well,
+ * hence it has to remain C compatible!
+ */
+
+#include <stdint.h>
+
+/**
+ * \addtogroup framework Framework
+ * @{
+ */
+
+/// Identifies a binary graphics_info record (never starts with '<', unlike the XML variant)
+#define GRAPHICS_INFO_MAGIC "EaHg"
+
+/// Size of \ref GRAPHICS_INFO_MAGIC (without terminating NUL)
+#define GRAPHICS_INFO_MAGIC_SIZE 4
+
+/// The current version of the binary graphics_info layout
+#define GRAPHICS_INFO_VERSION 1
+
+/// Upper limit for the size of a binary graphics_info record (header and payload)
+#define GRAPHICS_INFO_MAX_SIZE 65536
+
+/**
+ * \brief Types of binary graphics_info payloads
+ *
+ * \see GraphicsInfoHeader
+ */
+typedef enum {
+	GraphicsInfoTypeS5R3 = 1,
+	GraphicsInfoTypeRadio = 2
+} GraphicsInfoType;
+
+/**
+ * \brief Header of a binary graphics_info record in the shared memory area
+ *
+ * The header is followed by the typed payload (see \ref GraphicsInfoType) which in turn
+ * might be followed by variable sized data (e.g. the power spectrum). All values use the
+ * host's native byte order and alignment as writer and reader run on the same machine.
+ *
+ * The sequence counter is odd while the writer updates the record and even when it's
+ * complete. Readers discard records that have an odd sequence or changed while being read.
+ *
+ * \see GraphicsInfoWriter
+ */
+typedef struct {
+	/// Always \ref GRAPHICS_INFO_MAGIC
+	char magic[GRAPHICS_INFO_MAGIC_SIZE];
+
+	/// Layout version (\ref GRAPHICS_INFO_VERSION)
+	uint32_t version;
+
+	/// Payload type (see \ref GraphicsInfoType)
+	uint32_t type;
+
+	/// Update sequence counter (odd while being written)
+	uint32_t sequence;
+
+	/// Size of everything following the header (in bytes)
+	uint32_t length;
+
+	/// Reserved (padding)
+	uint32_t reserved;
+} GraphicsInfoHeader;
+
+/**
+ * \brief Payload of binary graphics_info records of type \ref GraphicsInfoTypeS5R3
+ *
+ * Angles are given in radians, like in the XML variant.
+ */
+typedef struct {
+	/// Right ascension of the currently searched sky position
+	double skyPosRightAscension;
+
+	/// Declination of the currently searched sky position
+	double skyPosDeclination;
+
+	/// Fraction of the work unit done (range: 0-1)
+	double fractionDone;
+
+	/// CPU time spent on the work unit (in seconds)
+	double cpuTime;
+} GraphicsInfoS5R3;
+
+/**
+ * \brief Payload of binary graphics_info records of type \ref GraphicsInfoTypeRadio
+ *
+ * Angles are given in radians, like in the XML variant. The payload is followed by
+ * \c powerSpectrumBins bytes, one per power spectrum bin (range: 0-255).
+ */
+typedef struct {
+	/// Right ascension of the currently searched sky position
+	double skyPosRightAscension;
+
+	/// Declination of the currently searched sky position
+	double skyPosDeclination;
+
+	/// Dispersion measure of the current template
+	double dispersionMeasure;
+
+	/// Orbital radius of the current template
+	double orbitalRadius;
+
+	/// Orbital period of the current template
+	double orbitalPeriod;
+
+	/// Orbital phase of the current template
+	double orbitalPhase;
+
+	/// Fraction of the work unit done (range: 0-1)
+	double fractionDone;
+
+	/// CPU time spent on the work unit (in seconds)
+	double cpuTime;
+
+	/// Number of power spectrum bins following the payload
+	uint32_t powerSpectrumBins;
+
+	/// Reserved (padding)
+	uint32_t reserved;
+} GraphicsInfoRadio;
+
+/**
+ * @}
+ */
+
+#endif /*GRAPHICSINFO_H_*/
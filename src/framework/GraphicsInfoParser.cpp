@@ -0,0 +1,234 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "GraphicsInfoParser.h"
+
+#include <cstring>
+
+/// Powers of ten used to scale the parsed mantissa
+static const double PowersOfTen[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+GraphicsInfoParser::GraphicsInfoParser(const char *data, const size_t length)
+{
+	m_Position = data;
+	m_End = data + length;
+	m_Name = NULL;
+	m_NameLength = 0;
+	m_Value = NULL;
+	m_ValueLength = 0;
+}
+
+GraphicsInfoParser::GraphicsInfoParser(const string &data)
+{
+	m_Position = data.data();
+	m_End = data.data() + data.length();
+	m_Name = NULL;
+	m_NameLength = 0;
+	m_Value = NULL;
+	m_ValueLength = 0;
+}
+
+GraphicsInfoParser::~GraphicsInfoParser()
+{
+}
+
+bool GraphicsInfoParser::next()
+{
+	while(m_Position < m_End) {
+		// find next tag
+		const char *tag = (const char*) memchr(m_Position, '<', m_End - m_Position);
+		if(!tag || tag + 1 >= m_End) break;
+
+		// skip end tags, comments and processing instructions
+		if(tag[1] == '/' || tag[1] == '!' || tag[1] == '?') {
+			const char *tagEnd = (const char*) memchr(tag, '>', m_End - tag);
+			if(!tagEnd) break;
+			m_Position = tagEnd + 1;
+			continue;
+		}
+
+		// element name ends with whitespace, '/' or '>'
+		const char *name = tag + 1;
+		const char *nameEnd = name;
+		while(nameEnd < m_End && *nameEnd != '>' && *nameEnd != '/' &&
+			  *nameEnd != ' ' && *nameEnd != '\t' && *nameEnd != '\r' && *nameEnd != '\n') {
+			++nameEnd;
+		}
+
+		// skip attributes
+		const char *tagEnd = (const char*) memchr(nameEnd, '>', m_End - nameEnd);
+		if(!tagEnd) break;
+
+		m_Name = name;
+		m_NameLength = nameEnd - name;
+
+		// empty element
+		if(tagEnd[-1] == '/') {
+			m_Value = tagEnd;
+			m_ValueLength = 0;
+			m_Position = tagEnd + 1;
+			return true;
+		}
+
+		// text value extends up to the next tag (trimmed)
+		const char *value = skipWhitespace(tagEnd + 1);
+		const char *valueEnd = m_End;
+		if(value < m_End) {
+			const char *nextTag = (const char*) memchr(value, '<', m_End - value);
+			if(nextTag) valueEnd = nextTag;
+		}
+		m_Position = valueEnd;
+
+		while(valueEnd > value && (valueEnd[-1] == ' ' || valueEnd[-1] == '\t' ||
+								   valueEnd[-1] == '\r' || valueEnd[-1] == '\n')) {
+			--valueEnd;
+		}
+
+		m_Value = value;
+		m_ValueLength = valueEnd - value;
+
+		return true;
+	}
+
+	m_Position = m_End;
+	m_Name = NULL;
+	m_NameLength = 0;
+	m_Value = NULL;
+	m_ValueLength = 0;
+
+	return false;
+}
+
+bool GraphicsInfoParser::isElement(const char *name) const
+{
+	return m_Name && strncmp(m_Name, name, m_NameLength) == 0 && name[m_NameLength] == '\0';
+}
+
+const char *GraphicsInfoParser::value() const
+{
+	return m_Value;
+}
+
+size_t GraphicsInfoParser::valueLength() const
+{
+	return m_ValueLength;
+}
+
+bool GraphicsInfoParser::valueAsDouble(double &result) const
+{
+	if(!m_Value) return false;
+
+	return parseDouble(m_Value, m_Value + m_ValueLength, result);
+}
+
+bool GraphicsInfoParser::parseDouble(const char *first, const char *last, double &result)
+{
+	const char *position = first;
+	bool negative = false;
+
+	if(position < last && (*position == '-' || *position == '+')) {
+		negative = *position == '-';
+		++position;
+	}
+
+	// collect up to 19 significant digits (fits into 64 bit), count the rest
+	unsigned long long mantissa = 0;
+	int digits = 0;
+	int exponent = 0;
+	bool anyDigits = false;
+
+	while(position < last && *position >= '0' && *position <= '9') {
+		if(digits < 19) {
+			mantissa = mantissa * 10 + (*position - '0');
+			if(mantissa) ++digits;
+		}
+		else {
+			++exponent;
+		}
+		anyDigits = true;
+		++position;
+	}
+
+	if(position < last && *position == '.') {
+		++position;
+		while(position < last && *position >= '0' && *position <= '9') {
+			if(digits < 19) {
+				mantissa = mantissa * 10 + (*position - '0');
+				if(mantissa) ++digits;
+				--exponent;
+			}
+			anyDigits = true;
+			++position;
+		}
+	}
+
+	if(!anyDigits) return false;
+
+	if(position < last && (*position == 'e' || *position == 'E')) {
+		++position;
+		bool negativeExponent = false;
+		if(position < last && (*position == '-' || *position == '+')) {
+			negativeExponent = *position == '-';
+			++position;
+		}
+
+		if(position == last || *position < '0' || *position > '9') return false;
+
+		int explicitExponent = 0;
+		while(position < last && *position >= '0' && *position <= '9') {
+			if(explicitExponent < 10000) explicitExponent = explicitExponent * 10 + (*position - '0');
+			++position;
+		}
+
+		exponent += negativeExponent ? -explicitExponent : explicitExponent;
+	}
+
+	// trailing garbage
+	if(position != last) return false;
+
+	// scale mantissa (in steps for exponents beyond the table)
+	double value = (double) mantissa;
+	while(exponent > 22) {
+		value *= 1e22;
+		exponent -= 22;
+	}
+	while(exponent < -22) {
+		value /= 1e22;
+		exponent += 22;
+	}
+	value = exponent < 0 ? value / PowersOfTen[-exponent] : value * PowersOfTen[exponent];
+
+	result = negative ? -value : value;
+
+	return true;
+}
+
+const char *GraphicsInfoParser::skipWhitespace(const char *position) const
+{
+	while(position < m_End && (*position == ' ' || *position == '\t' ||
+							   *position == '\r' || *position == '\n')) {
+		++position;
+	}
+
+	return position;
+}
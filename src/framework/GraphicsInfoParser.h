@@ -0,0 +1,163 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef GRAPHICSINFOPARSER_H_
+#define GRAPHICSINFOPARSER_H_
+
+#include <cstddef>
+#include <string>
+
+using namespace std;
+
+/**
+ * \addtogroup framework Framework
+ * @{
+ */
+
+/**
+ * \brief Allocation-free scanner for XML graphics_info strings
+ *
+ * The science applications provide flat XML fragments like
+ * <tt>\<graphics_info\>\<skypos_rac\>0.1\</skypos_rac\>...\</graphics_info\></tt>.
+ * This class walks over such a fragment in a single pass, visiting one element at a
+ * time, without building a tree or copying anything. The element name and text value
+ * are exposed as pointers into the original buffer, numbers are converted in place.
+ *
+ * Whitespace between and inside elements (around values) is ignored, as are attributes,
+ * comments, processing instructions and end tags. The scanner isn't a validating XML
+ * parser: it doesn't check nesting nor resolve entities.
+ *
+ * \author Oliver Bock\n
+ * Max-Planck-Institute for Gravitational Physics\n
+ * Hannover, Germany
+ */
+class GraphicsInfoParser
+{
+public:
+	/**
+	 * \brief Constructor
+	 *
+	 * \param data Pointer to the XML fragment (doesn't need to be NUL terminated)
+	 * \param length The length of the XML fragment
+	 */
+	GraphicsInfoParser(const char *data, const size_t length);
+
+	/**
+	 * \brief Constructor
+	 *
+	 * \param data The XML fragment (must outlive the parser)
+	 */
+	GraphicsInfoParser(const string &data);
+
+	/// Destructor
+	virtual ~GraphicsInfoParser();
+
+	/**
+	 * \brief Advances to the next element
+	 *
+	 * \return TRUE if there's another element, FALSE at the end of the fragment
+	 */
+	bool next();
+
+	/**
+	 * \brief Compares the current element's name
+	 *
+	 * \param name The name to compare with
+	 *
+	 * \return TRUE if the current element has the given name, otherwise FALSE
+	 */
+	bool isElement(const char *name) const;
+
+	/**
+	 * \brief Retrieves the current element's text value (leading/trailing whitespace removed)
+	 *
+	 * Note: the value isn't NUL terminated, use \ref valueLength() instead.
+	 *
+	 * \return Pointer to the value's first character (inside the original fragment)
+	 */
+	const char *value() const;
+
+	/**
+	 * \brief Retrieves the length of the current element's text value
+	 *
+	 * \return The value's length (0 for elements without text, e.g. the root)
+	 */
+	size_t valueLength() const;
+
+	/**
+	 * \brief Converts the current element's text value into a floating point number
+	 *
+	 * \param result Reference to the variable receiving the number (unchanged on failure)
+	 *
+	 * \return TRUE if the value is a valid number, otherwise FALSE
+	 *
+	 * \see parseDouble()
+	 */
+	bool valueAsDouble(double &result) const;
+
+	/**
+	 * \brief Converts characters into a floating point number
+	 *
+	 * This is a fast locale independent replacement for \c strtod / string streams
+	 * (<tt>[+-]digits[.digits][(e|E)[+-]digits]</tt>). It's accurate to about 15
+	 * significant digits which is plenty for the information displayed.
+	 *
+	 * \param first Pointer to the first character
+	 * \param last Pointer behind the last character (all characters have to be consumed)
+	 * \param result Reference to the variable receiving the number (unchanged on failure)
+	 *
+	 * \return TRUE if the characters form a valid number, otherwise FALSE
+	 */
+	static bool parseDouble(const char *first, const char *last, double &result);
+
+private:
+	/**
+	 * \brief Skips whitespace
+	 *
+	 * \param position Pointer to the first character to check
+	 *
+	 * \return Pointer to the first non-whitespace character (or the end of the fragment)
+	 */
+	const char *skipWhitespace(const char *position) const;
+
+	/// Pointer to the current position within the fragment
+	const char *m_Position;
+
+	/// Pointer behind the fragment's last character
+	const char *m_End;
+
+	/// Pointer to the current element's name
+	const char *m_Name;
+
+	/// Length of the current element's name
+	size_t m_NameLength;
+
+	/// Pointer to the current element's value
+	const char *m_Value;
+
+	/// Length of the current element's value
+	size_t m_ValueLength;
+};
+
+/**
+ * @}
+ */
+
+#endif /*GRAPHICSINFOPARSER_H_*/
@@ -0,0 +1,206 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+/*
+ * Micro-benchmark comparing GraphicsInfoParser with the libxml2 based parsing
+ * previously used by EinsteinRadioAdapter (text reader plus string streams).
+ * Both parsers process the same graphics_info fragment and have to agree on
+ * the results. Build with "make parserbenchmark".
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cmath>
+
+#include <sys/time.h>
+
+#include <libxml/xmlreader.h>
+
+#include "GraphicsInfoParser.h"
+
+using namespace std;
+
+/// Values of a radio search graphics_info fragment
+struct RadioInfo
+{
+	double rightAscension;
+	double declination;
+	double dispersion;
+	double orbitalRadius;
+	double orbitalPeriod;
+	double orbitalPhase;
+	double fractionDone;
+	double cpuTime;
+	string powerSpectrum;
+};
+
+static double timestamp()
+{
+	struct timeval now;
+	gettimeofday(&now, NULL);
+
+	return now.tv_sec + now.tv_usec / 1e6;
+}
+
+static string sampleFragment()
+{
+	stringstream buffer;
+	buffer.precision(10);
+
+	buffer	<< "<graphics_info>\n"
+			<< "  <skypos_rac>" << 1.2345678901 << "</skypos_rac>\n"
+			<< "  <skypos_dec>" << -0.3456789012 << "</skypos_dec>\n"
+			<< "  <dispersion>" << 123.456 << "</dispersion>\n"
+			<< "  <orb_radius>" << 0.5678 << "</orb_radius>\n"
+			<< "  <orb_period>" << 3456.789 << "</orb_period>\n"
+			<< "  <orb_phase>" << 2.3456 << "</orb_phase>\n"
+			<< "  <power_spectrum>";
+
+	for(int i = 0; i < 40; ++i) {
+		buffer << hex << setw(2) << setfill('0') << (i * 37) % 256;
+	}
+
+	buffer	<< dec << "</power_spectrum>\n"
+			<< "  <fraction_done>" << 0.4321 << "</fraction_done>\n"
+			<< "  <cpu_time>" << 12345.67 << "</cpu_time>\n"
+			<< "</graphics_info>\n";
+
+	return buffer.str();
+}
+
+static void parseLibxml2(xmlTextReaderPtr &reader, const string &info, RadioInfo &result)
+{
+	stringstream converter;
+	converter.precision(3);
+	converter.exceptions(ios_base::badbit | ios_base::failbit);
+
+	if(!reader) {
+		reader = xmlReaderForMemory(info.c_str(), info.length(), "http://einstein.phys.uwm.edu", "UTF-8", 0);
+	}
+	else {
+		xmlReaderNewMemory(reader, info.c_str(), info.length(), "http://einstein.phys.uwm.edu", "UTF-8", 0);
+	}
+
+	while(xmlTextReaderRead(reader) == 1) {
+		if(xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT) continue;
+
+		const xmlChar *nodeName = xmlTextReaderConstLocalName(reader);
+		if(!(xmlTextReaderRead(reader) && xmlTextReaderHasValue(reader))) continue;
+		const xmlChar *nodeValue = xmlTextReaderConstValue(reader);
+
+		try {
+			converter.clear();
+			converter.str("");
+			converter << nodeValue;
+
+			if(xmlStrEqual(nodeName, BAD_CAST("skypos_rac"))) converter >> fixed >> result.rightAscension;
+			else if(xmlStrEqual(nodeName, BAD_CAST("skypos_dec"))) converter >> fixed >> result.declination;
+			else if(xmlStrEqual(nodeName, BAD_CAST("dispersion"))) converter >> fixed >> result.dispersion;
+			else if(xmlStrEqual(nodeName, BAD_CAST("orb_radius"))) converter >> fixed >> result.orbitalRadius;
+			else if(xmlStrEqual(nodeName, BAD_CAST("orb_period"))) converter >> fixed >> result.orbitalPeriod;
+			else if(xmlStrEqual(nodeName, BAD_CAST("orb_phase"))) converter >> fixed >> result.orbitalPhase;
+			else if(xmlStrEqual(nodeName, BAD_CAST("power_spectrum"))) converter >> result.powerSpectrum;
+			else if(xmlStrEqual(nodeName, BAD_CAST("fraction_done"))) converter >> fixed >> result.fractionDone;
+			else if(xmlStrEqual(nodeName, BAD_CAST("cpu_time"))) converter >> fixed >> result.cpuTime;
+		}
+		catch(const ios_base::failure&) {
+			cerr << "Error converting XML reader node content!" << endl;
+		}
+	}
+}
+
+static void parseScanner(const string &info, RadioInfo &result)
+{
+	GraphicsInfoParser parser(info);
+
+	while(parser.next()) {
+		if(parser.isElement("skypos_rac")) parser.valueAsDouble(result.rightAscension);
+		else if(parser.isElement("skypos_dec")) parser.valueAsDouble(result.declination);
+		else if(parser.isElement("dispersion")) parser.valueAsDouble(result.dispersion);
+		else if(parser.isElement("orb_radius")) parser.valueAsDouble(result.orbitalRadius);
+		else if(parser.isElement("orb_period")) parser.valueAsDouble(result.orbitalPeriod);
+		else if(parser.isElement("orb_phase")) parser.valueAsDouble(result.orbitalPhase);
+		else if(parser.isElement("power_spectrum")) result.powerSpectrum.assign(parser.value(), parser.valueLength());
+		else if(parser.isElement("fraction_done")) parser.valueAsDouble(result.fractionDone);
+		else if(parser.isElement("cpu_time")) parser.valueAsDouble(result.cpuTime);
+	}
+}
+
+static bool agree(const double a, const double b)
+{
+	return fabs(a - b) <= 1e-12 * fabs(a);
+}
+
+int main(int argc, char **argv)
+{
+	const int iterations = argc > 1 ? atoi(argv[1]) : 100000;
+	const string info = sampleFragment();
+
+	RadioInfo reference, candidate;
+	xmlTextReaderPtr reader = NULL;
+
+	// check that both parsers agree
+	parseLibxml2(reader, info, reference);
+	parseScanner(info, candidate);
+
+	if(!(agree(reference.rightAscension, candidate.rightAscension) &&
+		 agree(reference.declination, candidate.declination) &&
+		 agree(reference.dispersion, candidate.dispersion) &&
+		 agree(reference.orbitalRadius, candidate.orbitalRadius) &&
+		 agree(reference.orbitalPeriod, candidate.orbitalPeriod) &&
+		 agree(reference.orbitalPhase, candidate.orbitalPhase) &&
+		 agree(reference.fractionDone, candidate.fractionDone) &&
+		 agree(reference.cpuTime, candidate.cpuTime) &&
+		 reference.powerSpectrum == candidate.powerSpectrum)) {
+		cerr << "Parsers disagree!" << endl;
+		return 1;
+	}
+
+	double start = timestamp();
+	for(int i = 0; i < iterations; ++i) {
+		parseLibxml2(reader, info, reference);
+	}
+	const double libxml2Time = timestamp() - start;
+
+	start = timestamp();
+	for(int i = 0; i < iterations; ++i) {
+		parseScanner(info, candidate);
+	}
+	const double scannerTime = timestamp() - start;
+
+	xmlFreeTextReader(reader);
+	xmlCleanupParser();
+
+	const double megabytes = (double) info.length() * iterations / (1024.0 * 1024.0);
+
+	cout << "Fragment size: " << info.length() << " bytes, " << iterations << " iterations" << endl;
+	cout << fixed << setprecision(2);
+	cout << "libxml2: " << setw(10) << libxml2Time * 1e6 / iterations << " us/parse "
+		 << setw(10) << megabytes / libxml2Time << " MB/s" << endl;
+	cout << "scanner: " << setw(10) << scannerTime * 1e6 / iterations << " us/parse "
+		 << setw(10) << megabytes / scannerTime << " MB/s" << endl;
+	cout << "Speedup: " << libxml2Time / scannerTime << "x" << endl;
+
+	return 0;
+}
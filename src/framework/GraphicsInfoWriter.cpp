@@ -0,0 +1,80 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "GraphicsInfoWriter.h"
+
+#include <cstring>
+
+GraphicsInfoWriter::GraphicsInfoWriter(void *area, const size_t size)
+{
+	m_Area = (char*) area;
+	m_Size = size;
+	m_Sequence = 0;
+}
+
+GraphicsInfoWriter::~GraphicsInfoWriter()
+{
+}
+
+bool GraphicsInfoWriter::write(const GraphicsInfoS5R3 &info)
+{
+	return writeRecord(GraphicsInfoTypeS5R3, &info, sizeof(info), NULL, 0);
+}
+
+bool GraphicsInfoWriter::write(const GraphicsInfoRadio &info, const unsigned char *powerSpectrum, const size_t bins)
+{
+	GraphicsInfoRadio payload = info;
+	payload.powerSpectrumBins = (uint32_t) bins;
+	payload.reserved = 0;
+
+	return writeRecord(GraphicsInfoTypeRadio, &payload, sizeof(payload), powerSpectrum, bins);
+}
+
+bool GraphicsInfoWriter::writeRecord(const GraphicsInfoType type,
+									 const void *payload, const size_t payloadSize,
+									 const void *data, const size_t dataSize)
+{
+	const size_t recordSize = sizeof(GraphicsInfoHeader) + payloadSize + dataSize;
+
+	if(!m_Area || recordSize > m_Size || recordSize > GRAPHICS_INFO_MAX_SIZE) return false;
+
+	GraphicsInfoHeader *header = (GraphicsInfoHeader*) m_Area;
+
+	// odd sequence: record is being updated
+	header->sequence = ++m_Sequence;
+	__sync_synchronize();
+
+	memcpy(header->magic, GRAPHICS_INFO_MAGIC, GRAPHICS_INFO_MAGIC_SIZE);
+	header->version = GRAPHICS_INFO_VERSION;
+	header->type = type;
+	header->length = (uint32_t) (payloadSize + dataSize);
+	header->reserved = 0;
+
+	memcpy(m_Area + sizeof(GraphicsInfoHeader), payload, payloadSize);
+	if(data && dataSize > 0) {
+		memcpy(m_Area + sizeof(GraphicsInfoHeader) + payloadSize, data, dataSize);
+	}
+
+	// even sequence: record is complete
+	__sync_synchronize();
+	header->sequence = ++m_Sequence;
+
+	return true;
+}
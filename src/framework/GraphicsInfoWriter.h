@@ -0,0 +1,111 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef GRAPHICSINFOWRITER_H_
+#define GRAPHICSINFOWRITER_H_
+
+#include <cstddef>
+
+#include "GraphicsInfo.h"
+
+using namespace std;
+
+/**
+ * \addtogroup framework Framework
+ * @{
+ */
+
+/**
+ * \brief Writes binary graphics_info records into a shared memory area
+ *
+ * This class is meant to be used by the science applications instead of formatting
+ * XML strings. It writes a fixed-layout record (see \ref GraphicsInfoHeader) which the
+ * graphics application's adapters detect and read without any parsing. The update
+ * protocol (sequence counter) lets readers discard partially written records.
+ *
+ * \author Oliver Bock\n
+ * Max-Planck-Institute for Gravitational Physics\n
+ * Hannover, Germany
+ */
+class GraphicsInfoWriter
+{
+public:
+	/**
+	 * \brief Constructor
+	 *
+	 * \param area Pointer to the shared memory area (as returned by \c boinc_graphics_make_shmem)
+	 * \param size The size of the shared memory area (in bytes)
+	 */
+	GraphicsInfoWriter(void *area, const size_t size);
+
+	/// Destructor
+	virtual ~GraphicsInfoWriter();
+
+	/**
+	 * \brief Writes an S5R3 record
+	 *
+	 * \param info The information to be written
+	 *
+	 * \return TRUE if successful, FALSE if the area is too small
+	 */
+	bool write(const GraphicsInfoS5R3 &info);
+
+	/**
+	 * \brief Writes a radio pulsar search record
+	 *
+	 * \param info The information to be written (\c powerSpectrumBins is set accordingly)
+	 * \param powerSpectrum Pointer to the power spectrum bins (one byte each)
+	 * \param bins The number of power spectrum bins
+	 *
+	 * \return TRUE if successful, FALSE if the area is too small
+	 */
+	bool write(const GraphicsInfoRadio &info, const unsigned char *powerSpectrum, const size_t bins);
+
+private:
+	/**
+	 * \brief Writes a complete record following the update protocol
+	 *
+	 * \param type The payload type
+	 * \param payload Pointer to the payload
+	 * \param payloadSize The size of the payload (in bytes)
+	 * \param data Pointer to the variable sized data following the payload (may be NULL)
+	 * \param dataSize The size of the variable sized data (in bytes)
+	 *
+	 * \return TRUE if successful, FALSE if the area is too small
+	 */
+	bool writeRecord(const GraphicsInfoType type,
+					 const void *payload, const size_t payloadSize,
+					 const void *data, const size_t dataSize);
+
+	/// Pointer to the shared memory area
+	char *m_Area;
+
+	/// The size of the shared memory area (in bytes)
+	size_t m_Size;
+
+	/// The sequence counter of the last complete record
+	uint32_t m_Sequence;
+};
+
+/**
+ * @}
+ */
+
+#endif /*GRAPHICSINFOWRITER_H_*/
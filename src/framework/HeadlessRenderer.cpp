@@ -0,0 +1,188 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "HeadlessRenderer.h"
+
+HeadlessRenderer::HeadlessRenderer()
+{
+	m_Width = 0;
+	m_Height = 0;
+
+#ifdef HAVE_OSMESA
+	m_Context = NULL;
+#endif
+}
+
+HeadlessRenderer::~HeadlessRenderer()
+{
+#ifdef HAVE_OSMESA
+	if(m_Context) OSMesaDestroyContext(m_Context);
+#endif
+}
+
+bool HeadlessRenderer::initialize(const int width, const int height)
+{
+#ifdef HAVE_OSMESA
+	if(width <= 0 || height <= 0) {
+		cerr << "Invalid offscreen frame buffer size: " << width << "x" << height << endl;
+		return false;
+	}
+
+	m_Width = width;
+	m_Height = height;
+	m_FrameBuffer.assign(m_Width * m_Height * 4, 0);
+
+	// create RGBA context with depth buffer (required by starsphere)
+	m_Context = OSMesaCreateContextExt(OSMESA_RGBA, 24, 0, 0, NULL);
+	if(!m_Context) {
+		cerr << "Offscreen OpenGL context could not be created!" << endl;
+		return false;
+	}
+
+	if(!OSMesaMakeCurrent(m_Context, &m_FrameBuffer[0], GL_UNSIGNED_BYTE, m_Width, m_Height)) {
+		cerr << "Offscreen OpenGL context could not be activated!" << endl;
+		return false;
+	}
+
+	// store top row first (image file order)
+	OSMesaPixelStore(OSMESA_Y_UP, 0);
+
+	cerr << "Offscreen OpenGL context: " << glGetString(GL_RENDERER) << " ("
+		 << glGetString(GL_VERSION) << "), " << m_Width << "x" << m_Height << endl;
+
+	return true;
+#else
+	cerr << "Headless rendering not available (compiled without OSMesa support)!" << endl;
+	return false;
+#endif
+}
+
+bool HeadlessRenderer::renderFrames(AbstractGraphicsEngine *engine,
+									const int frameCount,
+									const double startTime,
+									const double frameInterval,
+									const string dumpPrefix)
+{
+#ifdef HAVE_OSMESA
+	if(!engine || !m_Context) return false;
+
+	double lastRefresh = startTime;
+	double frameTimeTotal = 0.0;
+	double frameTimeMin = 0.0;
+	double frameTimeMax = 0.0;
+
+	for(int i = 0; i < frameCount; ++i) {
+		const double timeOfDay = startTime + i * frameInterval;
+
+		// drive all engine clocks
+		engine->setFixedTime(timeOfDay);
+
+		// simulate the BOINC update timer (1s)
+		if(timeOfDay - lastRefresh >= 1.0) {
+			engine->updateBOINCInformation();
+			engine->refreshBOINCInformation();
+			lastRefresh = timeOfDay;
+		}
+
+		// render and wait until the frame is complete (software rendering)
+		FrameProfiler &profiler = engine->profiler();
+		double frameStart = dtime();
+		profiler.beginFrame();
+		engine->render(timeOfDay);
+		profiler.startPhase(FrameProfiler::PhaseSwap);
+		glFinish();
+		profiler.stopPhase(FrameProfiler::PhaseSwap);
+		profiler.endFrame();
+		double frameTime = dtime() - frameStart;
+
+		frameTimeTotal += frameTime;
+		if(i == 0 || frameTime < frameTimeMin) frameTimeMin = frameTime;
+		if(i == 0 || frameTime > frameTimeMax) frameTimeMax = frameTime;
+
+		if(!dumpPrefix.empty()) {
+			stringstream filename;
+			filename << dumpPrefix << setw(5) << setfill('0') << i << ".ppm";
+			if(!writeFrame(filename.str())) {
+				engine->setFixedTime(-1.0);
+				return false;
+			}
+		}
+	}
+
+	// back to system clock
+	engine->setFixedTime(-1.0);
+
+	if(frameCount > 0) {
+		// don't change the formatting of subsequent diagnostics
+		const ios_base::fmtflags flags = cerr.flags();
+		const streamsize precision = cerr.precision();
+
+		cerr << "Rendered " << frameCount << " frames, frame time (ms): "
+			 << fixed << setprecision(3)
+			 << "average " << 1000.0 * frameTimeTotal / frameCount
+			 << ", min " << 1000.0 * frameTimeMin
+			 << ", max " << 1000.0 * frameTimeMax << endl;
+
+		cerr.flags(flags);
+		cerr.precision(precision);
+	}
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool HeadlessRenderer::writeFrame(const string filename) const
+{
+	if(m_FrameBuffer.empty()) return false;
+
+	ofstream file(filename.c_str(), ios::out | ios::binary);
+	if(!file) {
+		cerr << "Frame dump could not be written: " << filename << endl;
+		return false;
+	}
+
+	file << "P6\n" << m_Width << " " << m_Height << "\n255\n";
+
+	// convert RGBA to RGB, row by row
+	vector<char> row(m_Width * 3);
+	for(int y = 0; y < m_Height; ++y) {
+		const unsigned char *pixel = &m_FrameBuffer[y * m_Width * 4];
+		for(int x = 0; x < m_Width; ++x) {
+			row[x * 3 + 0] = pixel[x * 4 + 0];
+			row[x * 3 + 1] = pixel[x * 4 + 1];
+			row[x * 3 + 2] = pixel[x * 4 + 2];
+		}
+		file.write(&row[0], row.size());
+	}
+
+	return file.good();
+}
+
+int HeadlessRenderer::windowWidth() const
+{
+	return m_Width;
+}
+
+int HeadlessRenderer::windowHeight() const
+{
+	return m_Height;
+}
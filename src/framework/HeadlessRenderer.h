@@ -0,0 +1,149 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef HEADLESSRENDERER_H_
+#define HEADLESSRENDERER_H_
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+#ifdef HAVE_OSMESA
+#include <GL/osmesa.h>
+#endif
+
+#include <util.h>
+
+#include "AbstractGraphicsEngine.h"
+
+using namespace std;
+
+/**
+ * \addtogroup framework Framework
+ * @{
+ */
+
+/**
+ * \brief This class provides an offscreen OpenGL context and a fixed-clock frame driver
+ *
+ * %HeadlessRenderer is the windowless counterpart of \ref WindowManager. It creates
+ * an OpenGL context that renders into main memory (using OSMesa) and drives a given
+ * \ref AbstractGraphicsEngine with a fixed clock, i.e. frame \c n is rendered for the
+ * time <tt>startTime + n * frameInterval</tt> regardless of the actual rendering speed.
+ * This yields reproducible frames which can optionally be written to disk (PPM) in
+ * order to compare them against reference images. In addition to that the time
+ * spent per frame is measured and reported.
+ *
+ * Note: this class is only functional when compiled with \c HAVE_OSMESA defined
+ * (see the \c headless make target). Otherwise \ref initialize() always fails.
+ *
+ * \author Oliver Bock\n
+ * Max-Planck-Institute for Gravitational Physics\n
+ * Hannover, Germany
+ */
+class HeadlessRenderer
+{
+public:
+	/// Default constructor
+	HeadlessRenderer();
+
+	/// Destructor
+	virtual ~HeadlessRenderer();
+
+	/**
+	 * \brief Initializes the offscreen OpenGL context
+	 *
+	 * Call this method first (after instantiation) to prepare the frame buffer
+	 * and make the offscreen context current.
+	 *
+	 * \param width The width of the frame buffer
+	 * \param height The height of the frame buffer
+	 *
+	 * \return TRUE if successful, otherwise FALSE
+	 */
+	bool initialize(const int width = 800, const int height = 600);
+
+	/**
+	 * \brief Renders a sequence of frames using a fixed clock
+	 *
+	 * The engine's BOINC information is refreshed once per (simulated) second,
+	 * just like \ref WindowManager::eventLoop() does in real time.
+	 *
+	 * \param engine The graphics engine to be used (must be initialized already)
+	 * \param frameCount The number of frames to render
+	 * \param startTime The time of the first frame in "seconds since the Epoch"
+	 * \param frameInterval The (simulated) time between two frames in seconds
+	 * \param dumpPrefix The file name prefix of the PPM frame dumps (no dumps when empty)
+	 *
+	 * \return TRUE if successful, otherwise FALSE
+	 */
+	bool renderFrames(AbstractGraphicsEngine *engine,
+					  const int frameCount,
+					  const double startTime,
+					  const double frameInterval,
+					  const string dumpPrefix = "");
+
+	/**
+	 * \brief Writes the current frame buffer content to a binary PPM (P6) file
+	 *
+	 * \param filename The name of the file to be written
+	 *
+	 * \return TRUE if successful, otherwise FALSE
+	 */
+	bool writeFrame(const string filename) const;
+
+	/**
+	 * \brief Retrieve the frame buffer's width
+	 *
+	 * \return The frame buffer width
+	 */
+	int windowWidth() const;
+
+	/**
+	 * \brief Retrieve the frame buffer's height
+	 *
+	 * \return The frame buffer height
+	 */
+	int windowHeight() const;
+
+private:
+	/// The frame buffer's width
+	int m_Width;
+
+	/// The frame buffer's height
+	int m_Height;
+
+	/// The frame buffer (RGBA, top row first)
+	vector<unsigned char> m_FrameBuffer;
+
+#ifdef HAVE_OSMESA
+	/// The offscreen OpenGL context
+	OSMesaContext m_Context;
+#endif
+};
+
+/**
+ * @}
+ */
+
+#endif /*HEADLESSRENDERER_H_*/
@@ -21,111 +21,144 @@
 #include "Libxml2Adapter.h"
 
 #include <iostream>
-#include <sstream>
-
-#include <libxml/xpath.h>
 
 Libxml2Adapter::Libxml2Adapter()
 {
 	m_xmlDocument = NULL;
+	m_xpathContext = NULL;
 }
 
 Libxml2Adapter::~Libxml2Adapter()
 {
-	if(m_xmlDocument) xmlFreeDoc(m_xmlDocument);
+	freeXmlDocument();
+
+	for(size_t i = 0; i < m_xpathExpressions.size(); ++i) {
+		xmlXPathFreeCompExpr(m_xpathExpressions[i]);
+	}
+
 	xmlCleanupParser();
 }
 
 void Libxml2Adapter::setXmlDocument(const string xml, const string url)
 {
-	xmlDocPtr doc = xmlReadMemory(xml.c_str(), xml.size(), url.c_str(), NULL, 0);
-	if(doc) {
-		m_xmlDocument = doc;
-	}
-	else {
+	freeXmlDocument();
+
+	m_xmlDocument = xmlReadMemory(xml.c_str(), xml.size(), url.c_str(), NULL, 0);
+	if(!m_xmlDocument) {
 		cerr << "Document couldn't be parsed!" << endl;
 	}
 }
 
+void Libxml2Adapter::freeXmlDocument()
+{
+	if(m_xpathContext) xmlXPathFreeContext(m_xpathContext);
+	if(m_xmlDocument) xmlFreeDoc(m_xmlDocument);
+
+	m_xpathContext = NULL;
+	m_xmlDocument = NULL;
+}
+
 string Libxml2Adapter::getSingleNodeContentByXPath(const string xpath)
 {
 	// no document available!
 	if(!m_xmlDocument) return("");
 
+	const int query = compileXPath(xpath);
+	if(query < 0) return("");
+
 	string result = "";
+	const int size = evaluateXPath(query, result);
 
-	// prepare xpath context
-    xmlXPathContextPtr xpathCtx = xmlXPathNewContext(m_xmlDocument);
-    if(xpathCtx == NULL) {
-    	cerr << "Error getting XPath context!" << endl;
-    	return("");
-    }
-
-    // prepare xpath expression
-    xmlChar* xpathExpr = xmlCharStrdup(xpath.c_str());
-    if(xpathExpr == NULL) {
-    	cerr << "Error preparing XPath expression: " << xpath << endl;
-    	xmlXPathFreeContext(xpathCtx);
-    	return("");
-    }
-
-    // run xpath query
-    xmlXPathObjectPtr xpathObj = xmlXPathEvalExpression(xpathExpr, xpathCtx);
-    if(xpathObj == NULL) {
-    	cerr << "Error evaluating XPath expression: " << xpath << endl;
-    	xmlFree(xpathExpr);
-    	xmlXPathFreeContext(xpathCtx);
-    	return("");
-    }
-
-    // retrieve node set returned by xpath query
-    xmlNodeSetPtr nodes = xpathObj->nodesetval;
-
-    // how many nodes did we find?
-    int size = (nodes) ? nodes->nodeNr : 0;
-
-    if(size <= 0) {
-    	cerr << "No node found using XPath expression: " << xpath << endl;
-    	result = "";
-    }
-    else if(size > 1) {
-    	cerr << "More than node found using XPath expression: " << xpath << endl;
-    	result = "";
-    }
-    else {
-		// prepare conversion stream
-		ostringstream converter;
-		converter.exceptions(ios_base::badbit | ios_base::failbit);
+	if(size <= 0) {
+		cerr << "No node found using XPath expression: " << xpath << endl;
+	}
+	else if(size > 1) {
+		cerr << "More than node found using XPath expression: " << xpath << endl;
+	}
 
-		// get xml content
-		xmlChar* nodeContent = xmlNodeListGetString(m_xmlDocument, nodes->nodeTab[0]->xmlChildrenNode, 1);
+	return(result);
+}
 
-		try {
-			// convert xml contents
-			converter << nodeContent;
-			result = converter.str();
-		}
-		catch(ios_base::failure) {
-			cerr << "Error converting XPath node content!" << endl;
-			result = "";
-		}
+string Libxml2Adapter::getSingleNodeContentByXPath(const string xml, const string url, const string xpath)
+{
+	setXmlDocument(xml, url);
+	return(getSingleNodeContentByXPath(xpath));
+}
 
-		// clean up
-		xmlFree(nodeContent);
-    }
+int Libxml2Adapter::compileXPath(const string xpath)
+{
+	// already compiled?
+	map<string, int>::const_iterator handle = m_xpathHandles.find(xpath);
+	if(handle != m_xpathHandles.end()) return handle->second;
+
+	xmlXPathCompExprPtr expression = xmlXPathCompile(BAD_CAST(xpath.c_str()));
+	if(expression == NULL) {
+		cerr << "Error compiling XPath expression: " << xpath << endl;
+		return -1;
+	}
 
-    // clean up
-    xmlFree(xpathExpr);
-    xmlXPathFreeObject(xpathObj);
-    xmlXPathFreeContext(xpathCtx);
+	m_xpathExpressions.push_back(expression);
+	m_xpathHandles[xpath] = m_xpathExpressions.size() - 1;
 
-    return(result);
+	return m_xpathExpressions.size() - 1;
 }
 
-string Libxml2Adapter::getSingleNodeContentByXPath(const string xml, const string url, const string xpath)
+bool Libxml2Adapter::getNodeContentsByXPath(const vector<int> &queries, vector<string> &results)
 {
-	setXmlDocument(xml, url);
-	return(getSingleNodeContentByXPath(xpath));
+	results.assign(queries.size(), "");
+
+	// no document available!
+	if(!m_xmlDocument) return false;
+
+	string content;
+	for(size_t i = 0; i < queries.size(); ++i) {
+		if(evaluateXPath(queries[i], content) == 1) {
+			results[i] = content;
+		}
+	}
+
+	return true;
 }
 
+int Libxml2Adapter::evaluateXPath(const int query, string &result)
+{
+	result = "";
+
+	if(query < 0 || query >= (int) m_xpathExpressions.size()) return 0;
+
+	// prepare xpath context (shared by all queries of the current document)
+	if(!m_xpathContext) {
+		m_xpathContext = xmlXPathNewContext(m_xmlDocument);
+		if(m_xpathContext == NULL) {
+			cerr << "Error getting XPath context!" << endl;
+			return 0;
+		}
+	}
+
+	// run xpath query
+	xmlXPathObjectPtr xpathObj = xmlXPathCompiledEval(m_xpathExpressions[query], m_xpathContext);
+	if(xpathObj == NULL) {
+		cerr << "Error evaluating compiled XPath expression!" << endl;
+		return 0;
+	}
 
+	// retrieve node set returned by xpath query
+	xmlNodeSetPtr nodes = xpathObj->nodesetval;
+
+	// how many nodes did we find?
+	const int size = (nodes) ? nodes->nodeNr : 0;
+
+	if(size == 1) {
+		// get xml content
+		xmlChar* nodeContent = xmlNodeListGetString(m_xmlDocument, nodes->nodeTab[0]->xmlChildrenNode, 1);
+		if(nodeContent) {
+			result = (const char*) nodeContent;
+			xmlFree(nodeContent);
+		}
+	}
+
+	// clean up
+	xmlXPathFreeObject(xpathObj);
+
+	return size;
+}
@@ -22,10 +22,13 @@
 #define LIBXML2ADAPTER_H_
 
 #include <string>
+#include <vector>
+#include <map>
 
 #include "XMLProcessorInterface.h"
 
 #include <libxml/parser.h>
+#include <libxml/xpath.h>
 
 using namespace std;
 
@@ -59,6 +62,9 @@ public:
 	/**
 	 * \brief Sets the XML document to be processed
 	 *
+	 * The previous document (and its XPath context) is released. If the new document
+	 * can't be parsed there's no current document afterwards.
+	 *
 	 * \param xml The XML document to be used for processing
 	 * \param url The base URL of the document
 	 */
@@ -94,9 +100,54 @@ public:
 	 */
 	string getSingleNodeContentByXPath(const string xml, const string url, const string xpath);
 
+	/**
+	 * \brief Compiles a XPath expression for repeated use
+	 *
+	 * \param xpath The XPath expression to be compiled
+	 *
+	 * \return The handle of the compiled expression or -1 in case of an error
+	 *
+	 * \see XMLProcessorInterface::compileXPath()
+	 */
+	int compileXPath(const string xpath);
+
+	/**
+	 * \brief Retrieves the contents of several single nodes (elements or attributes) at once
+	 *
+	 * \param queries The handles of the compiled XPath expressions to be evaluated
+	 * \param results Reference to the vector receiving the node contents (same order as \c queries)
+	 *
+	 * \return TRUE if a document is available, otherwise FALSE (all results are empty)
+	 *
+	 * \see XMLProcessorInterface::getNodeContentsByXPath()
+	 */
+	bool getNodeContentsByXPath(const vector<int> &queries, vector<string> &results);
+
 private:
+	/**
+	 * \brief Evaluates a compiled XPath expression against the current document
+	 *
+	 * \param query The handle of the compiled XPath expression
+	 * \param result Reference to the string receiving the node's content
+	 *
+	 * \return The number of nodes found (the content is only retrieved if it's exactly one)
+	 */
+	int evaluateXPath(const int query, string &result);
+
+	/// Releases the current document and its XPath context
+	void freeXmlDocument();
+
 	/// The current XML document instance
 	xmlDocPtr m_xmlDocument;
+
+	/// The XPath context of the current document (created on demand)
+	xmlXPathContextPtr m_xpathContext;
+
+	/// The compiled XPath expressions (index: handle)
+	vector<xmlXPathCompExprPtr> m_xpathExpressions;
+
+	/// The handles of the compiled XPath expressions (key: expression)
+	map<string, int> m_xpathHandles;
 };
 
 /**
@@ -0,0 +1,395 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "PowerSpectrumDecoder.h"
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define POWERSPECTRUMDECODER_X86
+#include <immintrin.h>
+#endif
+
+PowerSpectrumDecoder::CodePath PowerSpectrumDecoder::m_CodePath = PowerSpectrumDecoder::CodePathAuto;
+
+/// Values of hex digits (-1 for invalid characters)
+static const signed char HexValues[256] = {
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, -1, -1, -1, -1, -1, -1,
+	-1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+/// Values of base64 characters (-1 for invalid characters, including padding)
+static const signed char Base64Values[256] = {
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,
+	52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+	-1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+	15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
+	-1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+	41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+#ifdef POWERSPECTRUMDECODER_X86
+
+/**
+ * Converts 16 hex digits into their values (SSE2)
+ *
+ * Returns FALSE if any of them is invalid.
+ */
+__attribute__((target("sse2")))
+static inline bool hexValuesSSE2(const __m128i digits, __m128i &values)
+{
+	// lower case letters (digits are unaffected)
+	const __m128i lower = _mm_or_si128(digits, _mm_set1_epi8(0x20));
+
+	// signed compares are fine: non-ASCII characters are negative, hence out of range
+	const __m128i isDigit = _mm_and_si128(_mm_cmpgt_epi8(digits, _mm_set1_epi8('0' - 1)),
+										  _mm_cmplt_epi8(digits, _mm_set1_epi8('9' + 1)));
+	const __m128i isLetter = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+										   _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+
+	if(_mm_movemask_epi8(_mm_or_si128(isDigit, isLetter)) != 0xFFFF) return false;
+
+	values = _mm_or_si128(_mm_and_si128(isDigit, _mm_sub_epi8(digits, _mm_set1_epi8('0'))),
+						  _mm_and_si128(isLetter, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+
+	return true;
+}
+
+/**
+ * Decodes 32 hex digits into 16 bytes per iteration (SSE2)
+ *
+ * Returns the number of bytes decoded or -1 if the input is invalid.
+ */
+__attribute__((target("sse2")))
+static long decodeHexSSE2(const char *data, const size_t pairs, unsigned char *output)
+{
+	size_t i = 0;
+
+	for(; i + 16 <= pairs; i += 16) {
+		__m128i first, second;
+
+		if(!hexValuesSSE2(_mm_loadu_si128((const __m128i*) (data + 2 * i)), first) ||
+		   !hexValuesSSE2(_mm_loadu_si128((const __m128i*) (data + 2 * i + 16)), second)) {
+			return -1;
+		}
+
+		// 16 bit lanes hold (low digit << 8 | high digit), combine to (high << 4 | low)
+		const __m128i mask = _mm_set1_epi16(0x00FF);
+		first = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(first, mask), 4), _mm_srli_epi16(first, 8));
+		second = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(second, mask), 4), _mm_srli_epi16(second, 8));
+
+		_mm_storeu_si128((__m128i*) (output + i), _mm_packus_epi16(first, second));
+	}
+
+	return (long) i;
+}
+
+/**
+ * Converts 32 hex digits into their values (AVX2)
+ *
+ * Returns FALSE if any of them is invalid.
+ */
+__attribute__((target("avx2")))
+static inline bool hexValuesAVX2(const __m256i digits, __m256i &values)
+{
+	// lower case letters (digits are unaffected)
+	const __m256i lower = _mm256_or_si256(digits, _mm256_set1_epi8(0x20));
+
+	// signed compares are fine: non-ASCII characters are negative, hence out of range
+	const __m256i isDigit = _mm256_andnot_si256(_mm256_cmpgt_epi8(digits, _mm256_set1_epi8('9')),
+												_mm256_cmpgt_epi8(digits, _mm256_set1_epi8('0' - 1)));
+	const __m256i isLetter = _mm256_andnot_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('f')),
+												 _mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)));
+
+	if(_mm256_movemask_epi8(_mm256_or_si256(isDigit, isLetter)) != -1) return false;
+
+	values = _mm256_or_si256(_mm256_and_si256(isDigit, _mm256_sub_epi8(digits, _mm256_set1_epi8('0'))),
+							 _mm256_and_si256(isLetter, _mm256_sub_epi8(lower, _mm256_set1_epi8('a' - 10))));
+
+	return true;
+}
+
+/**
+ * Decodes 64 hex digits into 32 bytes per iteration (AVX2)
+ *
+ * Returns the number of bytes decoded or -1 if the input is invalid.
+ */
+__attribute__((target("avx2")))
+static long decodeHexAVX2(const char *data, const size_t pairs, unsigned char *output)
+{
+	size_t i = 0;
+
+	for(; i + 32 <= pairs; i += 32) {
+		__m256i first, second;
+
+		if(!hexValuesAVX2(_mm256_loadu_si256((const __m256i*) (data + 2 * i)), first) ||
+		   !hexValuesAVX2(_mm256_loadu_si256((const __m256i*) (data + 2 * i + 32)), second)) {
+			return -1;
+		}
+
+		// 16 bit lanes hold (low digit << 8 | high digit), combine to (high << 4 | low)
+		const __m256i mask = _mm256_set1_epi16(0x00FF);
+		first = _mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(first, mask), 4), _mm256_srli_epi16(first, 8));
+		second = _mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(second, mask), 4), _mm256_srli_epi16(second, 8));
+
+		// packing works per 128 bit lane, restore order afterwards
+		const __m256i packed = _mm256_packus_epi16(first, second);
+		_mm256_storeu_si256((__m256i*) (output + i), _mm256_permute4x64_epi64(packed, 0xD8));
+	}
+
+	return (long) i;
+}
+
+/**
+ * Decodes 32 base64 characters into 24 bytes per iteration (AVX2)
+ *
+ * Based on the approach by Wojciech Muła and Daniel Lemire: characters are validated
+ * and translated using nibble lookup tables, then the 6 bit values are merged with
+ * multiply-add instructions. Each iteration stores 32 bytes (only 24 are valid), hence
+ * the output buffer needs 8 bytes of slack. Characters of the input that aren't fully
+ * processed (e.g. padding) are left to the scalar decoder.
+ *
+ * Returns the number of groups of four characters decoded or -1 if the input is invalid.
+ */
+__attribute__((target("avx2")))
+static long decodeBase64AVX2(const char *data, const size_t quads, unsigned char *output)
+{
+	const __m256i lutLow = _mm256_setr_epi8(
+		0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+		0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+	const __m256i lutHigh = _mm256_setr_epi8(
+		0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+		0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+	const __m256i lutRoll = _mm256_setr_epi8(
+		0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+	const __m256i mask2F = _mm256_set1_epi8(0x2F);
+	const __m256i shuffle = _mm256_setr_epi8(
+		2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+		2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+	const __m256i permute = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+
+	size_t i = 0;
+
+	for(; i + 8 <= quads; i += 8) {
+		__m256i characters = _mm256_loadu_si256((const __m256i*) (data + 4 * i));
+
+		// validate
+		const __m256i highNibbles = _mm256_and_si256(_mm256_srli_epi32(characters, 4), mask2F);
+		const __m256i lowNibbles = _mm256_and_si256(characters, mask2F);
+		const __m256i high = _mm256_shuffle_epi8(lutHigh, highNibbles);
+		const __m256i low = _mm256_shuffle_epi8(lutLow, lowNibbles);
+		if(!_mm256_testz_si256(low, high)) return -1;
+
+		// translate to 6 bit values ('/' needs special treatment)
+		const __m256i is2F = _mm256_cmpeq_epi8(characters, mask2F);
+		const __m256i roll = _mm256_shuffle_epi8(lutRoll, _mm256_add_epi8(is2F, highNibbles));
+		characters = _mm256_add_epi8(characters, roll);
+
+		// merge four 6 bit values into three bytes per 32 bit lane
+		const __m256i merged = _mm256_madd_epi16(_mm256_maddubs_epi16(characters, _mm256_set1_epi32(0x01400140)),
+												 _mm256_set1_epi32(0x00011000));
+		const __m256i bytes = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(merged, shuffle), permute);
+
+		_mm256_storeu_si256((__m256i*) (output + 3 * i), bytes);
+	}
+
+	return (long) i;
+}
+
+#endif
+
+bool PowerSpectrumDecoder::decodeHex(const char *data, const size_t length, vector<unsigned char> &result)
+{
+	if(length % 2 || length / 2 > MaxBins) return false;
+
+	const size_t pairs = length / 2;
+	result.resize(pairs);
+	if(pairs == 0) return true;
+
+	unsigned char *output = &result[0];
+	long done = 0;
+
+#ifdef POWERSPECTRUMDECODER_X86
+	switch(hexCodePath()) {
+		case CodePathAVX2:
+			done = decodeHexAVX2(data, pairs, output);
+			break;
+		case CodePathSSE2:
+			done = decodeHexSSE2(data, pairs, output);
+			break;
+		default:
+			break;
+	}
+
+	if(done < 0) return false;
+#endif
+
+	// remainder
+	return decodeHexScalar(data + 2 * done, pairs - done, output + done);
+}
+
+bool PowerSpectrumDecoder::decodeBase64(const char *data, const size_t length, vector<unsigned char> &result)
+{
+	if(length % 4) return false;
+
+	// padding (at most two characters)
+	size_t padding = 0;
+	if(length > 0 && data[length - 1] == '=') ++padding;
+	if(length > 1 && data[length - 2] == '=') ++padding;
+
+	const size_t bins = length / 4 * 3 - padding;
+	if(bins > MaxBins) return false;
+
+	// the last group (possibly padded) is decoded separately
+	const size_t quads = length > 0 ? length / 4 - 1 : 0;
+
+	// vectorised code stores some bytes of slack
+	result.resize(quads * 3 + 8);
+
+	unsigned char *output = &result[0];
+	long done = 0;
+
+#ifdef POWERSPECTRUMDECODER_X86
+	if(base64CodePath() == CodePathAVX2) {
+		done = decodeBase64AVX2(data, quads, output);
+	}
+
+	if(done < 0) return false;
+#endif
+
+	if(!decodeBase64Scalar(data + 4 * done, quads - done, output + 3 * done)) return false;
+
+	result.resize(bins);
+	if(length == 0) return true;
+
+	// last group
+	const char *last = data + length - 4;
+	const int values[4] = {
+		Base64Values[(unsigned char) last[0]],
+		Base64Values[(unsigned char) last[1]],
+		padding < 2 ? Base64Values[(unsigned char) last[2]] : 0,
+		padding < 1 ? Base64Values[(unsigned char) last[3]] : 0
+	};
+
+	if(values[0] < 0 || values[1] < 0 || values[2] < 0 || values[3] < 0) return false;
+
+	const unsigned long group = (values[0] << 18) | (values[1] << 12) | (values[2] << 6) | values[3];
+	unsigned char *tail = &result[0] + quads * 3;
+
+	tail[0] = (unsigned char) (group >> 16);
+	if(padding < 2) tail[1] = (unsigned char) (group >> 8);
+	if(padding < 1) tail[2] = (unsigned char) group;
+
+	return true;
+}
+
+void PowerSpectrumDecoder::setCodePath(const CodePath codePath)
+{
+	m_CodePath = codePath;
+}
+
+PowerSpectrumDecoder::CodePath PowerSpectrumDecoder::hexCodePath()
+{
+#ifdef POWERSPECTRUMDECODER_X86
+	const bool avx2 = __builtin_cpu_supports("avx2");
+	const bool sse2 = __builtin_cpu_supports("sse2");
+
+	switch(m_CodePath) {
+		case CodePathScalar:
+			return CodePathScalar;
+		case CodePathSSE2:
+			if(sse2) return CodePathSSE2;
+			break;
+		default:
+			if(avx2) return CodePathAVX2;
+			if(sse2) return CodePathSSE2;
+			break;
+	}
+#endif
+
+	return CodePathScalar;
+}
+
+PowerSpectrumDecoder::CodePath PowerSpectrumDecoder::base64CodePath()
+{
+#ifdef POWERSPECTRUMDECODER_X86
+	if(m_CodePath != CodePathScalar && m_CodePath != CodePathSSE2 && __builtin_cpu_supports("avx2")) {
+		return CodePathAVX2;
+	}
+#endif
+
+	return CodePathScalar;
+}
+
+bool PowerSpectrumDecoder::decodeHexScalar(const char *data, const size_t pairs, unsigned char *output)
+{
+	for(size_t i = 0; i < pairs; ++i) {
+		const int high = HexValues[(unsigned char) data[2 * i]];
+		const int low = HexValues[(unsigned char) data[2 * i + 1]];
+
+		if((high | low) < 0) return false;
+
+		output[i] = (unsigned char) ((high << 4) | low);
+	}
+
+	return true;
+}
+
+bool PowerSpectrumDecoder::decodeBase64Scalar(const char *data, const size_t quads, unsigned char *output)
+{
+	for(size_t i = 0; i < quads; ++i) {
+		const int a = Base64Values[(unsigned char) data[4 * i]];
+		const int b = Base64Values[(unsigned char) data[4 * i + 1]];
+		const int c = Base64Values[(unsigned char) data[4 * i + 2]];
+		const int d = Base64Values[(unsigned char) data[4 * i + 3]];
+
+		if((a | b | c | d) < 0) return false;
+
+		const unsigned long group = (a << 18) | (b << 12) | (c << 6) | d;
+		output[3 * i] = (unsigned char) (group >> 16);
+		output[3 * i + 1] = (unsigned char) (group >> 8);
+		output[3 * i + 2] = (unsigned char) group;
+	}
+
+	return true;
+}
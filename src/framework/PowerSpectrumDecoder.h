@@ -0,0 +1,145 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef POWERSPECTRUMDECODER_H_
+#define POWERSPECTRUMDECODER_H_
+
+#include <cstddef>
+#include <vector>
+
+using namespace std;
+
+/**
+ * \addtogroup framework Framework
+ * @{
+ */
+
+/**
+ * \brief Decoder for text encoded power spectra (hex or base64)
+ *
+ * The science applications transfer power spectra (one byte per bin) as hex or base64
+ * encoded text. This class decodes them into a caller supplied buffer which is meant
+ * to be reused, hence there are no allocations once its capacity suffices.
+ *
+ * The decoders are vectorised: on x86 CPUs supporting AVX2 or SSE2 (hex) respectively
+ * AVX2 (base64) wide code paths are used, detected at runtime. All other CPUs and the
+ * remainders of the input use the scalar implementation. Any invalid input character
+ * rejects the whole spectrum.
+ *
+ * \author Oliver Bock\n
+ * Max-Planck-Institute for Gravitational Physics\n
+ * Hannover, Germany
+ */
+class PowerSpectrumDecoder
+{
+public:
+	/**
+	 * \brief Available code paths
+	 *
+	 * \see setCodePath()
+	 */
+	enum CodePath {
+		CodePathAuto,
+		CodePathScalar,
+		CodePathSSE2,
+		CodePathAVX2
+	};
+
+	/**
+	 * \brief Decodes a hex encoded spectrum (two digits per bin, upper or lower case)
+	 *
+	 * \param data Pointer to the hex digits
+	 * \param length The number of hex digits (has to be even)
+	 * \param result Reference to the buffer receiving the bins (resized accordingly)
+	 *
+	 * \return TRUE if successful, FALSE if the input is invalid or too large (\c result is undefined)
+	 */
+	static bool decodeHex(const char *data, const size_t length, vector<unsigned char> &result);
+
+	/**
+	 * \brief Decodes a base64 encoded spectrum (RFC 4648, optionally padded)
+	 *
+	 * \param data Pointer to the base64 characters
+	 * \param length The number of base64 characters (without whitespace)
+	 * \param result Reference to the buffer receiving the bins (resized accordingly)
+	 *
+	 * \return TRUE if successful, FALSE if the input is invalid or too large (\c result is undefined)
+	 */
+	static bool decodeBase64(const char *data, const size_t length, vector<unsigned char> &result);
+
+	/**
+	 * \brief Overrides the code path used by the decoders
+	 *
+	 * This is meant for benchmarking and verification. Requesting a code path not
+	 * supported by the CPU falls back to the best supported one.
+	 *
+	 * \param codePath The code path to be used (default: \ref CodePathAuto)
+	 */
+	static void setCodePath(const CodePath codePath);
+
+	/// Maximum number of bins accepted
+	static const size_t MaxBins = 65536;
+
+private:
+	/**
+	 * \brief Determines the code path to be used for the hex decoder
+	 *
+	 * \return The requested code path if supported, otherwise the best supported one
+	 */
+	static CodePath hexCodePath();
+
+	/**
+	 * \brief Determines the code path to be used for the base64 decoder
+	 *
+	 * \return The requested code path if supported, otherwise the best supported one
+	 */
+	static CodePath base64CodePath();
+
+	/**
+	 * \brief Scalar hex decoder
+	 *
+	 * \param data Pointer to the hex digits
+	 * \param pairs The number of digit pairs to decode
+	 * \param output Pointer to the output buffer (\c pairs bytes)
+	 *
+	 * \return TRUE if successful, FALSE if the input is invalid
+	 */
+	static bool decodeHexScalar(const char *data, const size_t pairs, unsigned char *output);
+
+	/**
+	 * \brief Scalar base64 decoder for complete quadruples (no padding)
+	 *
+	 * \param data Pointer to the base64 characters
+	 * \param quads The number of four character groups to decode
+	 * \param output Pointer to the output buffer (3 bytes per group)
+	 *
+	 * \return TRUE if successful, FALSE if the input is invalid
+	 */
+	static bool decodeBase64Scalar(const char *data, const size_t quads, unsigned char *output);
+
+	/// Code path requested via setCodePath()
+	static CodePath m_CodePath;
+};
+
+/**
+ * @}
+ */
+
+#endif /*POWERSPECTRUMDECODER_H_*/
@@ -0,0 +1,178 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+/*
+ * Micro-benchmark and differential check of the PowerSpectrumDecoder code paths.
+ * Random (valid and corrupted) inputs of random lengths are decoded by all code
+ * paths which have to agree with the scalar decoder. Afterwards the throughput
+ * of each code path is measured. Build with "make decoderbenchmark".
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+#include <sys/time.h>
+
+#include "PowerSpectrumDecoder.h"
+
+using namespace std;
+
+static const char HexDigits[] = "0123456789abcdefABCDEF";
+static const char Base64Digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static double timestamp()
+{
+	struct timeval now;
+	gettimeofday(&now, NULL);
+
+	return now.tv_sec + now.tv_usec / 1e6;
+}
+
+static string randomHex(const size_t bins)
+{
+	string result(2 * bins, '0');
+	for(size_t i = 0; i < result.length(); ++i) {
+		result[i] = HexDigits[rand() % 22];
+	}
+
+	return result;
+}
+
+static string randomBase64(const size_t bins)
+{
+	string result((bins + 2) / 3 * 4, 'A');
+	for(size_t i = 0; i < result.length(); ++i) {
+		result[i] = Base64Digits[rand() % 64];
+	}
+
+	// padding (unused bits have to be zero to allow for exact comparison)
+	if(bins % 3 == 1) {
+		result[result.length() - 3] = Base64Digits[(rand() % 4) << 4];
+		result.replace(result.length() - 2, 2, "==");
+	}
+	else if(bins % 3 == 2) {
+		result[result.length() - 2] = Base64Digits[(rand() % 16) << 2];
+		result[result.length() - 1] = '=';
+	}
+
+	return result;
+}
+
+static void corrupt(string &data)
+{
+	if(data.empty() || rand() % 2) return;
+
+	// invalid character somewhere (including non-ASCII) or odd length
+	if(rand() % 4) {
+		data[rand() % data.length()] = (char) (rand() % 256);
+	}
+	else {
+		data.erase(rand() % data.length(), 1);
+	}
+}
+
+static bool decode(const bool base64, const string &data, vector<unsigned char> &result)
+{
+	return base64 ? PowerSpectrumDecoder::decodeBase64(data.data(), data.length(), result)
+				  : PowerSpectrumDecoder::decodeHex(data.data(), data.length(), result);
+}
+
+static bool fuzz(const bool base64, const int rounds)
+{
+	const PowerSpectrumDecoder::CodePath paths[] = {
+		PowerSpectrumDecoder::CodePathSSE2,
+		PowerSpectrumDecoder::CodePathAVX2
+	};
+
+	vector<unsigned char> reference, candidate;
+
+	for(int i = 0; i < rounds; ++i) {
+		const size_t bins = rand() % 2 ? rand() % 300 : rand() % 5000;
+		string data = base64 ? randomBase64(bins) : randomHex(bins);
+		corrupt(data);
+
+		PowerSpectrumDecoder::setCodePath(PowerSpectrumDecoder::CodePathScalar);
+		const bool valid = decode(base64, data, reference);
+
+		for(size_t j = 0; j < sizeof(paths) / sizeof(paths[0]); ++j) {
+			PowerSpectrumDecoder::setCodePath(paths[j]);
+			if(decode(base64, data, candidate) != valid || (valid && candidate != reference)) {
+				cerr << (base64 ? "Base64" : "Hex") << " decoders disagree (" << data.length()
+					 << " characters, code path " << paths[j] << ")!" << endl;
+				return false;
+			}
+		}
+	}
+
+	PowerSpectrumDecoder::setCodePath(PowerSpectrumDecoder::CodePathAuto);
+
+	return true;
+}
+
+static void benchmark(const char *name, const PowerSpectrumDecoder::CodePath path,
+					  const string &hex, const string &base64, const int iterations)
+{
+	vector<unsigned char> result;
+	PowerSpectrumDecoder::setCodePath(path);
+
+	double start = timestamp();
+	for(int i = 0; i < iterations; ++i) {
+		decode(false, hex, result);
+	}
+	const double hexTime = timestamp() - start;
+
+	start = timestamp();
+	for(int i = 0; i < iterations; ++i) {
+		decode(true, base64, result);
+	}
+	const double base64Time = timestamp() - start;
+
+	const double megabytes = (double) result.size() * iterations / (1024.0 * 1024.0);
+
+	cout << setw(8) << name << ": hex " << setw(10) << megabytes / hexTime << " MB/s, base64 "
+		 << setw(10) << megabytes / base64Time << " MB/s" << endl;
+}
+
+int main(int argc, char **argv)
+{
+	const int iterations = argc > 1 ? atoi(argv[1]) : 20000;
+	const size_t bins = argc > 2 ? atoi(argv[2]) : 16384;
+
+	srand(42);
+
+	if(!fuzz(false, 20000) || !fuzz(true, 20000)) {
+		return 1;
+	}
+
+	const string hex = randomHex(bins);
+	const string base64 = randomBase64(bins);
+
+	cout << "Spectrum size: " << bins << " bins, " << iterations << " iterations" << endl;
+	cout << fixed << setprecision(2);
+
+	benchmark("scalar", PowerSpectrumDecoder::CodePathScalar, hex, base64, iterations);
+	benchmark("sse2", PowerSpectrumDecoder::CodePathSSE2, hex, base64, iterations);
+	benchmark("avx2", PowerSpectrumDecoder::CodePathAVX2, hex, base64, iterations);
+
+	return 0;
+}
@@ -20,13 +20,143 @@
 
 #include "Resource.h"
 
-Resource::Resource(const string identifier, const vector<unsigned char>& data) : m_Data(data)
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+ResourceBuffer::ResourceBuffer(const size_t size)
+{
+	m_Data = new unsigned char[size > 0 ? size : 1];
+	m_Size = size;
+	m_References = 1;
+	m_Mapped = false;
+}
+
+ResourceBuffer::ResourceBuffer(unsigned char *mapping, const size_t size)
+{
+	m_Data = mapping;
+	m_Size = size;
+	m_References = 1;
+	m_Mapped = true;
+}
+
+ResourceBuffer::~ResourceBuffer()
+{
+	if(m_Mapped) {
+#ifdef _WIN32
+		UnmapViewOfFile(m_Data);
+#else
+		munmap(m_Data, m_Size);
+#endif
+	}
+	else {
+		delete[] m_Data;
+	}
+}
+
+ResourceBuffer* ResourceBuffer::createMapping(const string filename)
+{
+	void *mapping = NULL;
+	size_t size = 0;
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+							  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(file == INVALID_HANDLE_VALUE) return NULL;
+
+	// packs larger than 4 GB aren't supported (32 bit address space anyway)
+	DWORD fileSizeHigh = 0;
+	const DWORD fileSize = GetFileSize(file, &fileSizeHigh);
+	if(fileSize != INVALID_FILE_SIZE && fileSize > 0 && fileSizeHigh == 0) {
+		size = (size_t) fileSize;
+
+		// the view stays valid after closing the handles
+		HANDLE fileMapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if(fileMapping) {
+			mapping = MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0);
+			CloseHandle(fileMapping);
+		}
+	}
+	CloseHandle(file);
+
+	if(!mapping) return NULL;
+#else
+	const int file = open(filename.c_str(), O_RDONLY);
+	if(file < 0) return NULL;
+
+	struct stat fileStatus;
+	if(fstat(file, &fileStatus) == 0 && fileStatus.st_size > 0 && (unsigned long long) fileStatus.st_size <= (size_t) -1) {
+		size = (size_t) fileStatus.st_size;
+
+		// shared mapping: all processes share the same physical pages (mapping outlives the descriptor)
+		mapping = mmap(NULL, size, PROT_READ, MAP_SHARED, file, 0);
+	}
+	close(file);
+
+	if(!mapping || mapping == MAP_FAILED) return NULL;
+#endif
+
+	return new ResourceBuffer((unsigned char*) mapping, size);
+}
+
+void ResourceBuffer::acquire()
+{
+	++m_References;
+}
+
+void ResourceBuffer::release()
+{
+	if(--m_References == 0) {
+		delete this;
+	}
+}
+
+unsigned char* ResourceBuffer::data()
+{
+	return m_Data;
+}
+
+size_t ResourceBuffer::size() const
+{
+	return m_Size;
+}
+
+Resource::Resource(const string identifier, const unsigned char *data, const size_t size)
 {
 	m_Identifier = identifier;
+	m_Data = data;
+	m_Size = size;
+	m_Buffer = NULL;
+}
+
+Resource::Resource(const string identifier, ResourceBuffer *buffer)
+{
+	m_Identifier = identifier;
+	m_Data = buffer->data();
+	m_Size = buffer->size();
+	m_Buffer = buffer;
+	m_Buffer->acquire();
+}
+
+Resource::Resource(const string identifier, const unsigned char *data, const size_t size, ResourceBuffer *buffer)
+{
+	m_Identifier = identifier;
+	m_Data = data;
+	m_Size = size;
+	m_Buffer = buffer;
+	m_Buffer->acquire();
 }
 
 Resource::~Resource()
 {
+	if(m_Buffer) {
+		m_Buffer->release();
+	}
 }
 
 string Resource::identifier() const
@@ -34,7 +164,12 @@ string Resource::identifier() const
 	return m_Identifier;
 }
 
-const vector<unsigned char>* Resource::data() const
+const unsigned char* Resource::data() const
+{
+	return m_Data;
+}
+
+size_t Resource::size() const
 {
-	return &m_Data;
+	return m_Size;
 }
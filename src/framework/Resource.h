@@ -22,7 +22,7 @@
 #define RESOURCE_H_
 
 #include <string>
-#include <vector>
+#include <cstddef>
 
 using namespace std;
 
@@ -32,11 +32,96 @@ using namespace std;
  */
 
 /**
- * \brief Class that serves as storage container for arbitrary binary data resources
+ * \brief Reference counted data buffer holding a decompressed resource or a resource pack
  *
- * Instances of this class are returned by ResourceFactory and hold any kind of binary data
- * in the guise of a byte value vector identified by a descriptive string. You can access the
- * data using \ref data() and query the identifier using \ref identifier().
+ * The buffer is either allocated on the heap (decompressed resources) or a read-only memory
+ * mapping of a file (resource packs). It's shared between ResourceFactory and all Resource
+ * instances using it and deletes itself as soon as the last reference is released. Reference
+ * counting isn't thread-safe, resources are expected to be created and deleted by the same thread.
+ *
+ * \see Resource
+ * \see ResourceFactory
+ */
+class ResourceBuffer
+{
+public:
+	/**
+	 * \brief Constructor
+	 *
+	 * The buffer is created with a reference count of one (owned by the creator).
+	 *
+	 * \param size The size of the buffer (in bytes)
+	 */
+	ResourceBuffer(const size_t size);
+
+	/**
+	 * \brief Maps the given file into memory (read-only)
+	 *
+	 * The buffer is created with a reference count of one (owned by the creator).
+	 * Its data must not be written to.
+	 *
+	 * \param filename The name of the file to be mapped
+	 *
+	 * \return The new buffer or NULL if the file couldn't be mapped (e.g. doesn't exist)
+	 */
+	static ResourceBuffer* createMapping(const string filename);
+
+	/// Acquires a reference
+	void acquire();
+
+	/// Releases a reference (deletes the buffer when the last one is gone)
+	void release();
+
+	/**
+	 * \brief Retrieve the data of this buffer
+	 *
+	 * \return The base pointer to the data of this buffer
+	 */
+	unsigned char* data();
+
+	/**
+	 * \brief Retrieve the size of this buffer
+	 *
+	 * \return The size of the buffer (in bytes)
+	 */
+	size_t size() const;
+
+private:
+	/// Constructor (file mapping)
+	ResourceBuffer(unsigned char *mapping, const size_t size);
+
+	/// Destructor (use release() instead)
+	~ResourceBuffer();
+
+	/// Copying isn't supported
+	ResourceBuffer(const ResourceBuffer &other);
+
+	/// Assignment isn't supported
+	ResourceBuffer& operator=(const ResourceBuffer &other);
+
+	/// The data of this buffer
+	unsigned char *m_Data;
+
+	/// The size of the data of this buffer
+	size_t m_Size;
+
+	/// The number of references held
+	int m_References;
+
+	/// Indicates whether the data is a file mapping (or heap memory)
+	bool m_Mapped;
+};
+
+/**
+ * \brief Class that provides access to arbitrary binary data resources
+ *
+ * Instances of this class are returned by ResourceFactory and refer to any kind of binary data
+ * identified by a descriptive string. A resource doesn't own (nor copy) its data, it's merely a
+ * view into the compiled-in resource storage which stays valid for the lifetime of the process.
+ * Compressed resources are views into a decompressed ResourceBuffer instead, which is kept alive
+ * as long as the resource exists (even if ResourceFactory evicted it from its cache meanwhile).
+ * You can access the data using \ref data() and \ref size() and query the identifier using
+ * \ref identifier().
  *
  * \see ResourceFactory
  *
@@ -51,9 +136,28 @@ public:
 	 * \brief Constructor
 	 *
 	 * \param identifier The string used to identify this resource
-	 * \param data A vector of byte values used to initialize the resource's data container
+	 * \param data Pointer to the resource's data (not copied, has to outlive the resource)
+	 * \param size The size of the resource's data
+	 */
+	Resource(const string identifier, const unsigned char *data, const size_t size);
+
+	/**
+	 * \brief Constructor
+	 *
+	 * \param identifier The string used to identify this resource
+	 * \param buffer The buffer holding the resource's data (a reference is acquired)
 	 */
-	Resource(const string identifier, const vector<unsigned char>& data);
+	Resource(const string identifier, ResourceBuffer *buffer);
+
+	/**
+	 * \brief Constructor
+	 *
+	 * \param identifier The string used to identify this resource
+	 * \param data Pointer to the resource's data (within the given buffer)
+	 * \param size The size of the resource's data
+	 * \param buffer The buffer holding the resource's data (a reference is acquired)
+	 */
+	Resource(const string identifier, const unsigned char *data, const size_t size, ResourceBuffer *buffer);
 
 	/// Destructor
 	virtual ~Resource();
@@ -66,22 +170,40 @@ public:
 	string identifier() const;
 
 	/**
-	 * \brief Retrieve the data stored in this resource
+	 * \brief Retrieve the data of this resource
 	 *
 	 * The data can be accessed using the constant pointer returned by this method.
-	 * The pointer points to the beginning of a byte value sequence. The length of the
-	 * vector equals the the size of the data content.
+	 * The pointer points to the beginning of a byte value sequence of \ref size() bytes.
+	 *
+	 * \return The base pointer to the data of this resource
+	 */
+	const unsigned char* data() const;
+
+	/**
+	 * \brief Retrieve the size of this resource
 	 *
-	 * \return The base pointer to the data contained in this resource
+	 * \return The size of the data of this resource (in bytes)
 	 */
-	const vector<unsigned char> * data() const;
+	size_t size() const;
 
 private:
+	/// Copying isn't supported (the buffer reference would be released twice)
+	Resource(const Resource &other);
+
+	/// Assignment isn't supported (the buffer reference would be released twice)
+	Resource& operator=(const Resource &other);
+
 	/// The identifer of this resource
 	string m_Identifier;
 
-	/// The data storage container of this resource
-	const vector<unsigned char> m_Data;
+	/// Pointer to the data of this resource (not owned)
+	const unsigned char *m_Data;
+
+	/// The size of the data of this resource
+	size_t m_Size;
+
+	/// The buffer holding the data of this resource (NULL for compiled-in data)
+	ResourceBuffer *m_Buffer;
 };
 
 /**
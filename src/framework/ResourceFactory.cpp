@@ -20,46 +20,291 @@
 
 #include "ResourceFactory.h"
 
-ResourceFactory::ResourceFactory()
+#include <cstring>
+
+ResourceFactory::ResourceFactory(const size_t cacheCapacity)
+{
+	m_CacheCapacity = cacheCapacity;
+	m_CacheSize = 0;
+	m_Pack = NULL;
+	m_PackIndex = NULL;
+	m_PackCount = 0;
+}
+
+ResourceFactory::~ResourceFactory()
 {
+	// release the cache's references (buffers still in use stay alive)
+	map<size_t, CacheEntry>::iterator pos;
+	for(pos = m_Cache.begin(); pos != m_Cache.end(); ++pos) {
+		pos->second.buffer->release();
+	}
+
+	// release the pack's reference (resources still in use keep it mapped)
+	if(m_Pack) {
+		m_Pack->release();
+	}
+}
+
+const Resource* ResourceFactory::createInstance(const string identifier)
+{
+	return createInstance(identifier.c_str());
+}
+
+const Resource* ResourceFactory::createInstance(const char *identifier)
+{
+	// resource packs take precedence
+	if(m_Pack) {
+		const Resource *resource = createPackInstance(identifier);
+		if(resource) return resource;
+	}
+
 	// determine number of resources
-	size_t resourceCount = c_ResourceIndex[0][0];
+	const size_t resourceCount = c_ResourceIndex[0][0];
+	if(resourceCount == 0) return NULL;
+
+	// find slot of requested identifier (perfect hash)
+	const size_t displacement = c_ResourceHashDisplacements[hash(0, identifier) % resourceCount];
+	const size_t i = c_ResourceHashSlots[hash(displacement, identifier) % resourceCount];
+
+	// unknown identifiers hash to arbitrary slots
+	if(strcmp(c_ResourceIdentifiers[i], identifier) != 0) return NULL;
+
+	return createInstance(i);
+}
+
+const Resource* ResourceFactory::createInstance(const size_t index)
+{
+	// check requested index
+	if(index >= c_ResourceIndex[0][0]) return NULL;
+
+	// resource packs take precedence
+	if(m_Pack) {
+		const Resource *resource = createPackInstance(c_ResourceIdentifiers[index]);
+		if(resource) return resource;
+	}
+
+	const string identifier(c_ResourceIdentifiers[index]);
+
+	// uncompressed: create view into storage container
+	if(c_ResourceIndex[index+1][1] == c_ResourceIndex[index+1][2]) {
+		return new Resource(identifier, &c_ResourceStorage[c_ResourceIndex[index+1][0]], c_ResourceIndex[index+1][1]);
+	}
+
+	// compressed: create view into decompressed buffer
+	ResourceBuffer *buffer = decompressedBuffer(index);
+	if(!buffer) {
+		cerr << "Resource \"" << identifier << "\" could not be decompressed!" << endl;
+		return NULL;
+	}
+
+	return new Resource(identifier, buffer);
+}
+
+bool ResourceFactory::loadPack(const string filename)
+{
+	// map pack file (missing packs aren't an error)
+	ResourceBuffer *pack = ResourceBuffer::createMapping(filename);
+	if(!pack) return false;
+
+	if(!validatePack(pack)) {
+		cerr << "Resource pack \"" << filename << "\" is invalid, ignoring it!" << endl;
+		pack->release();
+		return false;
+	}
+
+	// replace previous pack
+	if(m_Pack) {
+		m_Pack->release();
+	}
+
+	const ResourcePack::Header *header = (const ResourcePack::Header*) pack->data();
+	m_Pack = pack;
+	m_PackIndex = (const ResourcePack::Entry*) (pack->data() + header->indexOffset);
+	m_PackCount = header->count;
+
+	return true;
+}
+
+bool ResourceFactory::validatePack(ResourceBuffer *pack)
+{
+	const unsigned char *data = pack->data();
+	const uint64_t size = pack->size();
+
+	// check header
+	if(size < sizeof(ResourcePack::Header)) return false;
+
+	const ResourcePack::Header *header = (const ResourcePack::Header*) data;
+	if(header->magic != ResourcePack::Magic || header->version != ResourcePack::Version) return false;
+	if(header->fileSize != size || header->indexOffset % sizeof(uint64_t) != 0) return false;
+	if(header->indexOffset > size || header->count > (size - header->indexOffset) / sizeof(ResourcePack::Entry)) return false;
 
-	// import each resource into factory cache
-	for(size_t i = 0; i < resourceCount; ++i) {
+	// check index entries (bounds, NUL-terminated identifiers, sort order)
+	const ResourcePack::Entry *index = (const ResourcePack::Entry*) (data + header->indexOffset);
+	for(size_t i = 0; i < header->count; ++i) {
+		if(index[i].nameOffset >= size || index[i].nameLength >= size - index[i].nameOffset) return false;
+		if(data[index[i].nameOffset + index[i].nameLength] != '\0') return false;
+		if(index[i].dataOffset > size || index[i].size > size - index[i].dataOffset) return false;
+		if(i > 0 && strcmp((const char*) data + index[i-1].nameOffset, (const char*) data + index[i].nameOffset) >= 0) return false;
+	}
 
-		// prepare temporary buffer
-		size_t resourceSize = c_ResourceIndex[i+1][1];
-		vector<unsigned char> buffer(resourceSize);
+	return true;
+}
 
-		// extract resource data from storage container
-		for(size_t x = 0; x < resourceSize; ++x) {
+const Resource* ResourceFactory::createPackInstance(const char *identifier)
+{
+	const unsigned char *data = m_Pack->data();
 
-			// use offset and relative position to find the absolute position
-			unsigned char byteValue = c_ResourceStorage[c_ResourceIndex[i+1][0] + x];
+	// find requested identifier (binary search, index is sorted)
+	size_t first = 0;
+	size_t last = m_PackCount;
 
-			// add byte to buffer
-			buffer[x] = byteValue;
+	while(first < last) {
+		const size_t middle = first + (last - first) / 2;
+		const int order = strcmp((const char*) data + m_PackIndex[middle].nameOffset, identifier);
+
+		if(order == 0) {
+			// create view into mapped pack
+			return new Resource(identifier, data + m_PackIndex[middle].dataOffset, m_PackIndex[middle].size, m_Pack);
+		}
+		else if(order < 0) {
+			first = middle + 1;
+		}
+		else {
+			last = middle;
 		}
+	}
 
-		// add buffer to resource map
-		m_ResourceMap[c_ResourceIdentifiers[i]] = buffer;
+	return NULL;
+}
+
+unsigned int ResourceFactory::hash(const unsigned int seed, const char *identifier)
+{
+	// FNV-1a (has to match ResourceCompiler::hash!)
+	unsigned int value = 2166136261U ^ seed;
+
+	for(; *identifier; ++identifier) {
+		value ^= (unsigned char) *identifier;
+		value *= 16777619U;
 	}
+
+	// final avalanche
+	value ^= value >> 16;
+	value *= 0x85ebca6bU;
+	value ^= value >> 13;
+	value *= 0xc2b2ae35U;
+	value ^= value >> 16;
+
+	return value;
 }
 
-ResourceFactory::~ResourceFactory()
+ResourceBuffer* ResourceFactory::decompressedBuffer(const size_t index)
+{
+	// cache hit: mark as most recently used
+	map<size_t, CacheEntry>::iterator pos = m_Cache.find(index);
+	if(pos != m_Cache.end()) {
+		m_CacheUsage.splice(m_CacheUsage.begin(), m_CacheUsage, pos->second.usage);
+		return pos->second.buffer;
+	}
+
+	// cache miss: decompress resource
+	ResourceBuffer *buffer = new ResourceBuffer(c_ResourceIndex[index+1][2]);
+
+	if(!decompress(&c_ResourceStorage[c_ResourceIndex[index+1][0]], c_ResourceIndex[index+1][1],
+				   buffer->data(), buffer->size()))
+	{
+		buffer->release();
+		return NULL;
+	}
+
+	// add to cache (the creator's reference now belongs to the cache)
+	m_CacheUsage.push_front(index);
+
+	CacheEntry entry;
+	entry.buffer = buffer;
+	entry.usage = m_CacheUsage.begin();
+	m_Cache[index] = entry;
+	m_CacheSize += buffer->size();
+
+	evict();
+
+	return buffer;
+}
+
+void ResourceFactory::evict()
 {
+	// keep at least the most recently used entry
+	while(m_CacheSize > m_CacheCapacity && m_CacheUsage.size() > 1) {
+		map<size_t, CacheEntry>::iterator pos = m_Cache.find(m_CacheUsage.back());
+
+		m_CacheSize -= pos->second.buffer->size();
+		pos->second.buffer->release();
+
+		m_Cache.erase(pos);
+		m_CacheUsage.pop_back();
+	}
 }
 
-const Resource* ResourceFactory::createInstance(const string identifier)
+bool ResourceFactory::decompress(const unsigned char *source, const size_t sourceSize,
+								 unsigned char *destination, const size_t destinationSize)
 {
-	Resource *res = NULL;
+	const unsigned char *input = source;
+	const unsigned char *inputEnd = source + sourceSize;
+	unsigned char *output = destination;
+	unsigned char *outputEnd = destination + destinationSize;
 
-	// determine whether the requested identifier exists
-	if(m_ResourceMap.find(identifier) != m_ResourceMap.end()) {
-		// we know the requested resource, create instance
-		res = new Resource(identifier, m_ResourceMap[identifier]);
+	while(input < inputEnd) {
+		// sequence token (upper nibble: literals, lower nibble: match length)
+		const unsigned char token = *input++;
+
+		// literal length (with extension bytes)
+		size_t literals = token >> 4;
+		if(literals == 15) {
+			unsigned char value;
+			do {
+				if(input >= inputEnd) return false;
+				value = *input++;
+				literals += value;
+			} while(value == 255);
+		}
+
+		// copy literals
+		if(literals > (size_t) (inputEnd - input) || literals > (size_t) (outputEnd - output)) return false;
+		memcpy(output, input, literals);
+		input += literals;
+		output += literals;
+
+		// last sequence (literals only)
+		if(input == inputEnd) break;
+
+		// match offset (little endian)
+		if(inputEnd - input < 2) return false;
+		const size_t offset = input[0] | input[1] << 8;
+		input += 2;
+		if(offset == 0 || offset > (size_t) (output - destination)) return false;
+
+		// match length (with extension bytes)
+		size_t length = token & 0x0f;
+		if(length == 15) {
+			unsigned char value;
+			do {
+				if(input >= inputEnd) return false;
+				value = *input++;
+				length += value;
+			} while(value == 255);
+		}
+		length += 4;
+		if(length > (size_t) (outputEnd - output)) return false;
+
+		// copy match (may overlap with the output written by this very copy)
+		const unsigned char *match = output - offset;
+		if(offset >= length) {
+			memcpy(output, match, length);
+			output += length;
+		}
+		else {
+			while(length--) *output++ = *match++;
+		}
 	}
 
-	return res;
+	return output == outputEnd;
 }
@@ -22,10 +22,12 @@
 #define RESOURCEFACTORY_H_
 
 #include <string>
-#include <map>
 #include <iostream>
+#include <map>
+#include <list>
 
 #include "Resource.h"
+#include "ResourcePack.h"
 
 using namespace std;
 
@@ -37,14 +39,29 @@ using namespace std;
 /**
  * \brief This factory instantiates %Resource objects using a given identifier
  *
- * During contruction of the factory object itself it loads all available resources into
- * an internal cache. The user can subsequently request a copy of this resource by specifying
- * it using the resource's identifier.
+ * The user can request a resource by specifying its identifier or its compile-time index
+ * (see the \c CompiledResources namespace in the header generated by the resource compiler).
+ * The returned %Resource objects are lightweight views into the compiled-in storage container,
+ * hence neither the factory nor the resources copy any resource data. Identifiers are looked up
+ * on demand in constant time (minimal perfect hash generated by the resource compiler) without
+ * any string allocation, so there's no startup cost at all.
+ *
+ * Additionally an external resource pack (see ResourcePack) can be loaded via \ref loadPack.
+ * The pack is memory-mapped read-only (shared between all processes using it) and its resources
+ * are served as zero-copy views of the mapping. Pack resources take precedence over compiled-in
+ * resources with the same identifier, which are used as fallback.
  *
- * The resource data is expected to be stored in these three externally linked arrays:
+ * Resources compiled with compression (see ResourceCompiler) are decompressed when they are
+ * requested for the first time. The decompressed data is kept in a cache which is bounded by
+ * its total size and evicts the least recently requested resources first. Evicted data stays
+ * valid for all %Resource instances still referring to it.
+ *
+ * The resource data is expected to be stored in these externally linked arrays:
  * - \ref c_ResourceIdentifiers
  * - \ref c_ResourceIndex
  * - \ref c_ResourceStorage
+ * - \ref c_ResourceHashDisplacements
+ * - \ref c_ResourceHashSlots
  *
  * These arrays are compiled using the Open %Resource Compiler (ORC) which can be found
  * in the \c orc subdirectory.
@@ -59,8 +76,16 @@ using namespace std;
 class ResourceFactory
 {
 public:
-	/// Default constructor
-	ResourceFactory();
+	/// Default capacity of the decompression cache (in bytes)
+	static const size_t DefaultCacheCapacity = 16 * 1024 * 1024;
+
+	/**
+	 * \brief Constructor
+	 *
+	 * \param cacheCapacity The capacity of the decompression cache (in bytes). The most recently
+	 * requested resource is always cached, even if it exceeds the capacity on its own.
+	 */
+	ResourceFactory(const size_t cacheCapacity = DefaultCacheCapacity);
 
 	/// Destructor
 	virtual ~ResourceFactory();
@@ -73,25 +98,155 @@ public:
 	 *
 	 * \param identifier The identifer of the resource to be instantiated
 	 *
-	 * \return A constant pointer to the newly instantiated resource
+	 * \return A constant pointer to the newly instantiated resource (to be deleted by the caller)
 	 * or NULL if the specified resource could not be found
 	 *
 	 * \see ResourceCompiler
 	 */
 	const Resource* createInstance(const string identifier);
 
+	/**
+	 * \brief Loads an external resource pack
+	 *
+	 * The pack file is memory-mapped and validated. A previously loaded pack is replaced
+	 * (resources already created from it stay valid).
+	 *
+	 * \param filename The name of the pack file
+	 *
+	 * \return \c true if the pack was loaded successfully, \c false otherwise (missing or invalid)
+	 *
+	 * \see ResourcePack
+	 */
+	bool loadPack(const string filename);
+
+	/**
+	 * \brief Creates an instance of the requested resource
+	 *
+	 * The identifier has to be the same as the one specified in the \c *.orc file
+	 * used to compile the resources
+	 *
+	 * \param identifier The identifer of the resource to be instantiated
+	 *
+	 * \return A constant pointer to the newly instantiated resource (to be deleted by the caller)
+	 * or NULL if the specified resource could not be found
+	 *
+	 * \see ResourceCompiler
+	 */
+	const Resource* createInstance(const char *identifier);
+
+	/**
+	 * \brief Creates an instance of the requested resource
+	 *
+	 * Use the compile-time constants defined in the header generated by the resource
+	 * compiler (e.g. \c CompiledResources::FontSansSerif), no lookup required.
+	 *
+	 * \param index The index of the resource to be instantiated
+	 *
+	 * \return A constant pointer to the newly instantiated resource (to be deleted by the caller)
+	 * or NULL if the specified index is invalid
+	 *
+	 * \see ResourceCompiler
+	 */
+	const Resource* createInstance(const size_t index);
+
 private:
-	/// Hashtable mapping identifiers to resource data
-	map<string, vector<unsigned char> > m_ResourceMap;
+	/**
+	 * \brief Computes the seeded hash (FNV-1a with final avalanche) of a resource identifier
+	 *
+	 * This has to match ResourceCompiler::hash()!
+	 *
+	 * \param seed The seed to be used
+	 * \param identifier The identifier to be hashed
+	 *
+	 * \return The hash value
+	 */
+	static unsigned int hash(const unsigned int seed, const char *identifier);
+
+	/**
+	 * \brief Creates an instance of a resource from the loaded pack
+	 *
+	 * \param identifier The identifer of the resource to be instantiated
+	 *
+	 * \return A constant pointer to the newly instantiated resource (to be deleted by the caller)
+	 * or NULL if no pack is loaded or the specified resource isn't part of it
+	 */
+	const Resource* createPackInstance(const char *identifier);
+
+	/**
+	 * \brief Validates the header and index of a mapped resource pack
+	 *
+	 * \param pack The mapped pack file
+	 *
+	 * \return \c true if all offsets are in bounds and the index is sorted, \c false otherwise
+	 */
+	static bool validatePack(ResourceBuffer *pack);
+
+	/**
+	 * \brief Retrieves the decompressed data of a resource (using the cache)
+	 *
+	 * \param index The index of the resource
+	 *
+	 * \return The buffer holding the decompressed data (owned by the cache) or NULL on error
+	 */
+	ResourceBuffer* decompressedBuffer(const size_t index);
+
+	/// Evicts the least recently used cache entries until the capacity is met
+	void evict();
+
+	/**
+	 * \brief Decompresses a data block (LZ4 block format)
+	 *
+	 * \param source The compressed data
+	 * \param sourceSize The size of the compressed data
+	 * \param destination The destination buffer
+	 * \param destinationSize The expected size of the decompressed data
+	 *
+	 * \return \c true if the data was decompressed successfully, \c false if it's corrupt
+	 */
+	static bool decompress(const unsigned char *source, const size_t sourceSize,
+						   unsigned char *destination, const size_t destinationSize);
+
+	/// Cache entry of a decompressed resource
+	struct CacheEntry {
+		/// The buffer holding the decompressed data (one reference held by the cache)
+		ResourceBuffer *buffer;
+
+		/// Position of the entry in the usage list
+		list<size_t>::iterator usage;
+	};
+
+	/// The mapped resource pack (NULL if none loaded)
+	ResourceBuffer *m_Pack;
+
+	/// The index of the mapped resource pack
+	const ResourcePack::Entry *m_PackIndex;
+
+	/// The number of resources in the mapped resource pack
+	size_t m_PackCount;
+
+	/// The capacity of the decompression cache (in bytes)
+	size_t m_CacheCapacity;
+
+	/// The total size of all cached buffers (in bytes)
+	size_t m_CacheSize;
+
+	/// Decompressed resources (identified by resource index)
+	map<size_t, CacheEntry> m_Cache;
+
+	/// Resource indices of the cache entries (most recently used first)
+	list<size_t> m_CacheUsage;
 };
 
 /**
  * \brief Declaration of the external list of resource identifiers
  *
+ * The identifiers are sorted in ascending order (as generated by the resource compiler).
+ * Plain C strings are used so the list doesn't need any static initialization.
+ *
  * \todo Does this need to be global?
  * Maybe we should wrap a class around the generated resources?
  */
-extern const string c_ResourceIdentifiers[];
+extern const char * const c_ResourceIdentifiers[];
 
 /**
  * \brief Declaration of the external list of resource indices
@@ -100,12 +255,16 @@ extern const string c_ResourceIdentifiers[];
  * every resource in the storage container. Using these indices you
  * can easily extract a requested resource:
  * -# Offset to the resource
- * -# Length of the resource
+ * -# Length of the resource (as stored)
+ * -# Length of the resource (decompressed)
+ *
+ * A resource is compressed if the two lengths differ. The first row holds
+ * the total amount of resources.
  *
  * \todo Does this need to be global?
  * Maybe we should wrap a class around the generated resources?
  */
-extern const size_t c_ResourceIndex[][2];
+extern const size_t c_ResourceIndex[][3];
 
 /**
  * \brief Declaration of the external resource storage container
@@ -119,6 +278,25 @@ extern const size_t c_ResourceIndex[][2];
  */
 extern const unsigned char c_ResourceStorage[];
 
+/**
+ * \brief Declaration of the external perfect hash bucket displacements
+ *
+ * Every identifier belongs to bucket <code>hash(0, identifier) % count</code>. The bucket's
+ * displacement (seed) then yields its slot: <code>hash(displacement, identifier) % count</code>.
+ *
+ * \see c_ResourceHashSlots
+ */
+extern const size_t c_ResourceHashDisplacements[];
+
+/**
+ * \brief Declaration of the external perfect hash slots
+ *
+ * Every slot contains the index of the resource whose identifier hashes to it.
+ *
+ * \see c_ResourceHashDisplacements
+ */
+extern const size_t c_ResourceHashSlots[];
+
 /**
  * @}
  */
@@ -0,0 +1,110 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef RESOURCEPACK_H_
+#define RESOURCEPACK_H_
+
+#include <stdint.h>
+
+/**
+ * \addtogroup framework Framework
+ * @{
+ */
+
+/**
+ * \brief Binary layout of external resource pack files
+ *
+ * Resource packs are written by the Open %Resource Compiler (<code>orc --pack</code>) and
+ * memory-mapped read-only by ResourceFactory. A pack comprises:
+ * -# A \ref Header (at offset 0)
+ * -# The index: one \ref Entry per resource, sorted by identifier (ascending, byte-wise)
+ * -# The identifiers (NUL-terminated, referenced by the index)
+ * -# The resource data, every blob starting at a multiple of \ref Alignment (page size)
+ *
+ * All offsets are relative to the beginning of the file and all values are stored in the
+ * byte order of the machine that wrote the pack (a foreign byte order fails the \ref Magic check).
+ * Pack resources are never compressed, so they can be served as zero-copy views of the mapping.
+ *
+ * \see ResourceFactory::loadPack
+ * \see ResourceCompiler
+ *
+ * \author Oliver Bock\n
+ * Max-Planck-Institute for Gravitational Physics\n
+ * Hannover, Germany
+ */
+struct ResourcePack
+{
+	/// File signature ("EaHp" in little endian byte order)
+	static const uint32_t Magic = 0x70486145;
+
+	/// Format version
+	static const uint32_t Version = 1;
+
+	/// Alignment of the resource data blobs (in bytes)
+	static const uint64_t Alignment = 4096;
+
+	/// Pack file header
+	struct Header {
+		/// File signature (see \ref Magic)
+		uint32_t magic;
+
+		/// Format version (see \ref Version)
+		uint32_t version;
+
+		/// Number of resources
+		uint32_t count;
+
+		/// Reserved (zero)
+		uint32_t reserved;
+
+		/// Offset of the index
+		uint64_t indexOffset;
+
+		/// Offset of the identifiers
+		uint64_t namesOffset;
+
+		/// Offset of the first data blob
+		uint64_t dataOffset;
+
+		/// Total size of the pack file
+		uint64_t fileSize;
+	};
+
+	/// Index entry describing a single resource
+	struct Entry {
+		/// Offset of the identifier
+		uint64_t nameOffset;
+
+		/// Length of the identifier (excluding the terminating NUL)
+		uint64_t nameLength;
+
+		/// Offset of the resource data
+		uint64_t dataOffset;
+
+		/// Size of the resource data
+		uint64_t size;
+	};
+};
+
+/**
+ * @}
+ */
+
+#endif /*RESOURCEPACK_H_*/
@@ -0,0 +1,132 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef SNAPSHOTBUFFER_H_
+#define SNAPSHOTBUFFER_H_
+
+/**
+ * \addtogroup framework Framework
+ * @{
+ */
+
+/**
+ * \brief Lock-free hand-over of data snapshots between two threads
+ *
+ * %SnapshotBuffer connects exactly one producer thread with exactly one consumer
+ * thread. The producer fills the instance returned by \ref writeBuffer() and makes
+ * it available by calling \ref publish(). The consumer calls \ref acquire() to pick
+ * up the latest published snapshot which is then accessible via \ref readBuffer()
+ * and stays untouched by the producer until the next successful \ref acquire().
+ *
+ * Internally three instances are used: one owned by each thread and one in between.
+ * Both \ref publish() and \ref acquire() exchange their own instance with the one in
+ * between using a single atomic operation, so neither thread ever blocks or sees a
+ * partially written snapshot. Snapshots published faster than they're acquired are
+ * simply superseded.
+ *
+ * Note: the instances are reused, the producer should therefore overwrite all
+ * members of the snapshot (which is what it does when it fills it from scratch).
+ *
+ * \author Oliver Bock\n
+ * Max-Planck-Institute for Gravitational Physics\n
+ * Hannover, Germany
+ */
+template<class T> class SnapshotBuffer
+{
+public:
+	/// Constructor
+	SnapshotBuffer() :
+		m_WriteIndex(0),
+		m_ReadIndex(1),
+		m_SharedIndex(2)
+	{
+	}
+
+	/**
+	 * \brief Retrieve the snapshot instance to be filled (producer only)
+	 *
+	 * \return Reference to the producer's snapshot instance
+	 */
+	T& writeBuffer()
+	{
+		return m_Buffers[m_WriteIndex];
+	}
+
+	/**
+	 * \brief Publishes the snapshot filled via \ref writeBuffer() (producer only)
+	 */
+	void publish()
+	{
+		// make sure the snapshot is complete before it's handed over
+		__sync_synchronize();
+		const int previous = __sync_lock_test_and_set(&m_SharedIndex, m_WriteIndex | FreshFlag);
+		m_WriteIndex = previous & IndexMask;
+	}
+
+	/**
+	 * \brief Picks up the latest published snapshot, if any (consumer only)
+	 *
+	 * \return TRUE if a new snapshot is available via \ref readBuffer(), otherwise FALSE
+	 */
+	bool acquire()
+	{
+		if(!(m_SharedIndex & FreshFlag)) return false;
+
+		const int previous = __sync_lock_test_and_set(&m_SharedIndex, m_ReadIndex);
+		m_ReadIndex = previous & IndexMask;
+
+		return true;
+	}
+
+	/**
+	 * \brief Retrieve the snapshot picked up by the last \ref acquire() (consumer only)
+	 *
+	 * \return Const reference to the consumer's snapshot instance
+	 */
+	const T& readBuffer() const
+	{
+		return m_Buffers[m_ReadIndex];
+	}
+
+private:
+	/// Flag marking a published but not yet acquired snapshot
+	static const int FreshFlag = 0x4;
+
+	/// Mask to extract the instance index
+	static const int IndexMask = 0x3;
+
+	/// The three snapshot instances
+	T m_Buffers[3];
+
+	/// Index of the producer's instance
+	int m_WriteIndex;
+
+	/// Index of the consumer's instance
+	int m_ReadIndex;
+
+	/// Index of the instance in between (plus \ref FreshFlag)
+	volatile int m_SharedIndex;
+};
+
+/**
+ * @}
+ */
+
+#endif /*SNAPSHOTBUFFER_H_*/
@@ -64,7 +64,8 @@ bool WindowManager::initialize(const int width, const int height, const int fram
 	// override optional default values if preferred values are set
 	m_WindowedWidth = preferredWidth != 0 ? preferredWidth : width;
 	m_WindowedHeight = preferredHeight != 0 ? preferredHeight : height;
-	m_RenderEventInterval = 1000.0f / (preferredFrameRate != 0 ? preferredFrameRate : frameRate);
+	m_DefaultFrameRate = frameRate;
+	m_FrameScheduler.setFrameRate(preferredFrameRate != 0 ? preferredFrameRate : frameRate);
 
 	/*
 	 * SDL_ASYNCBLIT - Surface benutzt asynchrone Blits, wenn möglich
@@ -126,7 +127,8 @@ bool WindowManager::initialize(const int width, const int height, const int fram
 	//FIXME: commented out right now as it interferes with the FSAA attributes below!)
 //	SDL_GL_SetAttribute(SDL_GL_ACCELERATED_VISUAL, 1);
 
-	if(m_BoincAdapter->graphicsQualitySetting() == BOINCClientAdapter::HighGraphicsQualitySetting) {
+	m_QualitySetting = m_BoincAdapter->graphicsQualitySetting();
+	if(m_QualitySetting == BOINCClientAdapter::HighGraphicsQualitySetting) {
 		// enable opt-in quality feature FSAA (4x)
 		SDL_GL_SetAttribute(SDL_GL_MULTISAMPLESAMPLES, 4);
 		SDL_GL_SetAttribute(SDL_GL_MULTISAMPLEBUFFERS, 1);
@@ -137,6 +139,8 @@ bool WindowManager::initialize(const int width, const int height, const int fram
 	//SDL_GL_SetAttribute(SDL_GL_BUFFER_SIZE, 32);
 	//SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 24);
 
+	m_FullSceneAntiAliasingAvailable = true;
+
 	// we always start in windowed mode (starting in fullscreen fails with high CPU load!)
 	m_CurrentWidth = m_WindowedWidth;
 	m_CurrentHeight = m_WindowedHeight;
@@ -166,6 +170,7 @@ bool WindowManager::initialize(const int width, const int height, const int fram
 //		SDL_GL_SetAttribute(SDL_GL_ACCELERATED_VISUAL, 0);
 		SDL_GL_SetAttribute(SDL_GL_MULTISAMPLESAMPLES, 0);
 		SDL_GL_SetAttribute(SDL_GL_MULTISAMPLEBUFFERS, 0);
+		m_FullSceneAntiAliasingAvailable = false;
 
 		// TODO: we should override m_BoincAdapter->graphicsQualitySetting() to medium or low!
 		// note, requires to extend starsphere's constructor (uses its own BOINCClientAdapter!)
@@ -191,8 +196,12 @@ void WindowManager::eventLoop()
 	// be sure there's at least one observer!
 	assert(eventObservers.size() > 0);
 
-	// set two main timers (interval in ms)
-	SDL_AddTimer(m_RenderEventInterval, &timerCallbackRenderEvent, NULL);
+	// fetch BOINC information in the background (results are picked up by the update event)
+	// the worker also watches our preferences (BOINC's init data must only be parsed on one thread)
+	BOINCUpdateWorker worker(eventObservers.front(), m_BoincAdapter);
+	worker.start();
+
+	// set BOINC update timer (interval in ms), rendering is paced by the frame scheduler
 	SDL_AddTimer(1000, &timerCallbackBOINCUpdateEvent, NULL);
 
 	// events we don't ignore, hence use
@@ -216,9 +225,131 @@ void WindowManager::eventLoop()
 
 	SDL_Event event;
 
-	while (SDL_WaitEvent(&event) ) {
-		if (event.type == SDL_USEREVENT &&
-			event.user.code == RenderEvent) {
+	m_FrameScheduler.reset();
+
+	bool running = true;
+
+	while (running) {
+		// handle all pending events first (a slow frame must not starve them)
+		while (running && SDL_PollEvent(&event)) {
+			if (event.type == SDL_USEREVENT &&
+				event.user.code == BOINCUpdateEvent) {
+
+				// notify observers (currently exactly one, hence front()) to apply the latest BOINC update
+				eventObservers.front()->refreshBOINCInformation();
+
+				// the preferences are parsed by the worker (the engine picks up its settings on its own)
+				if(worker.acquirePreferences()) {
+					applyPreferences(worker.preferences());
+				}
+			}
+			else if (m_ScreensaverMode &&
+					(event.type == SDL_MOUSEMOTION || event.type == SDL_MOUSEBUTTONDOWN ||
+					 event.type == SDL_KEYDOWN)) {
+
+				// we're in screensaver mode so exit on user input
+				SDL_Quit();
+
+				running = false;
+			}
+			else if (event.motion.state & (SDL_BUTTON(1) | SDL_BUTTON(3)) &&
+					 event.type == SDL_MOUSEMOTION) {
+
+				if (event.motion.state & SDL_BUTTON(1)) {
+					// notify our observers (currently exactly one, hence front())
+					eventObservers.front()->mouseMoveEvent(
+											event.motion.xrel,
+											event.motion.yrel,
+											AbstractGraphicsEngine::MouseButtonLeft);
+				}
+				else if (event.motion.state & SDL_BUTTON(3)) {
+					// notify our observers (currently exactly one, hence front())
+					eventObservers.front()->mouseMoveEvent(
+											event.motion.xrel,
+											event.motion.yrel,
+											AbstractGraphicsEngine::MouseButtonRight);
+				}
+			}
+			else if (event.type == SDL_VIDEORESIZE) {
+				m_CurrentWidth = m_WindowedWidth = event.resize.w;
+				m_CurrentHeight = m_WindowedHeight = event.resize.h;
+
+				// update video mode
+				m_DisplaySurface = SDL_SetVideoMode(
+										m_CurrentWidth,
+										m_CurrentHeight,
+										m_DesktopBitsPerPixel,
+										m_VideoModeFlags);
+
+				// notify our observers (currently exactly one, hence front())
+				// (windoze needs to be reinitialized instead of just resized, oh well)
+				/// \todo Can we determine the host OS? On X11 a resize() is sufficient!
+				eventObservers.front()->initialize(m_CurrentWidth, m_CurrentHeight, 0, true);
+			}
+			else if (event.type == SDL_QUIT ||
+					(event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_ESCAPE)) {
+
+				// just exit (SDL_FreeSurface is called automatically)
+				SDL_Quit();
+
+				running = false;
+			}
+			else if (event.type == SDL_KEYDOWN) {
+				switch (event.key.keysym.sym) {
+					// notify our observers (currently exactly one, hence front())
+					case SDLK_s:
+						eventObservers.front()->keyboardPressEvent(AbstractGraphicsEngine::KeyS);
+						break;
+					case SDLK_c:
+						eventObservers.front()->keyboardPressEvent(AbstractGraphicsEngine::KeyC);
+						break;
+					case SDLK_o:
+						eventObservers.front()->keyboardPressEvent(AbstractGraphicsEngine::KeyO);
+						break;
+					case SDLK_x:
+						eventObservers.front()->keyboardPressEvent(AbstractGraphicsEngine::KeyX);
+						break;
+					case SDLK_p:
+						eventObservers.front()->keyboardPressEvent(AbstractGraphicsEngine::KeyP);
+						break;
+					case SDLK_r:
+						eventObservers.front()->keyboardPressEvent(AbstractGraphicsEngine::KeyR);
+						break;
+					case SDLK_g:
+						eventObservers.front()->keyboardPressEvent(AbstractGraphicsEngine::KeyG);
+						break;
+					case SDLK_a:
+						eventObservers.front()->keyboardPressEvent(AbstractGraphicsEngine::KeyA);
+						break;
+					case SDLK_i:
+						eventObservers.front()->keyboardPressEvent(AbstractGraphicsEngine::KeyI);
+						break;
+					case SDLK_l:
+						eventObservers.front()->keyboardPressEvent(AbstractGraphicsEngine::KeyL);
+						break;
+					case SDLK_m:
+						eventObservers.front()->keyboardPressEvent(AbstractGraphicsEngine::KeyM);
+						break;
+					case SDLK_v:
+						eventObservers.front()->keyboardPressEvent(AbstractGraphicsEngine::KeyV);
+						break;
+					case SDLK_w:
+						eventObservers.front()->keyboardPressEvent(AbstractGraphicsEngine::KeyW);
+						break;
+					case SDLK_k:
+						eventObservers.front()->keyboardPressEvent(AbstractGraphicsEngine::KeyK);
+						break;
+					case SDLK_RETURN:
+						toggleFullscreen();
+					default:
+						break;
+				}
+			}
+		}
+
+		if (!running) break;
+
+		if (m_FrameScheduler.isFrameDue()) {
 
 #ifdef DEBUG_VALGRIND
 			// stop after i iterations when running valgrinded
@@ -226,8 +357,23 @@ void WindowManager::eventLoop()
 			if(i < 500) {
 				i++;
 #endif
+				FrameProfiler &profiler = eventObservers.front()->profiler();
+				m_FrameScheduler.frameStarted();
+				profiler.beginFrame();
+
 				// notify our observers (currently exactly one, hence front())
 				eventObservers.front()->render(dtime());
+
+				// the engine only renders into the back buffer
+				profiler.startPhase(FrameProfiler::PhaseSwap);
+				SDL_GL_SwapBuffers();
+				profiler.stopPhase(FrameProfiler::PhaseSwap);
+
+				profiler.endFrame();
+				m_FrameScheduler.frameCompleted();
+
+				// dump profile when requested by signal
+				if(FrameProfiler::isDumpRequested()) profiler.dump();
 #ifdef DEBUG_VALGRIND
 			}
 			else {
@@ -236,104 +382,64 @@ void WindowManager::eventLoop()
 			}
 #endif
 		}
-		else if (event.type == SDL_USEREVENT &&
-				 event.user.code == BOINCUpdateEvent) {
-
-			// notify observers (currently exactly one, hence front()) to fetch a BOINC update
-			eventObservers.front()->refreshBOINCInformation();
+		else {
+			// nothing to do: wait for next frame or event
+			SDL_Delay(m_FrameScheduler.sleepTime());
 		}
-		else if (m_ScreensaverMode &&
-				(event.type == SDL_MOUSEMOTION || event.type == SDL_MOUSEBUTTONDOWN ||
-				 event.type == SDL_KEYDOWN)) {
+	}
 
-			// we're in screensaver mode so exit on user input
-			SDL_Quit();
-		}
-		else if (event.motion.state & (SDL_BUTTON(1) | SDL_BUTTON(3)) &&
-				 event.type == SDL_MOUSEMOTION) {
+	worker.stop();
 
-			if (event.motion.state & SDL_BUTTON(1)) {
-				// notify our observers (currently exactly one, hence front())
-				eventObservers.front()->mouseMoveEvent(
-										event.motion.xrel,
-										event.motion.yrel,
-										AbstractGraphicsEngine::MouseButtonLeft);
-			}
-			else if (event.motion.state & SDL_BUTTON(3)) {
-				// notify our observers (currently exactly one, hence front())
-				eventObservers.front()->mouseMoveEvent(
-										event.motion.xrel,
-										event.motion.yrel,
-										AbstractGraphicsEngine::MouseButtonRight);
+	m_FrameScheduler.report();
+}
+
+void WindowManager::benchmarkLoop(BenchmarkDriver &driver)
+{
+	// be sure there's at least one observer!
+	assert(eventObservers.size() > 0);
+
+	// currently exactly one observer, hence front()
+	AbstractGraphicsEngine *engine = eventObservers.front();
+	FrameProfiler &profiler = engine->profiler();
+
+	SDL_Event event;
+	double lastRefresh = 0.0;
+
+	while (!driver.isFinished()) {
+		// user input would spoil the results, hence only handle quit requests
+		while (SDL_PollEvent(&event)) {
+			if (event.type == SDL_QUIT ||
+				(event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_ESCAPE)) {
+
+				cout << "Benchmark aborted!" << endl;
+				driver.report();
+				return;
 			}
 		}
-		else if (event.type == SDL_VIDEORESIZE) {
-			m_CurrentWidth = m_WindowedWidth = event.resize.w;
-			m_CurrentHeight = m_WindowedHeight = event.resize.h;
-
-			// update video mode
-			m_DisplaySurface = SDL_SetVideoMode(
-									m_CurrentWidth,
-									m_CurrentHeight,
-									m_DesktopBitsPerPixel,
-									m_VideoModeFlags);
-
-			// notify our observers (currently exactly one, hence front())
-			// (windoze needs to be reinitialized instead of just resized, oh well)
-			/// \todo Can we determine the host OS? On X11 a resize() is sufficient!
-			eventObservers.front()->initialize(m_CurrentWidth, m_CurrentHeight, 0, true);
-		}
-		else if (event.type == SDL_QUIT ||
-				(event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_ESCAPE)) {
 
-			// just exit (SDL_FreeSurface is called automatically)
-			SDL_Quit();
+		double timeOfDay = driver.prepareFrame(engine);
 
-			break;
-		}
-		else if (event.type == SDL_KEYDOWN) {
-			switch (event.key.keysym.sym) {
-				// notify our observers (currently exactly one, hence front())
-				case SDLK_s:
-					eventObservers.front()->keyboardPressEvent(AbstractGraphicsEngine::KeyS);
-					break;
-				case SDLK_c:
-					eventObservers.front()->keyboardPressEvent(AbstractGraphicsEngine::KeyC);
-					break;
-				case SDLK_o:
-					eventObservers.front()->keyboardPressEvent(AbstractGraphicsEngine::KeyO);
-					break;
-				case SDLK_x:
-					eventObservers.front()->keyboardPressEvent(AbstractGraphicsEngine::KeyX);
-					break;
-				case SDLK_p:
-					eventObservers.front()->keyboardPressEvent(AbstractGraphicsEngine::KeyP);
-					break;
-				case SDLK_r:
-					eventObservers.front()->keyboardPressEvent(AbstractGraphicsEngine::KeyR);
-					break;
-				case SDLK_g:
-					eventObservers.front()->keyboardPressEvent(AbstractGraphicsEngine::KeyG);
-					break;
-				case SDLK_a:
-					eventObservers.front()->keyboardPressEvent(AbstractGraphicsEngine::KeyA);
-					break;
-				case SDLK_i:
-					eventObservers.front()->keyboardPressEvent(AbstractGraphicsEngine::KeyI);
-					break;
-				case SDLK_l:
-					eventObservers.front()->keyboardPressEvent(AbstractGraphicsEngine::KeyL);
-					break;
-				case SDLK_m:
-					eventObservers.front()->keyboardPressEvent(AbstractGraphicsEngine::KeyM);
-					break;
-				case SDLK_RETURN:
-					toggleFullscreen();
-				default:
-					break;
-			}
+		// simulate the BOINC update timer (1s, synchronously for reproducible results)
+		if (timeOfDay - lastRefresh >= 1.0) {
+			engine->updateBOINCInformation();
+			engine->refreshBOINCInformation();
+			lastRefresh = timeOfDay;
 		}
+
+		double frameStart = FrameProfiler::timestamp();
+		profiler.beginFrame();
+
+		engine->render(timeOfDay);
+
+		profiler.startPhase(FrameProfiler::PhaseSwap);
+		SDL_GL_SwapBuffers();
+		profiler.stopPhase(FrameProfiler::PhaseSwap);
+
+		profiler.endFrame();
+		driver.completeFrame(FrameProfiler::timestamp() - frameStart);
 	}
+
+	driver.report();
 }
 
 void WindowManager::registerEventObserver(AbstractGraphicsEngine *engine)
@@ -347,24 +453,6 @@ void WindowManager::unregisterEventObserver(AbstractGraphicsEngine *engine)
 	eventObservers.remove(engine);
 }
 
-Uint32 WindowManager::timerCallbackRenderEvent(Uint32 interval, void *param)
-{
-	SDL_Event event;
-	SDL_UserEvent userevent;
-
-	userevent.type = SDL_USEREVENT;
-	userevent.code = RenderEvent;
-	userevent.data1 = NULL;
-	userevent.data2 = NULL;
-
-	event.type = SDL_USEREVENT;
-	event.user = userevent;
-
-	SDL_PushEvent(&event);
-
-	return interval;
-}
-
 Uint32 WindowManager::timerCallbackBOINCUpdateEvent(Uint32 interval,
         void *param)
 {
@@ -479,6 +567,27 @@ void WindowManager::toggleFullscreen()
 	eventObservers.front()->initialize(m_CurrentWidth, m_CurrentHeight, 0, true);
 }
 
+void WindowManager::applyPreferences(const BOINCUpdateWorker::PreferencesSnapshot &preferences)
+{
+	// adjust frame rate right away
+	m_FrameScheduler.setFrameRate(preferences.frameRate != 0 ? preferences.frameRate : m_DefaultFrameRate);
+
+	// FSAA is a property of the rendering surface, so it's only (un)set for the next video mode change
+	if(preferences.qualitySetting != m_QualitySetting) {
+		m_QualitySetting = preferences.qualitySetting;
+
+		if(m_FullSceneAntiAliasingAvailable &&
+		   m_QualitySetting == BOINCClientAdapter::HighGraphicsQualitySetting) {
+			SDL_GL_SetAttribute(SDL_GL_MULTISAMPLESAMPLES, 4);
+			SDL_GL_SetAttribute(SDL_GL_MULTISAMPLEBUFFERS, 1);
+		}
+		else {
+			SDL_GL_SetAttribute(SDL_GL_MULTISAMPLESAMPLES, 0);
+			SDL_GL_SetAttribute(SDL_GL_MULTISAMPLEBUFFERS, 0);
+		}
+	}
+}
+
 void WindowManager::setScreensaverMode(const bool enabled)
 {
 	m_ScreensaverMode = enabled;
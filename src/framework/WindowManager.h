@@ -32,6 +32,9 @@
 
 #include "AbstractGraphicsEngine.h"
 #include "BOINCClientAdapter.h"
+#include "BenchmarkDriver.h"
+#include "BOINCUpdateWorker.h"
+#include "FrameScheduler.h"
 
 using namespace std;
 
@@ -106,9 +109,24 @@ public:
 	 *
 	 * Call this method to enter the main window's event loop. All subsequent application
 	 * control is defined here. The method returns when the window is closed or destroyed.
+	 *
+	 * BOINC information is fetched by a \ref BOINCUpdateWorker running in the background
+	 * while the loop is active.
 	 */
 	void eventLoop();
 
+	/**
+	 * \brief The benchmark loop
+	 *
+	 * Call this method instead of \ref eventLoop() to run a scripted benchmark. Frames are
+	 * rendered back-to-back (no render timer) using the synthetic clock, camera path and
+	 * feature changes of the given driver. User input is ignored except for quit requests
+	 * which abort the benchmark. The results are reported when done.
+	 *
+	 * \param driver The benchmark driver to be used
+	 */
+	void benchmarkLoop(BenchmarkDriver &driver);
+
 	/**
 	 * \brief Retrieve the current main window's width
 	 *
@@ -174,27 +192,6 @@ public:
 	void setScreensaverMode(const bool enabled);
 
 private:
-	/**
-	 * \brief Timer callback to trigger render events
-	 *
-	 * This callback is used by a SDL timer registered in \ref eventLoop().
-	 * It creates a \ref RenderEvent which is handled by eventLoop().
-	 * In order to use a constant timer interval, \c interval is
-	 * returned as it was passed.
-	 *
-	 * \param interval The current timer interval
-	 * \param param The user supplied parameter of the timer event
-	 *
-	 * \return The timer interval to be used for the following events
-	 *
-	 * \see eventLoop()
-	 * \see EventCodes
-	 *
-	 * \todo Work around static callback, otherwise we might get event conflicts
-	 * when more than one instance. Maybe we should use a singleton here anyway...
-	 */
-    static Uint32 timerCallbackRenderEvent(Uint32 interval, void *param);
-
 	/**
 	 * \brief Timer callback to trigger BOINC update events
 	 *
@@ -207,7 +204,8 @@ private:
 	 * here where \b all event controlling and propagation takes place. BOINCClientAdapter
 	 * for example is meant to be used \b by an instance receiving this event, not
 	 * actually handling it itself. Thus AbstractGraphicsEngine handles this event
-	 * and \b uses its BOINC adapter accordingly.
+	 * and picks up the information its BOINC adapter fetched in the background
+	 * (see \ref BOINCUpdateWorker).
 	 *
 	 * \param interval The current timer interval
 	 * \param param The user supplied parameter of the timer event
@@ -222,11 +220,33 @@ private:
 	 */
     static Uint32 timerCallbackBOINCUpdateEvent(Uint32 interval, void *param);
 
-    /// Local BOINC adapter instance to read project preferences
+    /**
+     * \brief Applies changed project preferences while the event loop is running
+     *
+     * The frame rate is adjusted right away. A changed quality setting (FSAA) takes
+     * effect with the next video mode change (resize or fullscreen toggle) as it's
+     * a property of the rendering surface.
+     *
+     * \param preferences The changed preferences as published by the BOINC update worker
+     *
+     * \see BOINCUpdateWorker::acquirePreferences()
+     */
+    void applyPreferences(const BOINCUpdateWorker::PreferencesSnapshot &preferences);
+
+    /// Local BOINC adapter instance to read project preferences (owned by the BOINC update worker while the event loop runs)
     BOINCClientAdapter *m_BoincAdapter;
 
-    /// The render event interval (in ms) for invoking the render event observer
-    float m_RenderEventInterval;
+    /// The frame scheduler deciding when to invoke the render event observer
+    FrameScheduler m_FrameScheduler;
+
+    /// The frame rate to be used when the project preferences don't specify one
+    int m_DefaultFrameRate;
+
+    /// The quality setting currently applied to the rendering surface
+    BOINCClientAdapter::GraphicsQualitySetting m_QualitySetting;
+
+    /// Indicator whether FSAA can be used (requires acceleration)
+    bool m_FullSceneAntiAliasingAvailable;
 
     /// The current width of the host's desktop
     int m_DesktopWidth;
@@ -268,11 +288,9 @@ private:
      * \brief The known event codes handled by %eventLoop()
      *
      * \see eventLoop()
-     * \see timerCallbackRenderEvent()
      * \see timerCallbackBOINCUpdateEvent()
      */
     enum EventCodes {
-        RenderEvent,
         BOINCUpdateEvent
     };
 
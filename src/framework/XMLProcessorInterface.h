@@ -22,6 +22,7 @@
 #define XMLPROCESSORINTERFACE_H_
 
 #include <string>
+#include <vector>
 
 using namespace std;
 
@@ -87,6 +88,38 @@ public:
 	 * \return The node's content or NULL in case of an error
 	 */
 	virtual string getSingleNodeContentByXPath(const string xml, const string url, const string xpath) = 0;
+
+	/**
+	 * \brief Compiles a XPath expression for repeated use
+	 *
+	 * Compiled expressions are cached, i.e. compiling the same expression twice returns
+	 * the same handle. They remain valid for the lifetime of the processor and are
+	 * independent of the current document.
+	 *
+	 * \param xpath The XPath expression to be compiled
+	 *
+	 * \return The handle of the compiled expression or -1 in case of an error
+	 *
+	 * \see getNodeContentsByXPath()
+	 */
+	virtual int compileXPath(const string xpath) = 0;
+
+	/**
+	 * \brief Retrieves the contents of several single nodes (elements or attributes) at once
+	 *
+	 * All given pre-compiled XPath expressions are evaluated against the current document
+	 * using a single XPath context. An expression that doesn't identify exactly one node
+	 * (e.g. an optional setting that's missing) yields an empty string.
+	 *
+	 * \param queries The handles of the compiled XPath expressions to be evaluated
+	 * \param results Reference to the vector receiving the node contents (same order as \c queries)
+	 *
+	 * \return TRUE if a document is available, otherwise FALSE (all results are empty)
+	 *
+	 * \see compileXPath()
+	 * \see setXmlDocument()
+	 */
+	virtual bool getNodeContentsByXPath(const vector<int> &queries, vector<string> &results) = 0;
 };
 
 /**
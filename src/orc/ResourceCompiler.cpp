@@ -19,8 +19,15 @@
  ***************************************************************************/
 
 #include "ResourceCompiler.h"
+#include "../framework/ResourcePack.h"
 
 #include <cstdlib>
+#include <cstdio>
+#include <climits>
+#include <cstring>
+#include <cctype>
+#include <algorithm>
+#include <set>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -28,10 +35,14 @@
 #include <stdexcept>
 
 
-ResourceCompiler::ResourceCompiler(const string inputFilename, const string outputFilename)
+ResourceCompiler::ResourceCompiler(const string inputFilename, const string outputFilename,
+                                   const OutputMode outputMode,
+                                   const bool compression)
 {
     m_ResourceSpecFile = inputFilename;
     m_ResourceCodeFile = outputFilename;
+    m_OutputMode = outputMode;
+    m_Compression = compression;
 }
 
 ResourceCompiler::~ResourceCompiler()
@@ -46,17 +57,43 @@ void ResourceCompiler::compile()
     // load the binary files (resource <-> data mapping)
     loadBinaryData();
 
+    // skip regeneration if neither the resources nor the options changed
+    const string manifest = createManifest();
+    if(isUpToDate(manifest)) {
+        cerr << "Resources are up to date: " << m_ResourceCodeFile << endl;
+        return;
+    }
+
+    // forget the previous state until regeneration succeeded
+    remove((m_ResourceCodeFile + ".manifest").c_str());
+
+    // pack files are self-contained (and kept uncompressed for zero-copy access)
+    if(m_OutputMode == PackOutputMode) {
+        if(m_Compression) {
+            cerr << "Pack files are never compressed, ignoring compression option!" << endl;
+        }
+        writePack();
+        writeManifest(manifest);
+        return;
+    }
+
+    // compress the binary data (if requested)
+    if(m_Compression) {
+        compressBinaryData();
+    }
+
+    // store identical payloads only once
+    layoutStorage(1);
+
     // temporary variables
     ostringstream resourceIdentifierInitializer;
     ostringstream resourceIndexInitializer;
-    ostringstream resourceStorageInitializer;
+    ostringstream resourceHashInitializer;
 
     map<string, vector<unsigned char> >::iterator mapPos;
-    vector<unsigned char>::iterator dataPos;
-    size_t currentIndex = 0;
 
     // store total amount of resources
-    resourceIndexInitializer << "{0x" << hex << m_ResourceDataMap.size() << ", 0x0},";
+    resourceIndexInitializer << "{0x" << hex << m_ResourceDataMap.size() << ", 0x0, 0x0},";
 
     // iterate over all resource data mappings we have
     for(mapPos = m_ResourceDataMap.begin(); mapPos != m_ResourceDataMap.end(); ++mapPos) {
@@ -65,16 +102,27 @@ void ResourceCompiler::compile()
         resourceIdentifierInitializer << "\"" << mapPos->first << "\",";
 
         // store data base index
-        resourceIndexInitializer << "{0x" << hex << currentIndex << ",";
-        resourceIndexInitializer << "0x" << hex << mapPos->second.size() << "},";
-        currentIndex += mapPos->second.size();
+        resourceIndexInitializer << "{0x" << hex << m_ResourceOffsetMap[mapPos->first] << ",";
+        resourceIndexInitializer << "0x" << hex << mapPos->second.size() << ",";
+        resourceIndexInitializer << "0x" << hex << m_ResourceSizeMap[mapPos->first] << "},";
+    }
 
-        // iterate over the data content byte by byte
-        for(dataPos = mapPos->second.begin(); dataPos != mapPos->second.end(); ++dataPos) {
-            // store byte value as part of array initializer
-            resourceStorageInitializer << "0x" << hex << (size_t)*dataPos << ",";
-        }
+    // build perfect hash tables (identifier -> index)
+    vector<size_t> displacements;
+    vector<size_t> slots;
+    buildPerfectHash(displacements, slots);
+
+    resourceHashInitializer << "extern const size_t c_ResourceHashDisplacements[] = {" << endl;
+    for(size_t i = 0; i < displacements.size(); ++i) {
+        resourceHashInitializer << (i > 0 ? "," : "") << "0x" << hex << displacements[i];
     }
+    resourceHashInitializer << endl << "};" << endl << endl;
+
+    resourceHashInitializer << "extern const size_t c_ResourceHashSlots[] = {" << endl;
+    for(size_t i = 0; i < slots.size(); ++i) {
+        resourceHashInitializer << (i > 0 ? "," : "") << "0x" << hex << slots[i];
+    }
+    resourceHashInitializer << endl << "};" << endl << endl;
 
     // open the output code file
     ofstream outputFile(m_ResourceCodeFile.c_str(), ios::out);
@@ -88,34 +136,615 @@ void ResourceCompiler::compile()
 
     try {
         // write header
-        outputFile << "#include <string>" << endl << endl;
+        outputFile << "#include <cstddef>" << endl << endl;
 
         // write code file contents (remove trailing commas)
         string output = resourceIdentifierInitializer.str();
-        outputFile << "extern const std::string c_ResourceIdentifiers[] = {" << endl;
+        outputFile << "extern const char * const c_ResourceIdentifiers[] = {" << endl;
         outputFile << output.substr(0, output.length() - 1);
         outputFile << endl << "};" << endl << endl;
 
         output = resourceIndexInitializer.str();
-        outputFile << "extern const size_t c_ResourceIndex[][2] = {" << endl;
+        outputFile << "extern const size_t c_ResourceIndex[][3] = {" << endl;
         outputFile << output.substr(0, output.length() - 1);
         outputFile << endl << "};" << endl << endl;
 
-        output = resourceStorageInitializer.str();
-        outputFile << "extern const unsigned char c_ResourceStorage[] = {" << endl;
-        outputFile << output.substr(0, output.length() - 1);
-        outputFile << endl << "};" << endl << endl;
+        outputFile << resourceHashInitializer.str();
+
+        // write resource data
+        if(m_OutputMode == IncludeBinaryOutputMode) {
+            writeIncludeBinary(outputFile);
+        }
+        else {
+            writeHexInitializer(outputFile);
+        }
+
+        // clean up and close file
+        outputFile.flush();
+        outputFile.close();
     }
     catch(const ios::failure& error) {
         cerr << "Error during output file processing: " << error.what() << endl;
+        remove(m_ResourceCodeFile.c_str());
+        exit(1);
     }
     catch(const std::logic_error& error) {
-            cerr << "Error during output file processing: " << error.what() << endl;
+        cerr << "Error during output file processing: " << error.what() << endl;
+        remove(m_ResourceCodeFile.c_str());
+        exit(1);
+    }
+
+    // write compile-time lookup header
+    writeLookupHeader();
+
+    // remember what we compiled
+    writeManifest(manifest);
+}
+
+unsigned int ResourceCompiler::hash(const unsigned int seed, const string &identifier)
+{
+    // FNV-1a (has to match ResourceFactory::hash!)
+    unsigned int value = 2166136261U ^ seed;
+
+    for(size_t i = 0; i < identifier.length(); ++i) {
+        value ^= (unsigned char) identifier[i];
+        value *= 16777619U;
+    }
+
+    // final avalanche (the low bits of plain FNV-1a barely depend on the seed)
+    value ^= value >> 16;
+    value *= 0x85ebca6bU;
+    value ^= value >> 13;
+    value *= 0xc2b2ae35U;
+    value ^= value >> 16;
+
+    return value;
+}
+
+void ResourceCompiler::buildPerfectHash(vector<size_t> &displacements, vector<size_t> &slots)
+{
+    // hash and displace: the first hash (seed 0) distributes the identifiers into buckets,
+    // each bucket then gets a seed (displacement) that maps its identifiers to free slots
+    const size_t count = m_ResourceDataMap.size();
+
+    // keep the tables non-empty (zero-sized arrays aren't allowed)
+    displacements.assign(count > 0 ? count : 1, 0);
+    slots.assign(count > 0 ? count : 1, 0);
+    if(count == 0) return;
+
+    // assign identifiers (by index) to buckets
+    vector<vector<size_t> > buckets(count);
+    vector<string> identifiers;
+    map<string, vector<unsigned char> >::iterator mapPos;
+
+    for(mapPos = m_ResourceDataMap.begin(); mapPos != m_ResourceDataMap.end(); ++mapPos) {
+        buckets[hash(0, mapPos->first) % count].push_back(identifiers.size());
+        identifiers.push_back(mapPos->first);
+    }
+
+    // place the largest buckets first
+    vector<pair<size_t, size_t> > order;
+    for(size_t i = 0; i < count; ++i) {
+        order.push_back(make_pair(buckets[i].size(), i));
+    }
+    sort(order.rbegin(), order.rend());
+
+    vector<bool> occupied(count, false);
+
+    for(size_t i = 0; i < count && order[i].first > 0; ++i) {
+        const vector<size_t> &bucket = buckets[order[i].second];
+
+        // try seeds until all identifiers of this bucket hit distinct free slots
+        for(unsigned int seed = 1; ; ++seed) {
+            vector<size_t> candidates;
+
+            for(size_t j = 0; j < bucket.size(); ++j) {
+                const size_t slot = hash(seed, identifiers[bucket[j]]) % count;
+                if(occupied[slot] || find(candidates.begin(), candidates.end(), slot) != candidates.end()) {
+                    break;
+                }
+                candidates.push_back(slot);
+            }
+
+            if(candidates.size() == bucket.size()) {
+                for(size_t j = 0; j < bucket.size(); ++j) {
+                    occupied[candidates[j]] = true;
+                    slots[candidates[j]] = bucket[j];
+                }
+                displacements[order[i].second] = seed;
+                break;
+            }
+        }
+    }
+}
+
+string ResourceCompiler::lookupHeaderFilename() const
+{
+    // the header is named after the output code file
+    const size_t extension = m_ResourceCodeFile.rfind('.');
+    const size_t directory = m_ResourceCodeFile.find_last_of("/\\");
+    string headerFilename = m_ResourceCodeFile;
+    if(extension != string::npos && (directory == string::npos || extension > directory)) {
+        headerFilename = m_ResourceCodeFile.substr(0, extension);
+    }
+
+    return headerFilename + ".h";
+}
+
+void ResourceCompiler::writeLookupHeader()
+{
+    map<string, vector<unsigned char> >::iterator mapPos;
+    set<string> symbols;
+    size_t index = 0;
+
+    const string headerFilename = lookupHeaderFilename();
+
+    // open the header file
+    ofstream headerFile(headerFilename.c_str(), ios::out);
+    if(!headerFile) {
+        cerr << "Couldn't open header file \"" <<  headerFilename << "\"!" << endl,
+        exit(1);
+    }
+
+    headerFile << "#ifndef ORC_COMPILED_RESOURCES_H_" << endl;
+    headerFile << "#define ORC_COMPILED_RESOURCES_H_" << endl << endl;
+    headerFile << "// Generated by orc from \"" << m_ResourceSpecFile << "\" - do not edit!" << endl << endl;
+    headerFile << "namespace CompiledResources {" << endl;
+    headerFile << "    enum Index {" << endl;
+
+    for(mapPos = m_ResourceDataMap.begin(); mapPos != m_ResourceDataMap.end(); ++mapPos, ++index) {
+        // turn identifier into a valid symbol
+        string symbol = mapPos->first;
+        for(size_t i = 0; i < symbol.length(); ++i) {
+            if(!isalnum((unsigned char) symbol[i])) symbol[i] = '_';
+        }
+        if(symbol.empty() || isdigit((unsigned char) symbol[0])) {
+            symbol = "_" + symbol;
+        }
+
+        if(!symbols.insert(symbol).second || symbol == "Count") {
+            cerr << "Resource identifier \"" << mapPos->first << "\" can't be used as symbol (duplicate)!" << endl;
+            exit(1);
+        }
+
+        headerFile << "        " << symbol << " = 0x" << hex << index << "," << endl;
+    }
+
+    headerFile << "        Count = 0x" << hex << index << endl;
+    headerFile << "    };" << endl;
+    headerFile << "}" << endl << endl;
+    headerFile << "#endif" << endl;
+
+    headerFile.close();
+    if(!headerFile) {
+        cerr << "Error during header file processing!" << endl,
+        exit(1);
+    }
+}
+
+void ResourceCompiler::writeHexInitializer(ostream &outputFile)
+{
+    static const char digits[] = "0123456789abcdef";
+
+    vector<unsigned char>::const_iterator dataPos;
+    string output;
+    bool first = true;
+
+    outputFile << "extern const unsigned char c_ResourceStorage[] = {" << endl;
+
+    // iterate over all stored (unique) resources
+    for(size_t i = 0; i < m_StorageOrder.size(); ++i) {
+        const vector<unsigned char> &data = m_ResourceDataMap[m_StorageOrder[i]];
+
+        // prepare the whole initializer of this resource at once (no stream formatting per byte)
+        output.clear();
+        output.reserve(5 * data.size());
+
+        // iterate over the data content byte by byte
+        for(dataPos = data.begin(); dataPos != data.end(); ++dataPos) {
+            // store byte value as part of array initializer
+            if(!first) output += ',';
+            output += "0x";
+            if(*dataPos > 0xf) output += digits[*dataPos >> 4];
+            output += digits[*dataPos & 0xf];
+            first = false;
+        }
+
+        outputFile << output;
+    }
+
+    outputFile << endl << "};" << endl << endl;
+}
+
+void ResourceCompiler::writeIncludeBinary(ostream &outputFile)
+{
+    // helper macros resolving the target's symbol prefix and read-only data section
+    outputFile << "#define ORC_STRINGIFY_VALUE(x) #x" << endl;
+    outputFile << "#define ORC_STRINGIFY(x) ORC_STRINGIFY_VALUE(x)" << endl;
+    outputFile << "#define ORC_SYMBOL(name) ORC_STRINGIFY(__USER_LABEL_PREFIX__) #name" << endl << endl;
+    outputFile << "#if defined(__APPLE__)" << endl;
+    outputFile << "#define ORC_SECTION \".const\\n\"" << endl;
+    outputFile << "#define ORC_SYMBOL_TYPE \"\"" << endl;
+    outputFile << "#elif defined(_WIN32)" << endl;
+    outputFile << "#define ORC_SECTION \".section .rdata,\\\"dr\\\"\\n\"" << endl;
+    outputFile << "#define ORC_SYMBOL_TYPE \"\"" << endl;
+    outputFile << "#else" << endl;
+    outputFile << "#define ORC_SECTION \".section .rodata\\n\"" << endl;
+    outputFile << "#define ORC_SYMBOL_TYPE \".type \" ORC_SYMBOL(c_ResourceStorage) \", @object\\n\"" << endl;
+    outputFile << "#endif" << endl << endl;
+
+    // compressed data has to be written to a companion file first
+    const string storageFile = m_Compression ? writeStorageFile() : "";
+
+    // the unique resources are stored consecutively (see layoutStorage)
+    outputFile << "__asm__(" << endl;
+    outputFile << "    ORC_SECTION" << endl;
+    outputFile << "    \".globl \" ORC_SYMBOL(c_ResourceStorage) \"\\n\"" << endl;
+    outputFile << "    ORC_SYMBOL_TYPE" << endl;
+    outputFile << "    \".balign 16\\n\"" << endl;
+    outputFile << "    ORC_SYMBOL(c_ResourceStorage) \":\\n\"" << endl;
+
+    if(!storageFile.empty()) {
+        outputFile << "    \".incbin \\\"" << escapePath(absolutePath(storageFile)) << "\\\"\\n\"" << endl;
+    }
+    else {
+        for(size_t i = 0; i < m_StorageOrder.size(); ++i) {
+            const string &filename = m_ResourceFileMap[m_StorageOrder[i]];
+            outputFile << "    \".incbin \\\"" << escapePath(absolutePath(filename)) << "\\\"\\n\"" << endl;
+        }
+    }
+
+    // terminating byte (the storage must not be empty)
+    outputFile << "    \".byte 0\\n\"" << endl;
+    outputFile << "    \".text\\n\"" << endl;
+    outputFile << ");" << endl << endl;
+}
+
+void ResourceCompiler::writePack()
+{
+    map<string, vector<unsigned char> >::iterator mapPos;
+    const char padding[ResourcePack::Alignment] = {0};
+
+    // store identical payloads only once, every blob starts on a page boundary
+    const uint64_t storageSize = layoutStorage(ResourcePack::Alignment);
+
+    // prepare header and index (identifiers are sorted by the map already)
+    ResourcePack::Header header;
+    vector<ResourcePack::Entry> index;
+
+    header.magic = ResourcePack::Magic;
+    header.version = ResourcePack::Version;
+    header.count = (uint32_t) m_ResourceDataMap.size();
+    header.reserved = 0;
+    header.indexOffset = sizeof(ResourcePack::Header);
+    header.namesOffset = header.indexOffset + m_ResourceDataMap.size() * sizeof(ResourcePack::Entry);
+
+    uint64_t offset = header.namesOffset;
+    for(mapPos = m_ResourceDataMap.begin(); mapPos != m_ResourceDataMap.end(); ++mapPos) {
+        offset += mapPos->first.length() + 1;
+    }
+
+    header.dataOffset = (offset + ResourcePack::Alignment - 1) & ~(ResourcePack::Alignment - 1);
+    header.fileSize = header.dataOffset + storageSize;
+
+    offset = header.namesOffset;
+    for(mapPos = m_ResourceDataMap.begin(); mapPos != m_ResourceDataMap.end(); ++mapPos) {
+        ResourcePack::Entry entry;
+        entry.nameOffset = offset;
+        entry.nameLength = mapPos->first.length();
+        entry.dataOffset = header.dataOffset + m_ResourceOffsetMap[mapPos->first];
+        entry.size = mapPos->second.size();
+        index.push_back(entry);
+        offset += mapPos->first.length() + 1;
     }
 
-    // clean up and clode file
-    outputFile.flush();
-    outputFile.close();
+    // open the pack file
+    ofstream packFile(m_ResourceCodeFile.c_str(), ios::out | ios::binary);
+    if(!packFile) {
+        cerr << "Couldn't open pack file \"" <<  m_ResourceCodeFile << "\"!" << endl,
+        exit(1);
+    }
+
+    // write header, index and identifiers
+    packFile.write((const char*) &header, sizeof(header));
+    if(!index.empty()) {
+        packFile.write((const char*) &index[0], index.size() * sizeof(ResourcePack::Entry));
+    }
+    for(mapPos = m_ResourceDataMap.begin(); mapPos != m_ResourceDataMap.end(); ++mapPos) {
+        packFile.write(mapPos->first.c_str(), mapPos->first.length() + 1);
+    }
+
+    // write stored (unique) data blobs, padded to their aligned offsets
+    packFile.write(padding, header.dataOffset - packFile.tellp());
+
+    for(size_t i = 0; i < m_StorageOrder.size(); ++i) {
+        const vector<unsigned char> &data = m_ResourceDataMap[m_StorageOrder[i]];
+        packFile.write(padding, header.dataOffset + m_ResourceOffsetMap[m_StorageOrder[i]] - packFile.tellp());
+        if(!data.empty()) {
+            packFile.write((const char*) &data[0], data.size());
+        }
+    }
+
+    packFile.close();
+    if(!packFile) {
+        cerr << "Error during pack file processing!" << endl,
+        exit(1);
+    }
+}
+
+uint64_t ResourceCompiler::layoutStorage(const uint64_t alignment)
+{
+    map<string, vector<unsigned char> >::iterator mapPos;
+    multimap<uint64_t, string> payloads;
+    multimap<uint64_t, string>::iterator payloadPos;
+    uint64_t offset = 0;
+
+    m_ResourceOffsetMap.clear();
+    m_StorageOrder.clear();
+
+    for(mapPos = m_ResourceDataMap.begin(); mapPos != m_ResourceDataMap.end(); ++mapPos) {
+        const uint64_t contentHash = hashContent(mapPos->second);
+        bool duplicate = false;
+
+        // look for an identical payload stored already (verify bytes, hashes may collide)
+        for(payloadPos = payloads.lower_bound(contentHash); payloadPos != payloads.upper_bound(contentHash); ++payloadPos) {
+            if(m_ResourceDataMap[payloadPos->second] == mapPos->second) {
+                m_ResourceOffsetMap[mapPos->first] = m_ResourceOffsetMap[payloadPos->second];
+                duplicate = true;
+                cerr << "Resource \"" << mapPos->first << "\" shares its data with \"" << payloadPos->second << "\"" << endl;
+                break;
+            }
+        }
+
+        if(!duplicate) {
+            offset = (offset + alignment - 1) / alignment * alignment;
+            m_ResourceOffsetMap[mapPos->first] = offset;
+            m_StorageOrder.push_back(mapPos->first);
+            payloads.insert(make_pair(contentHash, mapPos->first));
+            offset += mapPos->second.size();
+        }
+    }
+
+    return offset;
+}
+
+uint64_t ResourceCompiler::hashContent(const vector<unsigned char> &data)
+{
+    // FNV-1a (64 bit)
+    uint64_t value = 14695981039346656037ULL;
+
+    for(size_t i = 0; i < data.size(); ++i) {
+        value ^= data[i];
+        value *= 1099511628211ULL;
+    }
+
+    return value;
+}
+
+string ResourceCompiler::createManifest()
+{
+    map<string, vector<unsigned char> >::iterator mapPos;
+    ostringstream manifest;
+
+    // anything that influences the output has to be part of the manifest
+    manifest << "orc-manifest " << ManifestVersion << endl;
+    manifest << "mode " << m_OutputMode << endl;
+    manifest << "compression " << (m_Compression ? 1 : 0) << endl;
+
+    for(mapPos = m_ResourceDataMap.begin(); mapPos != m_ResourceDataMap.end(); ++mapPos) {
+        manifest << "resource " << mapPos->first << "|" << absolutePath(m_ResourceFileMap[mapPos->first]) << "|"
+                 << dec << mapPos->second.size() << "|" << hex << hashContent(mapPos->second) << endl;
+    }
+
+    return manifest.str();
+}
+
+bool ResourceCompiler::isUpToDate(const string &manifest)
+{
+    // all outputs have to exist
+    vector<string> outputs;
+    outputs.push_back(m_ResourceCodeFile);
+    if(m_OutputMode != PackOutputMode) {
+        outputs.push_back(lookupHeaderFilename());
+    }
+    if(m_OutputMode == IncludeBinaryOutputMode && m_Compression) {
+        outputs.push_back(m_ResourceCodeFile + ".dat");
+    }
+
+    for(size_t i = 0; i < outputs.size(); ++i) {
+        ifstream output(outputs[i].c_str(), ios::in | ios::binary);
+        if(!output) return false;
+    }
+
+    // compare previous manifest
+    ifstream manifestFile((m_ResourceCodeFile + ".manifest").c_str(), ios::in | ios::binary);
+    if(!manifestFile) return false;
+
+    ostringstream previousManifest;
+    previousManifest << manifestFile.rdbuf();
+
+    return previousManifest.str() == manifest;
+}
+
+void ResourceCompiler::writeManifest(const string &manifest)
+{
+    const string manifestFilename = m_ResourceCodeFile + ".manifest";
+
+    ofstream manifestFile(manifestFilename.c_str(), ios::out | ios::binary);
+    manifestFile << manifest;
+    manifestFile.close();
+
+    // not fatal, we'd just regenerate everything next time
+    if(!manifestFile) {
+        cerr << "Couldn't write manifest file \"" << manifestFilename << "\"!" << endl;
+        remove(manifestFilename.c_str());
+    }
+}
+
+string ResourceCompiler::writeStorageFile()
+{
+    const string storageFilename = m_ResourceCodeFile + ".dat";
+
+    // open the companion file
+    ofstream storageFile(storageFilename.c_str(), ios::out | ios::binary);
+    if(!storageFile) {
+        cerr << "Couldn't open storage file \"" <<  storageFilename << "\"!" << endl,
+        exit(1);
+    }
+
+    // write all stored (unique) resources
+    for(size_t i = 0; i < m_StorageOrder.size(); ++i) {
+        const vector<unsigned char> &data = m_ResourceDataMap[m_StorageOrder[i]];
+        if(!data.empty()) {
+            storageFile.write((const char*) &data[0], data.size());
+        }
+    }
+
+    storageFile.close();
+    if(!storageFile) {
+        cerr << "Error during storage file processing!" << endl,
+        exit(1);
+    }
+
+    return storageFilename;
+}
+
+void ResourceCompiler::compressBinaryData()
+{
+    map<string, vector<unsigned char> >::iterator mapPos;
+    vector<unsigned char> compressed;
+
+    for(mapPos = m_ResourceDataMap.begin(); mapPos != m_ResourceDataMap.end(); ++mapPos) {
+        // only keep the compressed data if it's actually smaller
+        if(compress(mapPos->second, compressed)) {
+            cerr << "Compressed resource \"" << mapPos->first << "\": "
+                 << mapPos->second.size() << " -> " << compressed.size() << " bytes" << endl;
+            mapPos->second.swap(compressed);
+        }
+    }
+}
+
+bool ResourceCompiler::compress(const vector<unsigned char> &input, vector<unsigned char> &output)
+{
+    // LZ4 block format constraints: the last match has to start at least 12 bytes
+    // before the end of the block, the last 5 bytes are always literals
+    static const size_t MatchStartLimit = 12;
+    static const size_t LastLiterals = 5;
+    static const size_t MinimumMatch = 4;
+    static const size_t MaximumOffset = 65535;
+    static const int HashBits = 16;
+
+    const size_t inputSize = input.size();
+
+    output.clear();
+    if(inputSize <= MatchStartLimit) return false;
+
+    output.reserve(inputSize + inputSize / 255 + 16);
+
+    // hash table of recent positions (+1, zero marks empty slots)
+    vector<size_t> hashTable(1 << HashBits, 0);
+
+    const unsigned char *data = &input[0];
+    const size_t matchLimit = inputSize - MatchStartLimit;
+    size_t anchor = 0;
+    size_t position = 0;
+
+    while(true) {
+        size_t reference = 0;
+        size_t length = 0;
+
+        // find next match
+        while(position < matchLimit) {
+            const unsigned int sequence = data[position] | data[position+1] << 8 |
+                                          data[position+2] << 16 | (unsigned int) data[position+3] << 24;
+            const size_t hash = (sequence * 2654435761U) >> (32 - HashBits);
+            const size_t candidate = hashTable[hash];
+            hashTable[hash] = position + 1;
+
+            if(candidate > 0 && position - (candidate - 1) <= MaximumOffset &&
+               memcmp(data + candidate - 1, data + position, MinimumMatch) == 0)
+            {
+                reference = candidate - 1;
+
+                // extend match (but leave the last literals alone)
+                length = MinimumMatch;
+                while(position + length < inputSize - LastLiterals &&
+                      data[reference + length] == data[position + length])
+                {
+                    ++length;
+                }
+                break;
+            }
+            ++position;
+        }
+
+        // write sequence token (upper nibble: literals, lower nibble: match length)
+        const size_t literals = (length > 0 ? position : inputSize) - anchor;
+        const size_t matchLength = length > 0 ? length - MinimumMatch : 0;
+
+        output.push_back((unsigned char) ((literals < 15 ? literals : 15) << 4 |
+                                          (matchLength < 15 ? matchLength : 15)));
+
+        // write literal length extension and literals
+        if(literals >= 15) {
+            size_t remainder = literals - 15;
+            for(; remainder >= 255; remainder -= 255) output.push_back(255);
+            output.push_back((unsigned char) remainder);
+        }
+        output.insert(output.end(), data + anchor, data + anchor + literals);
+
+        // last sequence (literals only)
+        if(length == 0) break;
+
+        // write match offset (little endian) and match length extension
+        const size_t offset = position - reference;
+        output.push_back((unsigned char) (offset & 0xff));
+        output.push_back((unsigned char) (offset >> 8));
+
+        if(matchLength >= 15) {
+            size_t remainder = matchLength - 15;
+            for(; remainder >= 255; remainder -= 255) output.push_back(255);
+            output.push_back((unsigned char) remainder);
+        }
+
+        position += length;
+        anchor = position;
+    }
+
+    return output.size() < inputSize;
+}
+
+string ResourceCompiler::absolutePath(const string path)
+{
+#ifdef _WIN32
+    char buffer[_MAX_PATH];
+    if(_fullpath(buffer, path.c_str(), _MAX_PATH)) return string(buffer);
+#else
+    char buffer[PATH_MAX];
+    if(realpath(path.c_str(), buffer)) return string(buffer);
+#endif
+
+    return path;
+}
+
+string ResourceCompiler::escapePath(const string path)
+{
+    string result;
+
+    // the path is part of an assembler string within a C++ string literal
+    for(size_t i = 0; i < path.length(); ++i) {
+        if(path[i] == '\\') {
+            result += "/";
+        }
+        else if(path[i] == '"') {
+            result += "\\\\\\\"";
+        }
+        else {
+            result += path[i];
+        }
+    }
+
+    return result;
 }
 
 void ResourceCompiler::parseInputFile()
@@ -157,11 +786,13 @@ void ResourceCompiler::parseInputFile()
     catch(const ios::failure& error) {
         // check stream state for real error
         if(!inputFile.eof()) {
-            cerr << "Error during input file processing: " << error.what();
+            cerr << "Error during input file processing: " << error.what() << endl;
+            exit(1);
         }
     }
     catch(const std::logic_error& error) {
-            cerr << "Error during input file processing: " << error.what() << endl;
+        cerr << "Error during input file processing: " << error.what() << endl;
+        exit(1);
     }
 
     // close input file
@@ -192,16 +823,22 @@ void ResourceCompiler::loadBinaryData()
             //					back_inserter(m_ResourceDataMap[pos->first])
             //			);
 
-            // "copy" ends prematurely, so use the crude way instead
-            char c = 0;
-            while(binaryFile.get(c)) {
-                m_ResourceDataMap[pos->first].push_back(c);
-            }
+            // "copy" ends prematurely, so read the whole file at once instead
+            binaryFile.seekg(0, ios::end);
+            const streamsize size = binaryFile.tellg();
+            binaryFile.seekg(0, ios::beg);
+
+            vector<unsigned char> &data = m_ResourceDataMap[pos->first];
+            data.resize(size);
+            if(size > 0) binaryFile.read((char*) &data[0], size);
+
+            m_ResourceSizeMap[pos->first] = data.size();
         }
         catch(const ios::failure& error) {
             // check stream state for real error
             if(!binaryFile.eof()) {
-                cerr << "Error during binary file processing: " << error.what();
+                cerr << "Error during binary file processing: " << error.what() << endl;
+                exit(1);
             }
         }
 
@@ -24,6 +24,8 @@
 #include <string>
 #include <map>
 #include <vector>
+#include <ostream>
+#include <stdint.h>
 
 using namespace std;
 
@@ -37,7 +39,7 @@ using namespace std;
  *
  * This "compiler" takes a resource specification file, opens and loads the physical
  * files and converts their contents into normal C/C++ source code. The source code
- * comprises three arrays which can be subsequently compiled into object code which is
+ * comprises a few arrays which can be subsequently compiled into object code which is
  * then referenced by ResourceFactory using external linkage.\n
  * \n
  * %Resource specification file format:
@@ -52,10 +54,37 @@ using namespace std;
  * The logical resource name will be used again later. It is the identifier used to request a resource via
  * ResourceFactory::createInstance()
  *
+ * Two output modes are available (see \ref OutputMode): the classic mode writes every byte as part
+ * of a hex array initializer, which is portable but slow to compile for large resources. The
+ * \c .incbin mode only writes the identifiers and the index as C++ code and lets the assembler
+ * include the resource files verbatim (GNU toolchains, ELF/COFF/Mach-O), which takes next to no
+ * time regardless of the resource size. Both modes produce the same symbols.
+ *
+ * Optionally every resource can be compressed (LZ4 block format) if that makes it smaller.
+ * Compressed resources are recorded with their stored and their original size in the index and
+ * are decompressed by ResourceFactory on demand. In \c .incbin mode the stored data is written
+ * to a companion file (output filename + \c .dat) which is then included by the assembler.
+ *
+ * In addition to the source code file a lookup header is written (output filename with \c .h
+ * extension). It defines the index of every resource as compile-time constant in the
+ * \c CompiledResources namespace, to be used with ResourceFactory::createInstance(const size_t).
+ * Runtime lookups by identifier use the minimal perfect hash tables written to the source code file.
+ *
+ * Alternatively the resources can be written to an external pack file (see ResourcePack) which
+ * ResourceFactory memory-maps at runtime. Pack resources override compiled-in resources with the
+ * same identifier, so assets can be added or replaced without rebuilding the application.
+ *
+ * Builds are incremental: a manifest (output filename + \c .manifest) records the options and the
+ * content hash of every resource. If nothing changed since the last run the outputs aren't touched
+ * at all, hence their timestamps don't trigger any recompilation. Resources with identical content
+ * are stored only once in all output modes (their index entries share the same data).
+ *
  * \see ResourceFactory
  * \see ResourceFactory::c_ResourceIdentifiers
  * \see ResourceFactory::c_ResourceIndex
  * \see ResourceFactory::c_ResourceStorage
+ * \see ResourceFactory::c_ResourceHashDisplacements
+ * \see ResourceFactory::c_ResourceHashSlots
  *
  * \author Oliver Bock\n
  * Max-Planck-Institute for Gravitational Physics\n
@@ -64,13 +93,29 @@ using namespace std;
 class ResourceCompiler
 {
 public:
+    /// Available output modes
+    enum OutputMode {
+        /// Resource data is written as hex array initializer (portable)
+        HexInitializerOutputMode,
+
+        /// Resource data is included by the assembler via \c .incbin (GNU toolchains)
+        IncludeBinaryOutputMode,
+
+        /// Resources are written to an external pack file (no source code)
+        PackOutputMode
+    };
+
     /**
      * \brief Constructor
      *
      * \param inputFilename Name of the resource specification file (source, \c *.orc)
      * \param outputFilename Name of the converted recources file (destination, \c *.cpp)
+     * \param outputMode The output mode to be used
+     * \param compression Compress resources (if that makes them smaller)
      */
-    ResourceCompiler(const string inputFilename, const string outputFilename);
+    ResourceCompiler(const string inputFilename, const string outputFilename,
+                     const OutputMode outputMode = HexInitializerOutputMode,
+                     const bool compression = false);
 
     /// Destructor
     virtual ~ResourceCompiler();
@@ -88,6 +133,154 @@ public:
     void compile();
 
 private:
+    /// Manifest format version (increase when the output format changes!)
+    static const int ManifestVersion = 1;
+
+    /**
+     * \brief Writes the resource data as hex array initializer
+     *
+     * \param outputFile The output code file
+     */
+    void writeHexInitializer(ostream &outputFile);
+
+    /**
+     * \brief Writes the resource data as top-level assembler block using \c .incbin
+     *
+     * \param outputFile The output code file
+     */
+    void writeIncludeBinary(ostream &outputFile);
+
+    /**
+     * \brief Builds a minimal perfect hash over the resource identifiers
+     *
+     * Hash and displace: the identifiers are distributed into buckets using \ref hash with seed 0.
+     * Starting with the largest bucket, every bucket is assigned the first seed (displacement)
+     * that maps all its identifiers to distinct and still unused slots.
+     *
+     * \param displacements The seed of every bucket (0 for empty buckets)
+     * \param slots The resource index stored in every slot
+     */
+    void buildPerfectHash(vector<size_t> &displacements, vector<size_t> &slots);
+
+    /**
+     * \brief Computes the seeded hash (FNV-1a with final avalanche) of a resource identifier
+     *
+     * This has to match ResourceFactory::hash()!
+     *
+     * \param seed The seed to be used
+     * \param identifier The identifier to be hashed
+     *
+     * \return The hash value
+     */
+    static unsigned int hash(const unsigned int seed, const string &identifier);
+
+    /// Writes the compile-time lookup header
+    void writeLookupHeader();
+
+    /// Writes all resources into the external pack file (uncompressed)
+    void writePack();
+
+    /**
+     * \brief Assigns storage offsets to all resources, storing identical payloads only once
+     *
+     * Fills \ref m_ResourceOffsetMap and \ref m_StorageOrder.
+     *
+     * \param alignment The alignment of every stored payload (in bytes)
+     *
+     * \return The total size of the storage (in bytes)
+     */
+    uint64_t layoutStorage(const uint64_t alignment);
+
+    /**
+     * \brief Computes the content hash (64 bit FNV-1a) of a resource
+     *
+     * \param data The resource data
+     *
+     * \return The hash value
+     */
+    static uint64_t hashContent(const vector<unsigned char> &data);
+
+    /**
+     * \brief Creates the manifest of the current run
+     *
+     * \return The manifest (options, identifiers, files, sizes and content hashes)
+     */
+    string createManifest();
+
+    /**
+     * \brief Checks whether the outputs of a previous run are still up to date
+     *
+     * \param manifest The manifest of the current run
+     *
+     * \return \c true if all outputs exist and the previous manifest matches, \c false otherwise
+     */
+    bool isUpToDate(const string &manifest);
+
+    /**
+     * \brief Writes the manifest file
+     *
+     * \param manifest The manifest of the current run
+     */
+    void writeManifest(const string &manifest);
+
+    /**
+     * \brief Retrieves the name of the compile-time lookup header
+     *
+     * \return The output filename with \c .h extension
+     */
+    string lookupHeaderFilename() const;
+
+    /**
+     * \brief Writes the resource data into the \c .dat companion file
+     *
+     * \return The name of the companion file
+     */
+    string writeStorageFile();
+
+    /**
+     * \brief Compresses all cached resources which benefit from it
+     *
+     * The compressed data replaces the original data in the local cache, the original
+     * size is recorded separately.
+     *
+     * \see compress
+     */
+    void compressBinaryData();
+
+    /**
+     * \brief Compresses a data block (LZ4 block format)
+     *
+     * This is a simple greedy single-pass compressor. Its output can be decoded by
+     * any LZ4 block decoder (see ResourceFactory).
+     *
+     * \param input The data to be compressed
+     * \param output The compressed data
+     *
+     * \return \c true if the compressed data is smaller than the input, \c false otherwise
+     */
+    static bool compress(const vector<unsigned char> &input, vector<unsigned char> &output);
+
+    /**
+     * \brief Resolves the absolute path of a resource file
+     *
+     * The assembler resolves relative \c .incbin paths relative to its working directory,
+     * which isn't necessarily the one used when running the resource compiler.
+     *
+     * \param path The path to be resolved
+     *
+     * \return The absolute path (or the given path if it can't be resolved)
+     */
+    static string absolutePath(const string path);
+
+    /**
+     * \brief Escapes a path for use within the generated assembler block
+     *
+     * \param path The path to be escaped
+     *
+     * \return The escaped path (forward slashes only)
+     */
+    static string escapePath(const string path);
+
     /**
      * \brief Parses the specified input file
      *
@@ -114,11 +307,26 @@ private:
     /// Path and filename of the converted source code file (destination)
     string m_ResourceCodeFile;
 
+    /// The output mode
+    OutputMode m_OutputMode;
+
+    /// Compression flag
+    bool m_Compression;
+
     /// Mapping between logical and physical resource names
     map<string, string> m_ResourceFileMap;
 
-    /// %Resource cache (identified by logical resource name)
+    /// %Resource cache (identified by logical resource name, possibly compressed)
     map<string, vector<unsigned char> > m_ResourceDataMap;
+
+    /// Original (uncompressed) resource sizes (identified by logical resource name)
+    map<string, size_t> m_ResourceSizeMap;
+
+    /// Storage offsets (identified by logical resource name, shared by identical resources)
+    map<string, uint64_t> m_ResourceOffsetMap;
+
+    /// Logical names of the resources whose data is actually stored (in storage order)
+    vector<string> m_StorageOrder;
 };
 
 /**
@@ -0,0 +1,671 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "StarCatalogCompiler.h"
+#include "../starsphere/StarCatalog.h"
+#include "../starsphere/SkyIndex.h"
+
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <cctype>
+#include <cmath>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+#include <algorithm>
+
+
+const double StarCatalogCompiler::Degree = 3.14159265358979323846 / 180.0;
+
+StarCatalogCompiler::StarCatalogCompiler(const string inputFilename, const string outputFilename,
+                                         const OutputMode outputMode)
+{
+    m_CatalogSpecFile = inputFilename;
+    m_CatalogCodeFile = outputFilename;
+    m_OutputMode = outputMode;
+}
+
+StarCatalogCompiler::~StarCatalogCompiler()
+{
+}
+
+void StarCatalogCompiler::compile()
+{
+    // a single catalog file is converted into an external (tiled) star catalog file
+    if(m_OutputMode == BinaryOutputMode || m_OutputMode == TiledOutputMode) {
+        Catalog catalog;
+        catalog.name = "Stars";
+        catalog.filename = m_CatalogSpecFile;
+        catalog.links = false;
+
+        loadCatalog(catalog);
+
+        if(!catalog.hasMagnitude && !catalog.positions.empty()) {
+            cerr << "Catalog \"" << catalog.filename << "\" doesn't provide magnitudes!" << endl;
+            exit(1);
+        }
+
+        if(m_OutputMode == BinaryOutputMode) {
+            writeBinary(catalog);
+        }
+        else {
+            writeTiles(catalog);
+        }
+        return;
+    }
+
+    // parse the catalog spec file
+    parseInputFile();
+
+    // load and convert the catalogs
+    for(size_t i = 0; i < m_Catalogs.size(); ++i) {
+        loadCatalog(m_Catalogs[i]);
+    }
+
+    // open the output code file
+    ofstream outputFile(m_CatalogCodeFile.c_str(), ios::out);
+    if(!outputFile) {
+        cerr << "Couldn't open output file \"" <<  m_CatalogCodeFile << "\"!" << endl,
+        exit(1);
+    }
+
+    // let's get some exceptions
+    outputFile.exceptions(ios::failbit | ios::badbit);
+
+    try {
+        // write header
+        outputFile << "// Generated by starcat from \"" << m_CatalogSpecFile << "\" - do not edit!" << endl << endl;
+        outputFile << "#include \"StarCatalog.h\"" << endl << endl;
+
+        // write catalogs
+        for(size_t i = 0; i < m_Catalogs.size(); ++i) {
+            writeCatalog(outputFile, m_Catalogs[i]);
+        }
+    }
+    catch(const ios::failure& error) {
+        cerr << "Error during output file processing: " << error.what() << endl;
+        outputFile.close();
+        remove(m_CatalogCodeFile.c_str());
+        exit(1);
+    }
+
+    // close output file
+    outputFile.close();
+}
+
+void StarCatalogCompiler::writeCatalog(ostream &outputFile, const Catalog &catalog)
+{
+    const string prefix = "c_" + catalog.name;
+    const size_t count = catalog.positions.size() / 3;
+
+    // coordinate tables (one per axis)
+    if(count > 0) {
+        const char axes[] = {'X', 'Y', 'Z'};
+        for(size_t axis = 0; axis < 3; ++axis) {
+            outputFile << "static const float " << prefix << axes[axis] << "[] = {" << endl;
+            for(size_t i = 0; i < count; ++i) {
+                outputFile << (i % 8 == 0 ? "" : " ") << floatLiteral(catalog.positions[3 * i + axis]) << ",";
+                if(i % 8 == 7 || i == count - 1) outputFile << endl;
+            }
+            outputFile << "};" << endl << endl;
+        }
+    }
+
+    // optional tables
+    if(count > 0 && catalog.hasMagnitude) {
+        outputFile << "static const float " << prefix << "Magnitude[] = {" << endl;
+        for(size_t i = 0; i < count; ++i) {
+            outputFile << (i % 8 == 0 ? "" : " ") << floatLiteral(catalog.magnitudes[i]) << ",";
+            if(i % 8 == 7 || i == count - 1) outputFile << endl;
+        }
+        outputFile << "};" << endl << endl;
+    }
+
+    if(count > 0 && catalog.hasColour) {
+        outputFile << "static const unsigned int " << prefix << "Colour[] = {" << endl;
+        for(size_t i = 0; i < count; ++i) {
+            outputFile << (i % 8 == 0 ? "" : " ") << "0x" << hex << catalog.colours[i] << dec << ",";
+            if(i % 8 == 7 || i == count - 1) outputFile << endl;
+        }
+        outputFile << "};" << endl << endl;
+    }
+
+    if(!catalog.linkIndices.empty()) {
+        outputFile << "static const unsigned int " << prefix << "Links[] = {" << endl;
+        for(size_t i = 0; i < catalog.linkIndices.size(); ++i) {
+            outputFile << (i % 16 == 0 ? "" : " ") << catalog.linkIndices[i] << ",";
+            if(i % 16 == 15 || i == catalog.linkIndices.size() - 1) outputFile << endl;
+        }
+        outputFile << "};" << endl << endl;
+    }
+
+    // catalog descriptor (see StarCatalog)
+    outputFile << "extern const StarCatalog c_StarCatalog" << catalog.name << " = {" << endl;
+    outputFile << "    " << count << "," << endl;
+    outputFile << "    " << (count > 0 ? prefix + "X" : "NULL") << ","
+               << " " << (count > 0 ? prefix + "Y" : "NULL") << ","
+               << " " << (count > 0 ? prefix + "Z" : "NULL") << "," << endl;
+    outputFile << "    " << (count > 0 && catalog.hasMagnitude ? prefix + "Magnitude" : "NULL") << "," << endl;
+    outputFile << "    " << (count > 0 && catalog.hasColour ? prefix + "Colour" : "NULL") << "," << endl;
+    outputFile << "    " << catalog.linkIndices.size() / 2 << "," << endl;
+    outputFile << "    " << (!catalog.linkIndices.empty() ? prefix + "Links" : "NULL") << endl;
+    outputFile << "};" << endl << endl;
+}
+
+/// Sort order of catalog entries (ascending magnitude)
+struct MagnitudeOrder {
+    MagnitudeOrder(const vector<float> &magnitudes) : m_Magnitudes(magnitudes) {}
+
+    bool operator()(const size_t first, const size_t second) const {
+        return m_Magnitudes[first] < m_Magnitudes[second];
+    }
+
+    const vector<float> &m_Magnitudes;
+};
+
+void StarCatalogCompiler::writeBinary(const Catalog &catalog)
+{
+    const size_t count = catalog.positions.size() / 3;
+    const uint64_t alignment = StarCatalogFile::Alignment;
+    const uint64_t tableSize = (count * sizeof(float) + alignment - 1) / alignment * alignment;
+
+    // brightest entries first (equal magnitudes keep their catalog order)
+    vector<size_t> order(count);
+    for(size_t i = 0; i < count; ++i) order[i] = i;
+    stable_sort(order.begin(), order.end(), MagnitudeOrder(catalog.magnitudes));
+
+    // layout: header followed by the tables
+    StarCatalogFile::Header header;
+    memset(&header, 0, sizeof(header));
+    header.magic = StarCatalogFile::Magic;
+    header.version = StarCatalogFile::Version;
+    header.count = (uint32_t) count;
+    header.xOffset = (sizeof(header) + alignment - 1) / alignment * alignment;
+    header.yOffset = header.xOffset + tableSize;
+    header.zOffset = header.yOffset + tableSize;
+    header.magnitudeOffset = header.zOffset + tableSize;
+    header.colourOffset = catalog.hasColour ? header.magnitudeOffset + tableSize : 0;
+    header.fileSize = header.magnitudeOffset + tableSize + (catalog.hasColour ? tableSize : 0);
+
+    // assemble file contents
+    vector<unsigned char> contents(header.fileSize, 0);
+    memcpy(&contents[0], &header, sizeof(header));
+
+    float *x = (float*) &contents[header.xOffset];
+    float *y = (float*) &contents[header.yOffset];
+    float *z = (float*) &contents[header.zOffset];
+    float *magnitude = (float*) &contents[header.magnitudeOffset];
+    uint32_t *colour = catalog.hasColour ? (uint32_t*) &contents[header.colourOffset] : NULL;
+
+    for(size_t i = 0; i < count; ++i) {
+        x[i] = (float) catalog.positions[3 * order[i]];
+        y[i] = (float) catalog.positions[3 * order[i] + 1];
+        z[i] = (float) catalog.positions[3 * order[i] + 2];
+        magnitude[i] = catalog.magnitudes[order[i]];
+        if(colour) colour[i] = catalog.colours[order[i]];
+    }
+
+    writeOutputFile(contents);
+}
+
+/// Faintest magnitudes of the levels of tiled star catalog files
+static const float TileMagnitudeLimits[SkyTileFile::MaxLevels] = {
+    6.5f, 8.0f, 9.5f, 11.0f, 12.5f, 14.0f, 15.5f, 17.0f
+};
+
+void StarCatalogCompiler::writeTiles(const Catalog &catalog)
+{
+    const size_t count = catalog.positions.size() / 3;
+
+    // brightest entries first (the tiles keep this order)
+    vector<size_t> order(count);
+    for(size_t i = 0; i < count; ++i) order[i] = i;
+    stable_sort(order.begin(), order.end(), MagnitudeOrder(catalog.magnitudes));
+
+    // use as many levels as required, the last one takes all remaining entries
+    const float faintest = count > 0 ? catalog.magnitudes[order[count - 1]] : 0.0f;
+
+    SkyTileFile::Header header;
+    memset(&header, 0, sizeof(header));
+    header.magic = SkyTileFile::Magic;
+    header.version = SkyTileFile::Version;
+    header.levelCount = 1;
+
+    while(header.levelCount < SkyTileFile::MaxLevels && faintest > TileMagnitudeLimits[header.levelCount - 1]) {
+        ++header.levelCount;
+    }
+
+    vector<size_t> levelStart(header.levelCount + 1, 0);
+    for(uint32_t level = 0; level < header.levelCount; ++level) {
+        header.magnitudeLimit[level] = TileMagnitudeLimits[level];
+        levelStart[level + 1] = levelStart[level] + SkyIndex::cellCount(level);
+    }
+    header.magnitudeLimit[header.levelCount - 1] = max(faintest, TileMagnitudeLimits[header.levelCount - 1]);
+
+    // assign the entries to their level and cell
+    const size_t tileCount = levelStart[header.levelCount];
+    vector<uint32_t> tiles(count);
+    vector<size_t> tileStart(tileCount + 1, 0);
+    uint32_t level = 0;
+
+    for(size_t i = 0; i < count; ++i) {
+        const size_t entry = order[i];
+        while(catalog.magnitudes[entry] > header.magnitudeLimit[level]) ++level;
+
+        tiles[i] = levelStart[level] + SkyIndex::cell((float) catalog.positions[3 * entry],
+                                                      (float) catalog.positions[3 * entry + 1],
+                                                      (float) catalog.positions[3 * entry + 2],
+                                                      level);
+        ++tileStart[tiles[i] + 1];
+    }
+
+    // group entries by tile (counting sort, stable)
+    for(size_t i = 0; i < tileCount; ++i) tileStart[i + 1] += tileStart[i];
+
+    vector<size_t> grouped(count);
+    vector<size_t> position(tileStart.begin(), tileStart.end() - 1);
+    for(size_t i = 0; i < count; ++i) {
+        grouped[position[tiles[i]]++] = order[i];
+    }
+
+    // layout: header, index, entries
+    header.indexOffset = (sizeof(header) + sizeof(uint64_t) - 1) / sizeof(uint64_t) * sizeof(uint64_t);
+    const uint64_t dataOffset = header.indexOffset + tileCount * sizeof(SkyTileFile::Tile);
+    header.fileSize = dataOffset + count * sizeof(SkyTileFile::Star);
+
+    vector<unsigned char> contents(header.fileSize, 0);
+    memcpy(&contents[0], &header, sizeof(header));
+
+    SkyTileFile::Tile *index = (SkyTileFile::Tile*) &contents[header.indexOffset];
+    for(size_t i = 0; i < tileCount; ++i) {
+        index[i].offset = dataOffset + tileStart[i] * sizeof(SkyTileFile::Star);
+        index[i].count = (uint32_t) (tileStart[i + 1] - tileStart[i]);
+    }
+
+    SkyTileFile::Star *stars = (SkyTileFile::Star*) &contents[dataOffset];
+    for(size_t i = 0; i < count; ++i) {
+        const size_t entry = grouped[i];
+        stars[i].x = (float) catalog.positions[3 * entry];
+        stars[i].y = (float) catalog.positions[3 * entry + 1];
+        stars[i].z = (float) catalog.positions[3 * entry + 2];
+        stars[i].magnitude = catalog.magnitudes[entry];
+        stars[i].colour = catalog.hasColour ? catalog.colours[entry] : 0xffffff;
+    }
+
+    for(uint32_t i = 0; i < header.levelCount; ++i) {
+        cout << "Level " << i << ": " << tileStart[levelStart[i + 1]] - tileStart[levelStart[i]]
+             << " entries up to magnitude " << header.magnitudeLimit[i]
+             << " in " << SkyIndex::cellCount(i) << " tiles" << endl;
+    }
+
+    writeOutputFile(contents);
+}
+
+void StarCatalogCompiler::writeOutputFile(const vector<unsigned char> &contents)
+{
+    // open the star catalog file
+    ofstream outputFile(m_CatalogCodeFile.c_str(), ios::out | ios::binary);
+    if(!outputFile) {
+        cerr << "Couldn't open output file \"" <<  m_CatalogCodeFile << "\"!" << endl,
+        exit(1);
+    }
+
+    outputFile.write((const char*) &contents[0], contents.size());
+    outputFile.close();
+
+    if(!outputFile) {
+        cerr << "Error during output file processing: " << m_CatalogCodeFile << endl;
+        remove(m_CatalogCodeFile.c_str());
+        exit(1);
+    }
+}
+
+unsigned int StarCatalogCompiler::colourIndexToRGB(const float colourIndex)
+{
+    // black body temperature (Ballesteros 2012), in units of 100 K
+    const double temperature = 46.0 * (1.0 / (0.92 * colourIndex + 1.7) + 1.0 / (0.92 * colourIndex + 0.62));
+
+    // approximation of the Planckian locus (valid for 1000 K to 40000 K)
+    double red, green, blue;
+
+    if(temperature <= 66.0) {
+        red = 255.0;
+        green = 99.4708025861 * log(temperature) - 161.1195681661;
+    }
+    else {
+        red = 329.698727446 * pow(temperature - 60.0, -0.1332047592);
+        green = 288.1221695283 * pow(temperature - 60.0, -0.0755148492);
+    }
+
+    if(temperature >= 66.0) {
+        blue = 255.0;
+    }
+    else if(temperature <= 19.0) {
+        blue = 0.0;
+    }
+    else {
+        blue = 138.5177312231 * log(temperature - 10.0) - 305.0447927307;
+    }
+
+    const double components[3] = {red, green, blue};
+    unsigned int result = 0;
+
+    for(int i = 0; i < 3; ++i) {
+        result = (result << 8) | (unsigned int) (max(0.0, min(255.0, components[i])) + 0.5);
+    }
+
+    return result;
+}
+
+void StarCatalogCompiler::loadCatalog(Catalog &catalog)
+{
+    // open catalog file
+    ifstream catalogFile(catalog.filename.c_str(), ios::in);
+    if(!catalogFile) {
+        cerr << "Couldn't open catalog file \"" <<  catalog.filename << "\"!" << endl,
+        exit(1);
+    }
+
+    vector<float> rightAscensions;
+    vector<float> declinations;
+    vector<int> slots;
+    size_t entries = 0;
+    size_t duplicates = 0;
+    size_t lineNumber = 0;
+    bool firstEntry = true;
+    string line;
+
+    catalog.hasMagnitude = false;
+    catalog.hasColour = false;
+    catalog.positions.clear();
+    catalog.magnitudes.clear();
+    catalog.colours.clear();
+    catalog.linkIndices.clear();
+
+    // open addressing hash table (entry index per slot, -1 if empty)
+    slots.resize(1024, -1);
+
+    // read catalog file line by line
+    while(getline(catalogFile, line)) {
+        ++lineNumber;
+
+        size_t firstCharacter = line.find_first_not_of(" \t\r\n\f");
+
+        // we allow for empty lines and comments
+        if(firstCharacter == string::npos || line[firstCharacter] == '#') {
+            continue;
+        }
+
+        // tokenize entry
+        istringstream tokenStream(line);
+        vector<string> tokens;
+        string token;
+        while(tokenStream >> token) {
+            tokens.push_back(token);
+        }
+
+        char *end = NULL;
+        bool valid = tokens.size() >= 2 && tokens.size() <= 4;
+        float rightAscension = 0.0f;
+        float declination = 0.0f;
+        float magnitude = 0.0f;
+        unsigned int colour = 0;
+        bool hasMagnitude = false;
+        bool hasColour = false;
+
+        if(valid) {
+            rightAscension = (float) strtod(tokens[0].c_str(), &end);
+            valid = *end == '\0' && rightAscension >= -360.0f && rightAscension <= 360.0f;
+            declination = (float) strtod(tokens[1].c_str(), &end);
+            valid = valid && *end == '\0' && declination >= -90.0f && declination <= 90.0f;
+        }
+        if(valid && tokens.size() >= 3 && tokens[2] != "-") {
+            magnitude = (float) strtod(tokens[2].c_str(), &end);
+            valid = *end == '\0';
+            hasMagnitude = true;
+        }
+        if(valid && tokens.size() == 4) {
+            if(tokens[3].find('.') != string::npos) {
+                // B-V colour index
+                const float colourIndex = (float) strtod(tokens[3].c_str(), &end);
+                valid = *end == '\0' && colourIndex >= -1.0f && colourIndex <= 5.0f;
+                colour = colourIndexToRGB(colourIndex);
+            }
+            else {
+                colour = (unsigned int) strtoul(tokens[3].c_str(), &end, 16);
+                valid = *end == '\0' && tokens[3].length() == 6 && isxdigit(tokens[3][0]);
+            }
+            hasColour = true;
+        }
+        if(!valid) {
+            cerr << catalog.filename << ":" << lineNumber << ": unexpected catalog entry: " << line << endl;
+            exit(1);
+        }
+
+        // all entries have to provide the same (optional) columns
+        if(firstEntry) {
+            catalog.hasMagnitude = hasMagnitude;
+            catalog.hasColour = hasColour;
+            firstEntry = false;
+        }
+        else if(hasMagnitude != catalog.hasMagnitude || hasColour != catalog.hasColour) {
+            cerr << catalog.filename << ":" << lineNumber << ": inconsistent catalog columns: " << line << endl;
+            exit(1);
+        }
+
+        ++entries;
+
+        // grow hash table (keep load factor below 1/2)
+        if(2 * (rightAscensions.size() + 1) > slots.size()) {
+            slots.assign(2 * slots.size(), -1);
+            for(size_t i = 0; i < rightAscensions.size(); ++i) {
+                size_t slot = hash(rightAscensions[i], declinations[i]) & (slots.size() - 1);
+                while(slots[slot] != -1) slot = (slot + 1) & (slots.size() - 1);
+                slots[slot] = (int) i;
+            }
+        }
+
+        // look up entry (linear probing)
+        size_t slot = hash(rightAscension, declination) & (slots.size() - 1);
+        while(slots[slot] != -1 &&
+              !(rightAscensions[slots[slot]] == rightAscension && declinations[slots[slot]] == declination))
+        {
+            slot = (slot + 1) & (slots.size() - 1);
+        }
+
+        if(slots[slot] != -1) {
+            // duplicate: reuse the first occurrence
+            const size_t index = slots[slot];
+            if((catalog.hasMagnitude && catalog.magnitudes[index] != magnitude) ||
+               (catalog.hasColour && catalog.colours[index] != colour))
+            {
+                cerr << catalog.filename << ":" << lineNumber << ": duplicate entry with different attributes, keeping the first one" << endl;
+            }
+            if(catalog.links) catalog.linkIndices.push_back((unsigned int) index);
+            ++duplicates;
+            continue;
+        }
+
+        // new unique entry
+        const size_t index = rightAscensions.size();
+        slots[slot] = (int) index;
+        rightAscensions.push_back(rightAscension);
+        declinations.push_back(declination);
+
+        // convert to unit vector (has to match Starsphere::sphVertex3D)
+        const double alpha = rightAscension * Degree;
+        const double delta = declination * Degree;
+        catalog.positions.push_back(cos(delta) * cos(alpha));
+        catalog.positions.push_back(sin(delta));
+        catalog.positions.push_back(-cos(delta) * sin(alpha));
+
+        if(catalog.hasMagnitude) catalog.magnitudes.push_back(magnitude);
+        if(catalog.hasColour) catalog.colours.push_back(colour);
+        if(catalog.links) catalog.linkIndices.push_back((unsigned int) index);
+    }
+
+    if(catalogFile.bad()) {
+        cerr << "Error during catalog file processing: " << catalog.filename << endl;
+        exit(1);
+    }
+
+    if(catalog.links && catalog.linkIndices.size() % 2 != 0) {
+        cerr << "Catalog \"" << catalog.filename << "\" has an odd number of link end points!" << endl;
+        exit(1);
+    }
+
+    cerr << "Catalog \"" << catalog.name << "\": " << entries << " entries, "
+         << duplicates << " duplicates removed" << endl;
+}
+
+void StarCatalogCompiler::parseInputFile()
+{
+    // open input file
+    ifstream inputFile(m_CatalogSpecFile.c_str(), ios::in);
+    if(!inputFile) {
+        cerr << "Couldn't open input file \"" <<  m_CatalogSpecFile << "\"!" << endl,
+        exit(1);
+    }
+
+    // catalog files are resolved relative to the spec file
+    string directory;
+    const size_t directorySeparator = m_CatalogSpecFile.find_last_of("/\\");
+    if(directorySeparator != string::npos) {
+        directory = m_CatalogSpecFile.substr(0, directorySeparator + 1);
+    }
+
+    string line;
+    // read input file line by line
+    while(getline(inputFile, line)) {
+
+        size_t firstCharacter = line.find_first_not_of(" \t\r\n\f");
+
+        // we (sort of) allow for empty lines and comments
+        if(firstCharacter == string::npos || line[firstCharacter] == '#') {
+            continue;
+        }
+
+        // strip trailing whitespace
+        line.erase(line.find_last_not_of(" \t\r\n\f") + 1);
+
+        // split tokens
+        vector<string> tokens;
+        size_t start = 0;
+        size_t separator;
+        while((separator = line.find("|", start)) != string::npos) {
+            tokens.push_back(line.substr(start, separator - start));
+            start = separator + 1;
+        }
+        tokens.push_back(line.substr(start));
+
+        if(tokens.size() < 2 || tokens.size() > 3 ||
+           !isIdentifier(tokens[0]) || tokens[1].empty() ||
+           (tokens.size() == 3 && tokens[2] != "links"))
+        {
+            cerr << "Unexpected catalog specification: " << line << endl;
+            exit(1);
+        }
+
+        for(size_t i = 0; i < m_Catalogs.size(); ++i) {
+            if(m_Catalogs[i].name == tokens[0]) {
+                cerr << "Duplicate catalog name: " << tokens[0] << endl;
+                exit(1);
+            }
+        }
+
+        Catalog catalog;
+        catalog.name = tokens[0];
+        catalog.links = tokens.size() == 3;
+        catalog.hasMagnitude = false;
+        catalog.hasColour = false;
+
+        // absolute paths are taken as they are
+        if(tokens[1][0] == '/' || tokens[1][0] == '\\' || (tokens[1].length() > 1 && tokens[1][1] == ':')) {
+            catalog.filename = tokens[1];
+        }
+        else {
+            catalog.filename = directory + tokens[1];
+        }
+
+        m_Catalogs.push_back(catalog);
+    }
+
+    // close input file
+    inputFile.close();
+}
+
+unsigned int StarCatalogCompiler::hash(const float rightAscension, const float declination)
+{
+    unsigned int bits[2] = {0, 0};
+
+    // hash the bit patterns (normalize signed zeros first, they compare equal)
+    const float key[2] = {rightAscension + 0.0f, declination + 0.0f};
+    memcpy(bits, key, sizeof(key));
+
+    // FNV-1a
+    unsigned int value = 2166136261U;
+    const unsigned char *bytes = (const unsigned char*) bits;
+    for(size_t i = 0; i < sizeof(bits); ++i) {
+        value ^= bytes[i];
+        value *= 16777619U;
+    }
+
+    // final avalanche (the table index uses the low bits)
+    value ^= value >> 16;
+    value *= 0x85ebca6bU;
+    value ^= value >> 13;
+    value *= 0xc2b2ae35U;
+    value ^= value >> 16;
+
+    return value;
+}
+
+string StarCatalogCompiler::floatLiteral(const double value)
+{
+    ostringstream buffer;
+
+    // nine significant digits are sufficient for a lossless round trip
+    buffer << setprecision(9) << (float) value;
+
+    string literal = buffer.str();
+    if(literal.find_first_of(".eE") == string::npos) {
+        literal += ".0";
+    }
+
+    return literal + "f";
+}
+
+bool StarCatalogCompiler::isIdentifier(const string &name)
+{
+    if(name.empty() || !(isalpha((unsigned char) name[0]) || name[0] == '_')) {
+        return false;
+    }
+
+    for(size_t i = 1; i < name.length(); ++i) {
+        if(!(isalnum((unsigned char) name[i]) || name[i] == '_')) {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,254 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef STARCATALOGCOMPILER_H_
+#define STARCATALOGCOMPILER_H_
+
+#include <string>
+#include <vector>
+#include <ostream>
+
+using namespace std;
+
+/**
+ * \addtogroup orc Open Resource Compiler
+ * @{
+ */
+
+/**
+ * \brief Helper class that converts text star catalogs into precomputed source code tables
+ *
+ * This "compiler" takes a catalog specification file, parses the text catalogs listed
+ * therein and converts them into constant structure-of-arrays tables (see StarCatalog).
+ * The positions are converted into unit vectors in the starsphere's cartesian frame at
+ * compile time, so the application doesn't need any trigonometry to set up its vertices
+ * and the tables end up in read-only data pages.\n
+ * \n
+ * Catalog specification file format:
+ * - Simple text file (*.starcat)
+ * - Each line describes one catalog
+ * - The descriptor has to look like this: <code>CatalogName|CatalogFile[|links]</code>
+ * - <code>CatalogName</code> has to be a valid C identifier, the catalog is made available
+ *   as <code>c_StarCatalog<CatalogName></code>
+ * - <code>CatalogFile</code> is resolved relative to the specification file's directory
+ * - The optional \c links flag treats every pair of consecutive entries as link (line segment)
+ * - Lines starting with # are treated as comments
+ * - Empty lines are ignored
+ *
+ * Catalog file format:
+ * - Each line describes one entry: <code>RA DE [magnitude [colour]]</code>
+ * - Right ascension and declination are given in degrees
+ * - The colour is given as six hex digits (\c RRGGBB) or as B-V colour index (containing a decimal
+ *   point, converted via the black body temperature), a magnitude of \c - means "not available"
+ * - Magnitude and colour have to be provided for all entries of a catalog or for none at all
+ * - Lines starting with # are treated as comments
+ * - Empty lines are ignored
+ *
+ * Duplicate entries (same right ascension and declination) are stored only once, they are
+ * detected using a hash table. Links refer to the unique entries by index.
+ *
+ * Large catalogs (e.g. Hipparcos/Tycho) aren't compiled into the application. In binary mode a
+ * single catalog file (providing magnitudes) is converted into an external star catalog file
+ * (see StarCatalogFile) instead, sorted by magnitude, which StarField memory-maps at runtime.
+ * Even larger catalogs are converted into tiled star catalog files (see SkyTileFile) which
+ * are streamed by SkyTileStore depending on the current view.
+ *
+ * \see StarCatalog
+ *
+ * \author Oliver Bock\n
+ * Max-Planck-Institute for Gravitational Physics\n
+ * Hannover, Germany
+ */
+class StarCatalogCompiler
+{
+public:
+    /// Available output modes
+    enum OutputMode {
+        /// Catalogs are written as source code tables (input: catalog specification file)
+        SourceOutputMode,
+
+        /// A single catalog is written to an external star catalog file (input: catalog file)
+        BinaryOutputMode,
+
+        /// A single catalog is written to a tiled star catalog file (input: catalog file)
+        TiledOutputMode
+    };
+
+    /**
+     * \brief Constructor
+     *
+     * \param inputFilename Name of the catalog specification file (source, \c *.starcat) or of the
+     * catalog file (binary and tiled mode, \c *.cat)
+     * \param outputFilename Name of the generated tables file (destination, \c *.cpp) or of the
+     * star catalog file (binary and tiled mode)
+     * \param outputMode The output mode to be used
+     */
+    StarCatalogCompiler(const string inputFilename, const string outputFilename,
+                        const OutputMode outputMode = SourceOutputMode);
+
+    /// Destructor
+    virtual ~StarCatalogCompiler();
+
+    /**
+     * \brief Converts the specified catalogs into the specified source code file
+     *
+     * \see parseInputFile
+     * \see loadCatalog
+     */
+    void compile();
+
+private:
+    /// Conversion factor from degrees to radians
+    static const double Degree;
+
+    /// Compiled catalog
+    struct Catalog {
+        /// Catalog name (C identifier)
+        string name;
+
+        /// Path and filename of the catalog file
+        string filename;
+
+        /// Links flag
+        bool links;
+
+        /// Magnitude availability flag
+        bool hasMagnitude;
+
+        /// Colour availability flag
+        bool hasColour;
+
+        /// Unit vectors of the unique entries (x, y, z interleaved)
+        vector<double> positions;
+
+        /// Magnitudes of the unique entries
+        vector<float> magnitudes;
+
+        /// Colours of the unique entries
+        vector<unsigned int> colours;
+
+        /// Entry indices of the link end points
+        vector<unsigned int> linkIndices;
+    };
+
+    /**
+     * \brief Parses the specified input file
+     *
+     * After validating the catalog specification file its contents are
+     * stored for later use.
+     *
+     * \see loadCatalog
+     */
+    void parseInputFile();
+
+    /**
+     * \brief Loads, deduplicates and converts the entries of a catalog file
+     *
+     * \param catalog The catalog to be loaded (name, filename and links flag have to be set)
+     */
+    void loadCatalog(Catalog &catalog);
+
+    /**
+     * \brief Writes the tables of a catalog
+     *
+     * \param outputFile The output code file
+     * \param catalog The catalog to be written
+     */
+    void writeCatalog(ostream &outputFile, const Catalog &catalog);
+
+    /**
+     * \brief Writes a catalog into an external star catalog file (sorted by magnitude)
+     *
+     * \param catalog The catalog to be written (has to provide magnitudes)
+     */
+    void writeBinary(const Catalog &catalog);
+
+    /**
+     * \brief Writes a catalog into a tiled star catalog file (levels of magnitude, SkyIndex cells)
+     *
+     * \param catalog The catalog to be written (has to provide magnitudes)
+     */
+    void writeTiles(const Catalog &catalog);
+
+    /**
+     * \brief Writes a file, removing it again if that fails
+     *
+     * \param contents The file contents
+     */
+    void writeOutputFile(const vector<unsigned char> &contents);
+
+    /**
+     * \brief Converts a B-V colour index into an RGB colour
+     *
+     * The colour index is converted into the black body temperature (Ballesteros' formula)
+     * which is then converted into RGB using an approximation of the Planckian locus.
+     *
+     * \param colourIndex The B-V colour index
+     *
+     * \return The colour as \c 0xRRGGBB
+     */
+    static unsigned int colourIndexToRGB(const float colourIndex);
+
+    /**
+     * \brief Computes the hash of an entry's position
+     *
+     * \param rightAscension The right ascension (as parsed, single precision)
+     * \param declination The declination (as parsed, single precision)
+     *
+     * \return The hash value
+     */
+    static unsigned int hash(const float rightAscension, const float declination);
+
+    /**
+     * \brief Formats a single precision floating point literal (lossless)
+     *
+     * \param value The value to be formatted
+     *
+     * \return The literal
+     */
+    static string floatLiteral(const double value);
+
+    /**
+     * \brief Checks whether the given string is a valid C identifier
+     *
+     * \param name The string to be checked
+     *
+     * \return \c true if the string is a valid identifier, \c false otherwise
+     */
+    static bool isIdentifier(const string &name);
+
+    /// Path and filename of the catalog specification file (source)
+    string m_CatalogSpecFile;
+
+    /// Path and filename of the generated source code file (destination)
+    string m_CatalogCodeFile;
+
+    /// The output mode
+    OutputMode m_OutputMode;
+
+    /// The catalogs (in specification order)
+    vector<Catalog> m_Catalogs;
+};
+
+/**
+ * @}
+ */
+
+#endif /*STARCATALOGCOMPILER_H_*/
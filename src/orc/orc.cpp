@@ -26,18 +26,44 @@
 
 void printUsage() {
     cerr << "Invalid command-line options!" << endl;
-    cerr << "Usage: orc <input filename> <output filename>" << endl;
+    cerr << "Usage: orc [--incbin | --pack] [--compress] <input filename> <output filename>" << endl;
+    cerr << "  --incbin    embed the resource files via assembler .incbin directives" << endl;
+    cerr << "              instead of writing their contents as hex initializers" << endl;
+    cerr << "  --compress  compress the resources (LZ4) if that makes them smaller" << endl;
+    cerr << "  --pack      write an external resource pack file instead of source code" << endl;
 }
 
 int main(int argc, char *argv[])
 {
-    if(argc != 3) {
+    ResourceCompiler::OutputMode outputMode = ResourceCompiler::HexInitializerOutputMode;
+    bool compression = false;
+    int argumentOffset = 1;
+
+    // parse options (preceding the filenames)
+    for(; argumentOffset < argc && string(argv[argumentOffset]).substr(0, 2) == "--"; ++argumentOffset) {
+        const string option(argv[argumentOffset]);
+        if(option == "--incbin") {
+            outputMode = ResourceCompiler::IncludeBinaryOutputMode;
+        }
+        else if(option == "--pack") {
+            outputMode = ResourceCompiler::PackOutputMode;
+        }
+        else if(option == "--compress") {
+            compression = true;
+        }
+        else {
+            printUsage();
+            exit(1);
+        }
+    }
+
+    if(argc - argumentOffset != 2) {
         printUsage();
         exit(1);
     }
     else {
-        string inputFilename(argv[1]);
-        string outputFilename(argv[2]);
+        string inputFilename(argv[argumentOffset]);
+        string outputFilename(argv[argumentOffset + 1]);
 
         // TODO: better filename checking
         if( inputFilename == "." || inputFilename == ".." ||
@@ -47,7 +73,7 @@ int main(int argc, char *argv[])
             exit(1);
         }
 
-        ResourceCompiler rc(inputFilename, outputFilename);
+        ResourceCompiler rc(inputFilename, outputFilename, outputMode, compression);
         rc.compile();
 
         exit(0);
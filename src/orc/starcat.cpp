@@ -0,0 +1,77 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#include <cstdlib>
+#include <string>
+#include <iostream>
+
+#include "StarCatalogCompiler.h"
+
+void printUsage() {
+    cerr << "Invalid command-line options!" << endl;
+    cerr << "Usage: starcat [--binary|--tiles] <input filename> <output filename>" << endl;
+    cerr << "  --binary  convert a single catalog file into an external star catalog file" << endl;
+    cerr << "            (sorted by magnitude) instead of compiling a catalog specification" << endl;
+    cerr << "  --tiles   convert a single catalog file into a tiled star catalog file" << endl;
+    cerr << "            (levels of magnitude, streamed depending on the view)" << endl;
+}
+
+int main(int argc, char *argv[])
+{
+    StarCatalogCompiler::OutputMode outputMode = StarCatalogCompiler::SourceOutputMode;
+    int argumentOffset = 1;
+
+    // parse options (preceding the filenames)
+    for(; argumentOffset < argc && string(argv[argumentOffset]).substr(0, 2) == "--"; ++argumentOffset) {
+        const string option(argv[argumentOffset]);
+        if(option == "--binary") {
+            outputMode = StarCatalogCompiler::BinaryOutputMode;
+        }
+        else if(option == "--tiles") {
+            outputMode = StarCatalogCompiler::TiledOutputMode;
+        }
+        else {
+            printUsage();
+            exit(1);
+        }
+    }
+
+    if(argc - argumentOffset != 2) {
+        printUsage();
+        exit(1);
+    }
+    else {
+        string inputFilename(argv[argumentOffset]);
+        string outputFilename(argv[argumentOffset + 1]);
+
+        // TODO: better filename checking
+        if( inputFilename == "." || inputFilename == ".." ||
+                outputFilename == "." || outputFilename == "..")
+        {
+            printUsage();
+            exit(1);
+        }
+
+        StarCatalogCompiler scc(inputFilename, outputFilename, outputMode);
+        scc.compile();
+
+        exit(0);
+    }
+}
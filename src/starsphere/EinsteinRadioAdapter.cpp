@@ -20,7 +20,10 @@
 
 #include "EinsteinRadioAdapter.h"
 
-#include <sstream>
+#include <cstring>
+
+#include "GraphicsInfoParser.h"
+#include "PowerSpectrumDecoder.h"
 
 const string EinsteinRadioAdapter::SharedMemoryIdentifier = "EinsteinRadio";
 
@@ -28,7 +31,7 @@ EinsteinRadioAdapter::EinsteinRadioAdapter(BOINCClientAdapter *boincClient) :
 	m_WUTemplatePowerSpectrum(POWERSPECTRUM_BINS, 0)
 {
 	this->boincClient = boincClient;
-	m_xmlReader = NULL;
+	m_LastInformationRevision = 0;
 
 	m_WUSkyPosRightAscension = 0.0;
 	m_WUSkyPosDeclination = 0.0;
@@ -38,8 +41,6 @@ EinsteinRadioAdapter::EinsteinRadioAdapter(BOINCClientAdapter *boincClient) :
 
 EinsteinRadioAdapter::~EinsteinRadioAdapter()
 {
-	if(m_xmlReader) xmlFreeTextReader(m_xmlReader);
-    xmlCleanupParser();
 }
 
 void EinsteinRadioAdapter::refresh()
@@ -50,149 +51,120 @@ void EinsteinRadioAdapter::refresh()
 
 void EinsteinRadioAdapter::parseApplicationInformation()
 {
-	// get updated application information
-	string info = boincClient->applicationInformation();
+	// nothing new since last time
+	if(boincClient->applicationInformationRevision() == m_LastInformationRevision) return;
+	m_LastInformationRevision = boincClient->applicationInformationRevision();
+
+	// get updated application information (no copy required)
+	const string &info = boincClient->applicationInformation();
+
+	// binary records don't need any parsing
+	if(BOINCClientAdapter::isBinaryApplicationInformation(info)) {
+		if(!parseBinaryApplicationInformation(info)) {
+			cerr << "Incompatible binary shared memory data encountered!" << endl;
+		}
+		return;
+	}
 
 	// do we have any data?
 	if(info.length() > 0) {
-		int result = 0;
-
-		// prepare conversion stream
-		stringstream converter;
-		converter.precision(3);
-		converter.exceptions(ios_base::badbit | ios_base::failbit);
-
-		if(!m_xmlReader) {
-			// set up SAX style XML reader (create instance)
-			m_xmlReader = xmlReaderForMemory(info.c_str(),
-											 info.length(),
-											 "http://einstein.phys.uwm.edu",
-											 "UTF-8",
-											 0);
-			if(!m_xmlReader) {
-				cerr << "Error creating XML reader for shared memory data!" << endl;
-				return;
+		GraphicsInfoParser parser(info);
+		bool spectrumValid = false;
+		double angle;
+
+		// single pass over all elements (values are converted in place)
+		while(parser.next()) {
+			if(parser.isElement("skypos_rac")) {
+				// convert radians to degrees
+				if(parser.valueAsDouble(angle)) m_WUSkyPosRightAscension = angle * 180/PI;
 			}
-		}
-		else {
-			// set up SAX style XML reader (reusing existing instance)
-			if(xmlReaderNewMemory(m_xmlReader,
-								  info.c_str(),
-								  info.length(),
-								  "http://einstein.phys.uwm.edu",
-								  "UTF-8",
-								  0))
-			{
-				cerr << "Error updating XML reader for shared memory data!" << endl;
-				return;
+			else if(parser.isElement("skypos_dec")) {
+				// convert radians to degrees
+				if(parser.valueAsDouble(angle)) m_WUSkyPosDeclination = angle * 180/PI;
 			}
-		}
-
-		// parse XML fragment and process nodes
-        result = xmlTextReaderRead(m_xmlReader);
-        while (result == 1) {
-        	processXmlNode(m_xmlReader, converter);
-            result = xmlTextReaderRead(m_xmlReader);
-        }
-
-		// convert radians to degrees
-		m_WUSkyPosRightAscension *= 180/PI;
-		m_WUSkyPosDeclination *= 180/PI;
-
-		// deserialize power spectrum data
-		if(m_WUTemplatePowerSpectrumString.length() == POWERSPECTRUM_BIN_BYTES) {
-			int spectrumBinValue;
-;
-			// iterate over all bins
-			for(int i = 0, j = 0; i < POWERSPECTRUM_BIN_BYTES; i += 2, ++j) {
-				try {
-					converter.clear();
-					converter.str(m_WUTemplatePowerSpectrumString.substr(i, 2));
-					// convert hex bin value to integer
-					converter >> hex >> spectrumBinValue;
-					// store bin power value
-					m_WUTemplatePowerSpectrum.at(j) = (unsigned char) spectrumBinValue;
-				}
-				catch(ios_base::failure) {
-					cerr << "Error processing power spectrum shared memory data!" << endl;
-					break;
-				}
+			else if(parser.isElement("dispersion")) {
+				parser.valueAsDouble(m_WUDispersionMeasure);
+			}
+			else if(parser.isElement("orb_radius")) {
+				parser.valueAsDouble(m_WUTemplateOrbitalRadius);
+			}
+			else if(parser.isElement("orb_period")) {
+				parser.valueAsDouble(m_WUTemplateOrbitalPeriod);
+			}
+			else if(parser.isElement("orb_phase")) {
+				parser.valueAsDouble(m_WUTemplateOrbitalPhase);
+			}
+			else if(parser.isElement("power_spectrum")) {
+				spectrumValid = parsePowerSpectrum(parser.value(), parser.valueLength(), false);
+			}
+			else if(parser.isElement("power_spectrum_base64")) {
+				spectrumValid = parsePowerSpectrum(parser.value(), parser.valueLength(), true);
+			}
+			else if(parser.isElement("fraction_done")) {
+				parser.valueAsDouble(m_WUFractionDone);
+			}
+			else if(parser.isElement("cpu_time")) {
+				parser.valueAsDouble(m_WUCPUTime);
 			}
 		}
-		else {
+
+		if(!spectrumValid) {
 			cerr << "Invalid power spectrum shared memory data encountered!" << endl;
 		}
-
 	}
 }
 
-void EinsteinRadioAdapter::processXmlNode(const xmlTextReaderPtr xmlReader, stringstream& converter)
+bool EinsteinRadioAdapter::parsePowerSpectrum(const char *data, const size_t length, const bool base64)
 {
-	// we only parse element nodes
-    if(xmlTextReaderNodeType(xmlReader) != XML_READER_TYPE_ELEMENT) return;
+	// decode into the scratch buffer first to keep the previous spectrum in case of errors
+	const bool valid = base64 ?
+		PowerSpectrumDecoder::decodeBase64(data, length, m_WUTemplatePowerSpectrumBuffer) :
+		PowerSpectrumDecoder::decodeHex(data, length, m_WUTemplatePowerSpectrumBuffer);
 
-    // buffers (will be deallocated automatically)
-    const xmlChar *nodeName = NULL, *nodeValue = NULL;
+	if(!valid || m_WUTemplatePowerSpectrumBuffer.empty()) return false;
 
-    // get element node's name
-    nodeName = xmlTextReaderConstLocalName(xmlReader);
+	// swapping retains the capacity of both buffers (no reallocation for subsequent spectra)
+	m_WUTemplatePowerSpectrum.swap(m_WUTemplatePowerSpectrumBuffer);
 
-    if (nodeName == NULL) {
-		cerr << "Error parsing XML node (invalid name)" << endl;
-		return;
-    }
+	return true;
+}
 
-	// move to node's text content (child node) or return if unavailable
-	if(! (xmlTextReaderRead(m_xmlReader) && xmlTextReaderHasValue(xmlReader))) {
-		return;
-	}
+bool EinsteinRadioAdapter::parseBinaryApplicationInformation(const string &info)
+{
+	GraphicsInfoHeader header;
+	GraphicsInfoRadio payload;
 
-	// get text node's value
-	nodeValue = xmlTextReaderConstValue(xmlReader);
+	// copy (the string's data isn't necessarily aligned)
+	memcpy(&header, info.data(), sizeof(header));
 
-	if (nodeValue == NULL) {
-		cerr << "Error parsing XML node (invalid value)" << endl;
-		return;
+	if(header.version != GRAPHICS_INFO_VERSION || header.type != GraphicsInfoTypeRadio ||
+	   header.length < sizeof(payload) || info.length() < sizeof(header) + sizeof(payload)) {
+		return false;
 	}
 
-    try {
-        // prepare converter stream
-        converter.clear();
-        converter.str("");
-        converter << nodeValue;
+	memcpy(&payload, info.data() + sizeof(header), sizeof(payload));
+
+	// convert radians to degrees
+	m_WUSkyPosRightAscension = payload.skyPosRightAscension * 180/PI;
+	m_WUSkyPosDeclination = payload.skyPosDeclination * 180/PI;
+	m_WUDispersionMeasure = payload.dispersionMeasure;
+	m_WUTemplateOrbitalRadius = payload.orbitalRadius;
+	m_WUTemplateOrbitalPeriod = payload.orbitalPeriod;
+	m_WUTemplateOrbitalPhase = payload.orbitalPhase;
+	m_WUFractionDone = payload.fractionDone;
+	m_WUCPUTime = payload.cpuTime;
+
+	// power spectrum bins are raw bytes following the payload
+	const size_t offset = sizeof(header) + sizeof(payload);
+	const size_t bins = payload.powerSpectrumBins;
+	if(bins > 0 && bins <= PowerSpectrumDecoder::MaxBins && info.length() >= offset + bins) {
+		m_WUTemplatePowerSpectrum.assign(info.begin() + offset, info.begin() + offset + bins);
+	}
+	else {
+		cerr << "Invalid power spectrum shared memory data encountered!" << endl;
+	}
 
-		// assign node value to respective data member
-		if(xmlStrEqual(nodeName, BAD_CAST("skypos_rac"))) {
-			converter >> fixed >> m_WUSkyPosRightAscension;
-		}
-		else if(xmlStrEqual(nodeName, BAD_CAST("skypos_dec"))) {
-			converter >> fixed >> m_WUSkyPosDeclination;
-		}
-		else if(xmlStrEqual(nodeName, BAD_CAST("dispersion"))) {
-			converter >> fixed >> m_WUDispersionMeasure;
-		}
-		else if(xmlStrEqual(nodeName, BAD_CAST("orb_radius"))) {
-			converter >> fixed >> m_WUTemplateOrbitalRadius;
-		}
-		else if(xmlStrEqual(nodeName, BAD_CAST("orb_period"))) {
-			converter >> fixed >> m_WUTemplateOrbitalPeriod;
-		}
-		else if(xmlStrEqual(nodeName, BAD_CAST("orb_phase"))) {
-			converter >> fixed >> m_WUTemplateOrbitalPhase;
-		}
-		else if(xmlStrEqual(nodeName, BAD_CAST("power_spectrum"))) {
-			converter >> m_WUTemplatePowerSpectrumString;
-		}
-		else if(xmlStrEqual(nodeName, BAD_CAST("fraction_done"))) {
-			converter >> fixed >> m_WUFractionDone;
-		}
-		else if(xmlStrEqual(nodeName, BAD_CAST("cpu_time"))) {
-			converter >> fixed >> m_WUCPUTime;
-		}
-    }
-    catch(ios_base::failure) {
-    	cerr << "Error converting XML reader node content!" << endl;
-    }
+	return true;
 }
 
 double EinsteinRadioAdapter::wuSkyPosRightAscension() const
@@ -26,15 +26,12 @@
 #include <iomanip>
 #include <vector>
 
-#include <libxml/xmlreader.h>
-
 #include "BOINCClientAdapter.h"
 
 using namespace std;
 
 #define PI 3.14159265
 #define POWERSPECTRUM_BINS 40
-#define POWERSPECTRUM_BIN_BYTES 80
 
 /**
  * \addtogroup starsphere Starsphere
@@ -147,30 +144,42 @@ private:
 	 *
 	 * The information is usually transferred via a shared memory area
 	 * which is handled by the parent generic BOINC client adapter.
+	 * Parsing is skipped if the information didn't change since the last call.
 	 *
 	 * \see boincClient
+	 * \see BOINCClientAdapter::applicationInformationRevision()
 	 */
 	void parseApplicationInformation();
 
 	/**
-	 * \brief Processes single element nodes found by the XML parser
+	 * \brief Reads a binary graphics_info record into local attributes
 	 *
-	 * This method can sort of resembles the callback method used in conjunction with SAX parsers.
-	 * It's called to process single XML nodes (in our case element nodes only) encountered
-	 * during XML document (tree) traversal.
+	 * \param info The application information (a binary record)
 	 *
-	 * \param xmlReader The pointer to the current xmlReader instance
-	 * \param converter Reference to an existing string stream for value/type conversion
+	 * \return TRUE if successful, FALSE if the record is incompatible
 	 *
-	 * \see parseApplicationInformation()
+	 * \see GraphicsInfoHeader
 	 */
-	void processXmlNode(const xmlTextReaderPtr xmlReader, stringstream& converter);
+	bool parseBinaryApplicationInformation(const string &info);
+
+	/**
+	 * \brief Decodes the text encoded power spectrum (any number of bins)
+	 *
+	 * \param data Pointer to the encoded spectrum
+	 * \param length The number of characters
+	 * \param base64 TRUE if the spectrum is base64 encoded, FALSE if it's hex encoded
+	 *
+	 * \return TRUE if successful, FALSE if the data is invalid (the previous spectrum is retained)
+	 *
+	 * \see PowerSpectrumDecoder
+	 */
+	bool parsePowerSpectrum(const char *data, const size_t length, const bool base64);
 
 	/// Pointer to the (parent) BOINC client adapter
 	BOINCClientAdapter *boincClient;
 
-	/// Pointer to the XML reader (SAX style)
-	xmlTextReaderPtr m_xmlReader;
+	/// Revision of the application information parsed last time
+	unsigned long m_LastInformationRevision;
 
 	/// Right ascension of the currently searched sky position (in degrees)
 	double m_WUSkyPosRightAscension;
@@ -190,12 +199,12 @@ private:
 	/// Initial orbital phase of the currently active template
 	double m_WUTemplateOrbitalPhase;
 
-	/// Power spectrum of the currently active template (string)
-	string m_WUTemplatePowerSpectrumString;
-
 	/// Power spectrum of the currently active template (values)
 	vector<unsigned char> m_WUTemplatePowerSpectrum;
 
+	/// Scratch buffer used while decoding the power spectrum
+	vector<unsigned char> m_WUTemplatePowerSpectrumBuffer;
+
 	/// The completion fraction of the active work unit
 	double m_WUFractionDone;
 
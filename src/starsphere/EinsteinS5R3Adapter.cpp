@@ -20,11 +20,16 @@
 
 #include "EinsteinS5R3Adapter.h"
 
+#include <cstring>
+
+#include "GraphicsInfoParser.h"
+
 const string EinsteinS5R3Adapter::SharedMemoryIdentifier = "EinsteinHS";
 
 EinsteinS5R3Adapter::EinsteinS5R3Adapter(BOINCClientAdapter *boincClient)
 {
 	this->boincClient = boincClient;
+	m_LastInformationRevision = 0;
 
 	m_WUSkyPosRightAscension = 0.0;
 	m_WUSkyPosDeclination = 0.0;
@@ -44,34 +49,80 @@ void EinsteinS5R3Adapter::refresh()
 
 void EinsteinS5R3Adapter::parseApplicationInformation()
 {
-	// get updated application information
-	string info = boincClient->applicationInformation();
+	// nothing new since last time
+	if(boincClient->applicationInformationRevision() == m_LastInformationRevision) return;
+	m_LastInformationRevision = boincClient->applicationInformationRevision();
+
+	// get updated application information (no copy required)
+	const string &info = boincClient->applicationInformation();
+
+	// binary records don't need any parsing
+	if(BOINCClientAdapter::isBinaryApplicationInformation(info)) {
+		if(!parseBinaryApplicationInformation(info)) {
+			cerr << "Incompatible binary shared memory data encountered!" << endl;
+		}
+		return;
+	}
 
 	// do we have any data?
 	if(info.length() > 0) {
+		GraphicsInfoParser parser(info);
+		double rightAscension = 0.0, declination = 0.0, fractionDone = 0.0, cpuTime = 0.0;
+		int found = 0;
+
+		// parse data (any whitespace/order is fine)
+		while(parser.next()) {
+			if(parser.isElement("skypos_rac")) {
+				found += parser.valueAsDouble(rightAscension);
+			}
+			else if(parser.isElement("skypos_dec")) {
+				found += parser.valueAsDouble(declination);
+			}
+			else if(parser.isElement("fraction_done")) {
+				found += parser.valueAsDouble(fractionDone);
+			}
+			else if(parser.isElement("cpu_time")) {
+				found += parser.valueAsDouble(cpuTime);
+			}
+		}
 
-		// parse data into members
-		if(4 != sscanf(info.c_str(),
-			  		"<graphics_info>\n"
-			  		"  <skypos_rac>%lf</skypos_rac>\n"
-			  		"  <skypos_dec>%lf</skypos_dec>\n"
-			  		"  <fraction_done>%lf</fraction_done>\n"
-			  		"  <cpu_time>%lf</cpu_time>\n",
-			  		&m_WUSkyPosRightAscension,
-			  		&m_WUSkyPosDeclination,
-			  		&m_WUFractionDone,
-			  		&m_WUCPUTime))
-		{
+		if(found != 4) {
 			cerr << "Incompatible shared memory data encountered!" << endl;
 		}
 		else {
-			// convert radians to degrees
-			m_WUSkyPosRightAscension *= 180/PI;
-			m_WUSkyPosDeclination *= 180/PI;
+			// store data in members (converting radians to degrees)
+			m_WUSkyPosRightAscension = rightAscension * 180/PI;
+			m_WUSkyPosDeclination = declination * 180/PI;
+			m_WUFractionDone = fractionDone;
+			m_WUCPUTime = cpuTime;
 		}
 	}
 }
 
+bool EinsteinS5R3Adapter::parseBinaryApplicationInformation(const string &info)
+{
+	GraphicsInfoHeader header;
+	GraphicsInfoS5R3 payload;
+
+	// copy (the string's data isn't necessarily aligned)
+	memcpy(&header, info.data(), sizeof(header));
+
+	if(header.version != GRAPHICS_INFO_VERSION || header.type != GraphicsInfoTypeS5R3 ||
+	   header.length < sizeof(payload) || info.length() < sizeof(header) + sizeof(payload)) {
+		return false;
+	}
+
+	memcpy(&payload, info.data() + sizeof(header), sizeof(payload));
+
+	// convert radians to degrees
+	m_WUSkyPosRightAscension = payload.skyPosRightAscension * 180/PI;
+	m_WUSkyPosDeclination = payload.skyPosDeclination * 180/PI;
+	m_WUFractionDone = payload.fractionDone;
+	m_WUCPUTime = payload.cpuTime;
+
+	return true;
+}
+
 double EinsteinS5R3Adapter::wuSkyPosRightAscension() const
 {
 	return m_WUSkyPosRightAscension;
@@ -105,14 +105,30 @@ private:
 	 *
 	 * The information is usually transferred via a shared memory area
 	 * which is handled by the parent generic BOINC client adapter.
+	 * Parsing is skipped if the information didn't change since the last call.
 	 *
 	 * \see boincClient
+	 * \see BOINCClientAdapter::applicationInformationRevision()
 	 */
 	void parseApplicationInformation();
 
+	/**
+	 * \brief Reads a binary graphics_info record into local attributes
+	 *
+	 * \param info The application information (a binary record)
+	 *
+	 * \return TRUE if successful, FALSE if the record is incompatible
+	 *
+	 * \see GraphicsInfoHeader
+	 */
+	bool parseBinaryApplicationInformation(const string &info);
+
 	/// Pointer to the (parent) BOINC client adapter
 	BOINCClientAdapter *boincClient;
 
+	/// Revision of the application information parsed last time
+	unsigned long m_LastInformationRevision;
+
 	/// Right ascension of the currently searched sky position (in degrees)
 	double m_WUSkyPosRightAscension;
 
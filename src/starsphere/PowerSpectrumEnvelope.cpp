@@ -0,0 +1,167 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "PowerSpectrumEnvelope.h"
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define POWERSPECTRUMENVELOPE_X86
+#include <immintrin.h>
+#endif
+
+#ifdef POWERSPECTRUMENVELOPE_X86
+
+/**
+ * Min/max reduction of 16 bins per iteration (SSE2)
+ *
+ * Returns the number of bins processed (multiple of 16), the remainder is left to the caller.
+ */
+__attribute__((target("sse2")))
+static size_t reduceSSE2(const unsigned char *data, const size_t count,
+						 unsigned char &minimum, unsigned char &maximum)
+{
+	if(count < 16) return 0;
+
+	__m128i lower = _mm_loadu_si128((const __m128i*) data);
+	__m128i upper = lower;
+
+	size_t i = 16;
+	for(; i + 16 <= count; i += 16) {
+		const __m128i values = _mm_loadu_si128((const __m128i*) (data + i));
+		lower = _mm_min_epu8(lower, values);
+		upper = _mm_max_epu8(upper, values);
+	}
+
+	// horizontal reduction
+	lower = _mm_min_epu8(lower, _mm_srli_si128(lower, 8));
+	lower = _mm_min_epu8(lower, _mm_srli_si128(lower, 4));
+	lower = _mm_min_epu8(lower, _mm_srli_si128(lower, 2));
+	lower = _mm_min_epu8(lower, _mm_srli_si128(lower, 1));
+	upper = _mm_max_epu8(upper, _mm_srli_si128(upper, 8));
+	upper = _mm_max_epu8(upper, _mm_srli_si128(upper, 4));
+	upper = _mm_max_epu8(upper, _mm_srli_si128(upper, 2));
+	upper = _mm_max_epu8(upper, _mm_srli_si128(upper, 1));
+
+	const unsigned char lowest = (unsigned char) _mm_cvtsi128_si32(lower);
+	const unsigned char highest = (unsigned char) _mm_cvtsi128_si32(upper);
+
+	if(lowest < minimum) minimum = lowest;
+	if(highest > maximum) maximum = highest;
+
+	return i;
+}
+
+/**
+ * Min/max reduction of 32 bins per iteration (AVX2)
+ *
+ * Returns the number of bins processed (multiple of 32), the remainder is left to the caller.
+ */
+__attribute__((target("avx2")))
+static size_t reduceAVX2(const unsigned char *data, const size_t count,
+						 unsigned char &minimum, unsigned char &maximum)
+{
+	if(count < 32) return 0;
+
+	__m256i lower = _mm256_loadu_si256((const __m256i*) data);
+	__m256i upper = lower;
+
+	size_t i = 32;
+	for(; i + 32 <= count; i += 32) {
+		const __m256i values = _mm256_loadu_si256((const __m256i*) (data + i));
+		lower = _mm256_min_epu8(lower, values);
+		upper = _mm256_max_epu8(upper, values);
+	}
+
+	// horizontal reduction (fold 128 bit lanes first)
+	__m128i lower128 = _mm_min_epu8(_mm256_castsi256_si128(lower), _mm256_extracti128_si256(lower, 1));
+	__m128i upper128 = _mm_max_epu8(_mm256_castsi256_si128(upper), _mm256_extracti128_si256(upper, 1));
+
+	lower128 = _mm_min_epu8(lower128, _mm_srli_si128(lower128, 8));
+	lower128 = _mm_min_epu8(lower128, _mm_srli_si128(lower128, 4));
+	lower128 = _mm_min_epu8(lower128, _mm_srli_si128(lower128, 2));
+	lower128 = _mm_min_epu8(lower128, _mm_srli_si128(lower128, 1));
+	upper128 = _mm_max_epu8(upper128, _mm_srli_si128(upper128, 8));
+	upper128 = _mm_max_epu8(upper128, _mm_srli_si128(upper128, 4));
+	upper128 = _mm_max_epu8(upper128, _mm_srli_si128(upper128, 2));
+	upper128 = _mm_max_epu8(upper128, _mm_srli_si128(upper128, 1));
+
+	const unsigned char lowest = (unsigned char) _mm_cvtsi128_si32(lower128);
+	const unsigned char highest = (unsigned char) _mm_cvtsi128_si32(upper128);
+
+	if(lowest < minimum) minimum = lowest;
+	if(highest > maximum) maximum = highest;
+
+	return i;
+}
+
+#endif
+
+void PowerSpectrumEnvelope::compute(const vector<unsigned char> &bins, size_t columns,
+									vector<unsigned char> &minimum, vector<unsigned char> &maximum)
+{
+	const size_t count = bins.size();
+
+	minimum.resize(columns);
+	maximum.resize(columns);
+	if(columns == 0 || count == 0) return;
+
+#ifdef POWERSPECTRUMENVELOPE_X86
+	const bool avx2 = __builtin_cpu_supports("avx2");
+	const bool sse2 = __builtin_cpu_supports("sse2");
+#endif
+
+	const unsigned char *data = &bins[0];
+
+	for(size_t column = 0; column < columns; ++column) {
+		// each column covers at least one bin (the same one for neighbouring columns of stretched spectra)
+		const size_t begin = column * count / columns;
+		size_t end = (column + 1) * count / columns;
+		if(end == begin) end = begin + 1;
+
+		unsigned char lowest = 255;
+		unsigned char highest = 0;
+		size_t done = 0;
+
+#ifdef POWERSPECTRUMENVELOPE_X86
+		if(avx2) {
+			done = reduceAVX2(data + begin, end - begin, lowest, highest);
+		}
+		else if(sse2) {
+			done = reduceSSE2(data + begin, end - begin, lowest, highest);
+		}
+#endif
+
+		// remainder
+		if(begin + done < end) {
+			reduceScalar(data + begin + done, end - begin - done, lowest, highest);
+		}
+
+		minimum[column] = lowest;
+		maximum[column] = highest;
+	}
+}
+
+void PowerSpectrumEnvelope::reduceScalar(const unsigned char *data, const size_t count,
+										 unsigned char &minimum, unsigned char &maximum)
+{
+	for(size_t i = 0; i < count; ++i) {
+		if(data[i] < minimum) minimum = data[i];
+		if(data[i] > maximum) maximum = data[i];
+	}
+}
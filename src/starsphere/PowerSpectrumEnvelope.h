@@ -0,0 +1,79 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef POWERSPECTRUMENVELOPE_H_
+#define POWERSPECTRUMENVELOPE_H_
+
+#include <cstddef>
+#include <vector>
+
+using namespace std;
+
+/**
+ * \addtogroup starsphere Starsphere
+ * @{
+ */
+
+/**
+ * \brief Min/max decimation of power spectra for display purposes
+ *
+ * Spectra with more bins than there are pixel columns available are reduced to one
+ * minimum/maximum pair per column. Each column covers a contiguous range of bins,
+ * so peaks (e.g. candidates) are never lost. Spectra with fewer bins are stretched
+ * across all columns, each column showing the single bin it falls onto. The reduction is vectorised on x86 CPUs
+ * supporting AVX2 or SSE2 (detected at runtime), all other CPUs use the scalar
+ * implementation.
+ *
+ * \author Oliver Bock\n
+ * Max-Planck-Institute for Gravitational Physics\n
+ * Hannover, Germany
+ */
+class PowerSpectrumEnvelope
+{
+public:
+	/**
+	 * \brief Computes the min/max envelope of a power spectrum
+	 *
+	 * \param bins The power spectrum bins
+	 * \param columns The number of envelope columns requested
+	 * \param minimum Reference to the buffer receiving the minimum per column (resized accordingly)
+	 * \param maximum Reference to the buffer receiving the maximum per column (resized accordingly)
+	 */
+	static void compute(const vector<unsigned char> &bins, size_t columns,
+						vector<unsigned char> &minimum, vector<unsigned char> &maximum);
+
+private:
+	/**
+	 * \brief Scalar min/max reduction
+	 *
+	 * \param data Pointer to the bins to be reduced
+	 * \param count The number of bins (at least one)
+	 * \param minimum Reference to the minimum (updated)
+	 * \param maximum Reference to the maximum (updated)
+	 */
+	static void reduceScalar(const unsigned char *data, const size_t count,
+							 unsigned char &minimum, unsigned char &maximum);
+};
+
+/**
+ * @}
+ */
+
+#endif /*POWERSPECTRUMENVELOPE_H_*/
@@ -0,0 +1,164 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "SkyBatch.h"
+
+#include <cmath>
+
+#include "SkyIndex.h"
+
+SkyBatch::SkyBatch(const GLenum mode, const GLfloat size) : VertexBatch(mode, size)
+{
+	m_PartitionedSize = 0;
+}
+
+SkyBatch::~SkyBatch()
+{
+}
+
+int SkyBatch::primitiveSize() const
+{
+	switch(m_Mode) {
+		case GL_POINTS:
+			return 1;
+		case GL_LINES:
+			return 2;
+		default:
+			return 0;
+	}
+}
+
+void SkyBatch::partition(const unsigned int depth)
+{
+	m_Cells.clear();
+	m_PartitionedSize = 0;
+
+	const int vertices = primitiveSize();
+	if(vertices == 0 || m_Vertices.empty()) return;
+
+	const int stride = vertices * VertexStride;
+	const size_t primitives = m_Vertices.size() / stride;
+
+	// assign primitives to the cells containing their centre
+	vector<unsigned int> cells(primitives);
+	vector<size_t> cellStart(SkyIndex::cellCount(depth) + 1, 0);
+
+	for(size_t i = 0; i < primitives; ++i) {
+		GLfloat centre[3] = {0.0, 0.0, 0.0};
+		for(int j = 0; j < vertices; ++j) {
+			const GLfloat *vertex = &m_Vertices[i * stride + j * VertexStride + 3];
+			centre[0] += vertex[0];
+			centre[1] += vertex[1];
+			centre[2] += vertex[2];
+		}
+
+		cells[i] = SkyIndex::cell(centre[0], centre[1], centre[2], depth);
+		++cellStart[cells[i] + 1];
+	}
+
+	// reorder primitives by cell (counting sort, stable)
+	for(size_t i = 1; i < cellStart.size(); ++i) cellStart[i] += cellStart[i-1];
+
+	vector<GLfloat> sorted(m_Vertices.size());
+	vector<size_t> position(cellStart.begin(), cellStart.end() - 1);
+	for(size_t i = 0; i < primitives; ++i) {
+		const size_t target = position[cells[i]]++;
+		for(int j = 0; j < stride; ++j) {
+			sorted[target * stride + j] = m_Vertices[i * stride + j];
+		}
+	}
+
+	m_Vertices.swap(sorted);
+
+	// bounding spheres of the non-empty cells (centroid and farthest vertex)
+	for(size_t cell = 0; cell + 1 < cellStart.size(); ++cell) {
+		if(cellStart[cell] == cellStart[cell + 1]) continue;
+
+		Cell bounds;
+		bounds.first = cellStart[cell] * vertices;
+		bounds.count = (cellStart[cell + 1] - cellStart[cell]) * vertices;
+		bounds.centre[0] = bounds.centre[1] = bounds.centre[2] = 0.0;
+		bounds.radius = 0.0;
+
+		for(GLint i = bounds.first; i < bounds.first + bounds.count; ++i) {
+			const GLfloat *vertex = &m_Vertices[i * VertexStride + 3];
+			bounds.centre[0] += vertex[0] / bounds.count;
+			bounds.centre[1] += vertex[1] / bounds.count;
+			bounds.centre[2] += vertex[2] / bounds.count;
+		}
+
+		for(GLint i = bounds.first; i < bounds.first + bounds.count; ++i) {
+			const GLfloat *vertex = &m_Vertices[i * VertexStride + 3];
+			const GLfloat dx = vertex[0] - bounds.centre[0];
+			const GLfloat dy = vertex[1] - bounds.centre[1];
+			const GLfloat dz = vertex[2] - bounds.centre[2];
+			const GLfloat distance = sqrt(dx * dx + dy * dy + dz * dz);
+			if(distance > bounds.radius) bounds.radius = distance;
+		}
+
+		// compensate for rounding
+		bounds.radius = bounds.radius * 1.0001f + 1e-4f;
+
+		m_Cells.push_back(bounds);
+	}
+
+	m_PartitionedSize = size();
+}
+
+GLsizei SkyBatch::draw(const ViewFrustum &frustum) const
+{
+	// not partitioned (or modified since): draw everything
+	if(m_Cells.empty() || m_PartitionedSize != size()) {
+		VertexBatch::draw();
+		return primitiveCount();
+	}
+
+	GLint first = 0;
+	GLsizei count = 0;
+	GLsizei drawn = 0;
+
+	for(size_t i = 0; i < m_Cells.size(); ++i) {
+		const Cell &cell = m_Cells[i];
+		if(!frustum.intersectsSphere(cell.centre, cell.radius)) continue;
+
+		// extend the current range (cells are contiguous) or flush it
+		if(count > 0 && first + count == cell.first) {
+			count += cell.count;
+		}
+		else {
+			if(count > 0) VertexBatch::draw(first, count);
+			first = cell.first;
+			count = cell.count;
+		}
+
+		drawn += cell.count;
+	}
+
+	if(count > 0) VertexBatch::draw(first, count);
+
+	return drawn / primitiveSize();
+}
+
+GLsizei SkyBatch::primitiveCount() const
+{
+	const int vertices = primitiveSize();
+
+	return vertices ? size() / vertices : 1;
+}
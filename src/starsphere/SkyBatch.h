@@ -0,0 +1,137 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef SKYBATCH_H_
+#define SKYBATCH_H_
+
+#include <vector>
+
+#include "VertexBatch.h"
+#include "ViewFrustum.h"
+
+using namespace std;
+
+/**
+ * \addtogroup starsphere Starsphere
+ * @{
+ */
+
+/**
+ * \brief Vertex batch of sky geometry that is drawn only where it's visible
+ *
+ * Once all primitives (points or line segments) have been added, \ref partition() sorts
+ * them by the SkyIndex cell containing their centre, so every cell becomes a contiguous
+ * range of the batch, and computes a bounding sphere per cell (this also covers primitives
+ * straddling cell boundaries). \ref draw(const ViewFrustum&) then tests the cells against
+ * the view frustum and draws the visible ones, merging consecutive visible cells into a
+ * single draw call. Since the cell numbering is spatially coherent the number of draw calls
+ * stays small while everything behind the camera or off screen is skipped.
+ *
+ * Other primitive types (e.g. line strips) can't be partitioned and are always drawn as a whole.
+ *
+ * \see SkyIndex
+ * \see ViewFrustum
+ *
+ * \author Oliver Bock\n
+ * Max-Planck-Institute for Gravitational Physics\n
+ * Hannover, Germany
+ */
+class SkyBatch : public VertexBatch
+{
+public:
+	/**
+	 * \brief Constructor
+	 *
+	 * \param mode The OpenGL primitive type used to render the batch (\c GL_POINTS or \c GL_LINES)
+	 * \param size The point size or line width (depending on \c mode) used to render the batch
+	 */
+	SkyBatch(const GLenum mode, const GLfloat size = 1.0);
+
+	/// Destructor
+	virtual ~SkyBatch();
+
+	/**
+	 * \brief Sorts the primitives by SkyIndex cell and computes the cell bounds
+	 *
+	 * This has to be called after all vertices have been added and before the batch is
+	 * uploaded or compiled. Adding vertices afterwards invalidates the partitioning (the
+	 * batch is then drawn as a whole until it's partitioned again).
+	 *
+	 * \param depth The SkyIndex depth of the cells
+	 */
+	void partition(const unsigned int depth = DefaultDepth);
+
+	/**
+	 * \brief Renders the primitives that might be visible
+	 *
+	 * \param frustum The view frustum (in the coordinate system of the batch's vertices)
+	 *
+	 * \return The number of primitives drawn
+	 */
+	GLsizei draw(const ViewFrustum &frustum) const;
+
+	/// The unculled draw methods are still available
+	using VertexBatch::draw;
+
+	/**
+	 * \brief Retrieve the number of primitives in this batch
+	 *
+	 * \return The number of primitives
+	 */
+	GLsizei primitiveCount() const;
+
+	/// Default SkyIndex depth of the cells (512 cells)
+	static const unsigned int DefaultDepth = 3;
+
+private:
+	/**
+	 * \brief Retrieve the number of vertices per primitive
+	 *
+	 * \return The number of vertices (0 if the primitive type isn't supported)
+	 */
+	int primitiveSize() const;
+
+	/// Non-empty cell of the partitioning
+	struct Cell {
+		/// The first vertex of the cell
+		GLint first;
+
+		/// The number of vertices of the cell
+		GLsizei count;
+
+		/// The centre of the cell's bounding sphere
+		GLfloat centre[3];
+
+		/// The radius of the cell's bounding sphere
+		GLfloat radius;
+	};
+
+	/// The non-empty cells (in batch order)
+	vector<Cell> m_Cells;
+
+	/// The number of vertices at the time of partitioning
+	GLsizei m_PartitionedSize;
+};
+
+/**
+ * @}
+ */
+
+#endif /*SKYBATCH_H_*/
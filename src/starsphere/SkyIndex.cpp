@@ -0,0 +1,176 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "SkyIndex.h"
+
+#include <cmath>
+
+/**
+ * Normalizes a vector (double precision)
+ */
+static inline void normalize(double *vector)
+{
+	const double length = sqrt(vector[0] * vector[0] + vector[1] * vector[1] + vector[2] * vector[2]);
+
+	vector[0] /= length;
+	vector[1] /= length;
+	vector[2] /= length;
+}
+
+/**
+ * Computes the normalized midpoint of two unit vectors (double precision)
+ */
+static inline void midpoint(const double *first, const double *second, double *result)
+{
+	result[0] = first[0] + second[0];
+	result[1] = first[1] + second[1];
+	result[2] = first[2] + second[2];
+	normalize(result);
+}
+
+/**
+ * Computes the triple product dot(cross(first, second), third)
+ */
+static inline double tripleProduct(const double *first, const double *second, const double *third)
+{
+	return (first[1] * second[2] - first[2] * second[1]) * third[0]
+		 + (first[2] * second[0] - first[0] * second[2]) * third[1]
+		 + (first[0] * second[1] - first[1] * second[0]) * third[2];
+}
+
+unsigned int SkyIndex::cellCount(const unsigned int depth)
+{
+	return 8U << (2 * depth);
+}
+
+unsigned int SkyIndex::cell(const float x, const float y, const float z, const unsigned int depth)
+{
+	double direction[3] = {x, y, z};
+	normalize(direction);
+
+	// octahedron face (octant)
+	unsigned int result = (x < 0.0f ? 1 : 0) | (y < 0.0f ? 2 : 0) | (z < 0.0f ? 4 : 0);
+	double vertices[9];
+	cellVertices(result, 0, vertices);
+
+	// descend (directions on shared edges go to the first matching child)
+	for(unsigned int i = 0; i < depth; ++i) {
+		double child[9];
+		unsigned int k = 0;
+
+		for(; k < 3; ++k) {
+			subdivide(vertices, k, child);
+			if(contains(child, direction)) break;
+		}
+		if(k == 3) subdivide(vertices, k, child);
+
+		result = 4 * result + k;
+		for(int j = 0; j < 9; ++j) vertices[j] = child[j];
+	}
+
+	return result;
+}
+
+void SkyIndex::vertices(const unsigned int cell, const unsigned int depth, float vertices[9])
+{
+	double corners[9];
+	cellVertices(cell, depth, corners);
+
+	for(int i = 0; i < 9; ++i) vertices[i] = (float) corners[i];
+}
+
+void SkyIndex::bounds(const unsigned int cell, const unsigned int depth, float axis[3], float &cosAngle)
+{
+	double corners[9];
+	cellVertices(cell, depth, corners);
+
+	// the cell is the spherical convex hull of its corners, the cone through them contains it
+	double centre[3] = {
+		corners[0] + corners[3] + corners[6],
+		corners[1] + corners[4] + corners[7],
+		corners[2] + corners[5] + corners[8]
+	};
+	normalize(centre);
+
+	double minimum = 1.0;
+	for(int i = 0; i < 9; i += 3) {
+		const double product = centre[0] * corners[i] + centre[1] * corners[i+1] + centre[2] * corners[i+2];
+		if(product < minimum) minimum = product;
+	}
+
+	axis[0] = (float) centre[0];
+	axis[1] = (float) centre[1];
+	axis[2] = (float) centre[2];
+
+	// widen slightly to compensate for the single precision results
+	cosAngle = (float) (minimum - 1e-6);
+}
+
+void SkyIndex::cellVertices(const unsigned int cell, const unsigned int depth, double vertices[9])
+{
+	// octahedron face (octant)
+	const unsigned int face = cell >> (2 * depth);
+	const double x = face & 1 ? -1.0 : 1.0;
+	const double y = face & 2 ? -1.0 : 1.0;
+	const double z = face & 4 ? -1.0 : 1.0;
+
+	double corners[9] = {
+		x, 0.0, 0.0,
+		0.0, y, 0.0,
+		0.0, 0.0, z
+	};
+
+	// follow the path of children (most significant first)
+	for(unsigned int i = depth; i > 0; --i) {
+		subdivide(corners, (cell >> (2 * (i - 1))) & 3, vertices);
+		for(int j = 0; j < 9; ++j) corners[j] = vertices[j];
+	}
+
+	for(int j = 0; j < 9; ++j) vertices[j] = corners[j];
+}
+
+void SkyIndex::subdivide(const double parent[9], const unsigned int child, double vertices[9])
+{
+	// edge midpoints (opposite to the corners)
+	double midpoints[9];
+	midpoint(parent + 3, parent + 6, midpoints);
+	midpoint(parent, parent + 6, midpoints + 3);
+	midpoint(parent, parent + 3, midpoints + 6);
+
+	// corner children share one corner with the parent, the fourth one is the central triangle
+	static const int corners[4][3] = {{0, 8, 7}, {1, 6, 8}, {2, 7, 6}, {6, 7, 8}};
+	for(int i = 0; i < 3; ++i) {
+		const int corner = corners[child][i];
+		const double *source = corner < 3 ? parent + 3 * corner : midpoints + 3 * (corner - 6);
+		vertices[3*i] = source[0];
+		vertices[3*i+1] = source[1];
+		vertices[3*i+2] = source[2];
+	}
+}
+
+bool SkyIndex::contains(const double vertices[9], const double direction[3])
+{
+	// orientation agnostic: the direction has to be on the inner side of all edges
+	const double orientation = tripleProduct(vertices, vertices + 3, vertices + 6) < 0.0 ? -1.0 : 1.0;
+
+	return orientation * tripleProduct(vertices, vertices + 3, direction) >= 0.0
+		&& orientation * tripleProduct(vertices + 3, vertices + 6, direction) >= 0.0
+		&& orientation * tripleProduct(vertices + 6, vertices, direction) >= 0.0;
+}
@@ -0,0 +1,126 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef SKYINDEX_H_
+#define SKYINDEX_H_
+
+/**
+ * \addtogroup starsphere Starsphere
+ * @{
+ */
+
+/**
+ * \brief Hierarchical triangular mesh (HTM) partitioning of the sky
+ *
+ * The unit sphere is divided into the eight faces of an octahedron (depth 0). Every
+ * cell (spherical triangle, "trixel") is recursively divided into four children by
+ * connecting the midpoints of its edges, hence there are <code>8 * 4^depth</code> cells
+ * of roughly equal area at a given depth. Cells are numbered such that the children
+ * of cell \c c are <code>4 * c + 0..3</code> at the next depth.
+ *
+ * The index is shared by the star catalog compiler (assigning catalog entries to cells)
+ * and the renderer (selecting visible cells by their bounding cones, see ViewFrustum).
+ *
+ * \author Oliver Bock\n
+ * Max-Planck-Institute for Gravitational Physics\n
+ * Hannover, Germany
+ */
+class SkyIndex
+{
+public:
+	/// Maximum supported depth (cell numbers have to fit into 32 bits)
+	static const unsigned int MaxDepth = 14;
+
+	/**
+	 * \brief Retrieve the number of cells at the given depth
+	 *
+	 * \param depth The depth (0 to \ref MaxDepth)
+	 *
+	 * \return The number of cells
+	 */
+	static unsigned int cellCount(const unsigned int depth);
+
+	/**
+	 * \brief Determines the cell containing the given direction
+	 *
+	 * \param x The x coordinate of the direction (needn't be normalized)
+	 * \param y The y coordinate of the direction
+	 * \param z The z coordinate of the direction
+	 * \param depth The depth of the requested cell
+	 *
+	 * \return The cell number
+	 */
+	static unsigned int cell(const float x, const float y, const float z, const unsigned int depth);
+
+	/**
+	 * \brief Computes the corners of a cell
+	 *
+	 * \param cell The cell number
+	 * \param depth The depth of the cell
+	 * \param vertices The buffer receiving the three unit vectors (x, y, z interleaved)
+	 */
+	static void vertices(const unsigned int cell, const unsigned int depth, float vertices[9]);
+
+	/**
+	 * \brief Computes the bounding cone of a cell
+	 *
+	 * The cone's apex is the centre of the sphere, every direction within the cell
+	 * satisfies <code>dot(axis, direction) >= cosAngle</code>.
+	 *
+	 * \param cell The cell number
+	 * \param depth The depth of the cell
+	 * \param axis The buffer receiving the cone's axis (unit vector)
+	 * \param cosAngle The cosine of the cone's half opening angle
+	 */
+	static void bounds(const unsigned int cell, const unsigned int depth, float axis[3], float &cosAngle);
+
+private:
+	/**
+	 * \brief Computes the corners of a cell (double precision)
+	 *
+	 * \see vertices()
+	 */
+	static void cellVertices(const unsigned int cell, const unsigned int depth, double vertices[9]);
+
+	/**
+	 * \brief Computes the corners of a child cell
+	 *
+	 * \param parent The corners of the parent cell
+	 * \param child The child (0 to 3)
+	 * \param vertices The buffer receiving the corners of the child cell
+	 */
+	static void subdivide(const double parent[9], const unsigned int child, double vertices[9]);
+
+	/**
+	 * \brief Checks whether a direction lies within a spherical triangle (edges inclusive)
+	 *
+	 * \param vertices The corners of the triangle
+	 * \param direction The direction to check
+	 *
+	 * \return TRUE if the direction lies within the triangle, otherwise FALSE
+	 */
+	static bool contains(const double vertices[9], const double direction[3]);
+};
+
+/**
+ * @}
+ */
+
+#endif /*SKYINDEX_H_*/
@@ -0,0 +1,393 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "SkyTileStore.h"
+
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <algorithm>
+
+#include "SkyIndex.h"
+
+/// Least recently used order of tiles
+struct TileUsageOrder {
+	bool operator()(const SkyTileStore::Tile *first, const SkyTileStore::Tile *second) const {
+		return first->lastUsed < second->lastUsed;
+	}
+};
+
+SkyTileStore::Tile::Tile(const unsigned int level, const unsigned int cell) : batch(GL_POINTS)
+{
+	this->level = level;
+	this->cell = cell;
+	generated = false;
+	loaded = false;
+	lastUsed = 0;
+}
+
+SkyTileStore::SkyTileStore(const size_t byteBudget)
+{
+	m_File = NULL;
+	memset(&m_Header, 0, sizeof(m_Header));
+	m_ByteBudget = byteBudget;
+	m_ResidentBytes = 0;
+	m_Frame = 0;
+	m_Mutex = SDL_CreateMutex();
+	m_Condition = SDL_CreateCond();
+	m_Thread = NULL;
+	m_Running = false;
+}
+
+SkyTileStore::~SkyTileStore()
+{
+	close();
+
+	SDL_DestroyCond(m_Condition);
+	SDL_DestroyMutex(m_Mutex);
+}
+
+bool SkyTileStore::open(const string filename)
+{
+	close();
+
+	if(!m_Mutex || !m_Condition) return false;
+
+	FILE *file = fopen(filename.c_str(), "rb");
+	if(!file) return false;
+
+	SkyTileFile::Header header;
+	vector<SkyTileFile::Tile> index;
+	vector<size_t> levelStart(1, 0);
+	bool valid = fread(&header, sizeof(header), 1, file) == 1;
+
+	// check header
+	valid = valid && header.magic == SkyTileFile::Magic && header.version == SkyTileFile::Version;
+	valid = valid && header.levelCount >= 1 && header.levelCount <= SkyTileFile::MaxLevels;
+
+	for(unsigned int i = 0; valid && i < header.levelCount; ++i) {
+		valid = header.magnitudeLimit[i] - header.magnitudeLimit[i] == 0.0f;
+		valid = valid && (i == 0 || header.magnitudeLimit[i-1] <= header.magnitudeLimit[i]);
+		levelStart.push_back(levelStart.back() + SkyIndex::cellCount(i));
+	}
+
+	valid = valid && fseek(file, 0, SEEK_END) == 0 && ftell(file) >= 0 && (uint64_t) ftell(file) == header.fileSize;
+
+	// check index (bounds, entries following the index)
+	const uint64_t size = header.fileSize;
+	const size_t tileCount = levelStart.back();
+
+	valid = valid && header.indexOffset >= sizeof(header) && header.indexOffset <= size;
+	valid = valid && tileCount <= (size - header.indexOffset) / sizeof(SkyTileFile::Tile);
+
+	if(valid) {
+		index.resize(tileCount);
+		valid = fseek(file, (long) header.indexOffset, SEEK_SET) == 0 &&
+				fread(&index[0], sizeof(SkyTileFile::Tile), tileCount, file) == tileCount;
+	}
+
+	const uint64_t dataOffset = header.indexOffset + tileCount * sizeof(SkyTileFile::Tile);
+	for(size_t i = 0; valid && i < tileCount; ++i) {
+		if(index[i].count == 0) continue;
+		valid = index[i].offset >= dataOffset && index[i].offset <= size &&
+				index[i].count <= (size - index[i].offset) / sizeof(SkyTileFile::Star);
+	}
+
+	if(!valid) {
+		cerr << "Tiled star catalog \"" << filename << "\" is invalid, ignoring it!" << endl;
+		fclose(file);
+		return false;
+	}
+
+	m_File = file;
+	m_Header = header;
+	m_Index.swap(index);
+	m_LevelStart.swap(levelStart);
+
+	// start reading tiles in the background
+	m_Running = true;
+	m_Thread = SDL_CreateThread(&run, this);
+
+	if(!m_Thread) {
+		cerr << "Tile worker thread could not be created: " << SDL_GetError() << endl;
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+void SkyTileStore::close()
+{
+	// stop worker thread
+	if(m_Thread) {
+		SDL_mutexP(m_Mutex);
+		m_Running = false;
+		SDL_CondSignal(m_Condition);
+		SDL_mutexV(m_Mutex);
+
+		SDL_WaitThread(m_Thread, NULL);
+		m_Thread = NULL;
+	}
+
+	// all tiles (including queued and completed ones) are known to the render thread
+	for(map<size_t, Tile*>::iterator i = m_Tiles.begin(); i != m_Tiles.end(); ++i) {
+		delete i->second;
+	}
+
+	m_Tiles.clear();
+	m_VisibleTiles.clear();
+	m_Requests.clear();
+	m_Completed.clear();
+	m_Index.clear();
+	m_LevelStart.clear();
+	m_ResidentBytes = 0;
+
+	if(m_File) {
+		fclose(m_File);
+		m_File = NULL;
+	}
+}
+
+bool SkyTileStore::isOpen() const
+{
+	return m_File != NULL;
+}
+
+unsigned int SkyTileStore::levelCount() const
+{
+	return m_File ? m_Header.levelCount : 0;
+}
+
+float SkyTileStore::magnitudeLimit(const unsigned int level) const
+{
+	return m_Header.magnitudeLimit[min(level, SkyTileFile::MaxLevels - 1)];
+}
+
+void SkyTileStore::update(const ViewFrustum &frustum, const GLfloat radius, const unsigned int maxLevel)
+{
+	if(!m_File) return;
+
+	synchronize();
+
+	// select tiles, starting with the octahedron faces
+	++m_Frame;
+	m_VisibleTiles.clear();
+
+	for(unsigned int cell = 0; cell < SkyIndex::cellCount(0); ++cell) {
+		select(frustum, radius, maxLevel, 0, cell);
+	}
+
+	// queue new tiles, discard those no longer selected (unless already being read)
+	SDL_mutexP(m_Mutex);
+
+	deque<Tile*>::iterator request = m_Requests.begin();
+	while(request != m_Requests.end()) {
+		if((*request)->lastUsed != m_Frame) {
+			m_Tiles.erase(m_LevelStart[(*request)->level] + (*request)->cell);
+			delete *request;
+			request = m_Requests.erase(request);
+		}
+		else {
+			++request;
+		}
+	}
+
+	m_Requests.insert(m_Requests.end(), m_NewTiles.begin(), m_NewTiles.end());
+	if(!m_NewTiles.empty()) SDL_CondSignal(m_Condition);
+
+	SDL_mutexV(m_Mutex);
+
+	m_NewTiles.clear();
+
+	evict();
+}
+
+void SkyTileStore::select(const ViewFrustum &frustum, const GLfloat radius, const unsigned int maxLevel,
+						  const unsigned int level, const unsigned int cell)
+{
+	GLfloat axis[3], cosAngle;
+	SkyIndex::bounds(cell, level, axis, cosAngle);
+
+	if(!frustum.intersectsCap(axis, cosAngle, radius)) return;
+
+	// empty tiles aren't requested (their children might not be empty)
+	const size_t number = m_LevelStart[level] + cell;
+	if(m_Index[number].count > 0) {
+		Tile *tile;
+		map<size_t, Tile*>::iterator i = m_Tiles.find(number);
+
+		if(i == m_Tiles.end()) {
+			tile = new Tile(level, cell);
+			m_Tiles[number] = tile;
+			m_NewTiles.push_back(tile);
+		}
+		else {
+			tile = i->second;
+		}
+
+		tile->lastUsed = m_Frame;
+		if(tile->loaded) m_VisibleTiles.push_back(tile);
+	}
+
+	if(level + 1 >= m_Header.levelCount || level + 1 > maxLevel) return;
+
+	// projected size of the cap's bounding sphere (see ViewFrustum::intersectsCap())
+	const GLfloat sinAngle = sqrt(max(0.0f, 1.0f - cosAngle * cosAngle));
+	const GLfloat capRadius = radius * (cosAngle > 0.0f ? sinAngle : 1.0f);
+	const GLfloat *eye = frustum.eye();
+	const GLfloat offset[3] = {
+		eye[0] - axis[0] * radius * max(0.0f, cosAngle),
+		eye[1] - axis[1] * radius * max(0.0f, cosAngle),
+		eye[2] - axis[2] * radius * max(0.0f, cosAngle)
+	};
+	const GLfloat distance = sqrt(offset[0] * offset[0] + offset[1] * offset[1] + offset[2] * offset[2]) - capRadius;
+
+	if(distance <= 0.0f || 2.0f * capRadius / distance * frustum.pixelScale() >= RefinementSize) {
+		for(unsigned int child = 0; child < 4; ++child) {
+			select(frustum, radius, maxLevel, level + 1, 4 * cell + child);
+		}
+	}
+}
+
+void SkyTileStore::synchronize()
+{
+	vector<Tile*> completed;
+
+	SDL_mutexP(m_Mutex);
+	completed.swap(m_Completed);
+	SDL_mutexV(m_Mutex);
+
+	for(size_t i = 0; i < completed.size(); ++i) {
+		completed[i]->loaded = true;
+		m_ResidentBytes += tileBytes(completed[i]);
+	}
+}
+
+void SkyTileStore::evict()
+{
+	if(m_ResidentBytes <= m_ByteBudget) return;
+
+	// candidates: loaded tiles not selected for the current frame
+	vector<Tile*> candidates;
+	for(map<size_t, Tile*>::iterator i = m_Tiles.begin(); i != m_Tiles.end(); ++i) {
+		if(i->second->loaded && i->second->lastUsed != m_Frame) candidates.push_back(i->second);
+	}
+
+	sort(candidates.begin(), candidates.end(), TileUsageOrder());
+
+	for(size_t i = 0; i < candidates.size() && m_ResidentBytes > m_ByteBudget; ++i) {
+		m_ResidentBytes -= tileBytes(candidates[i]);
+		m_Tiles.erase(m_LevelStart[candidates[i]->level] + candidates[i]->cell);
+		delete candidates[i];
+	}
+}
+
+void SkyTileStore::clear()
+{
+	map<size_t, Tile*>::iterator i = m_Tiles.begin();
+	while(i != m_Tiles.end()) {
+		if(i->second->loaded) {
+			m_ResidentBytes -= tileBytes(i->second);
+
+			// the buffer object died with the previous context (its name might be reused)
+			i->second->batch.invalidate();
+			delete i->second;
+			m_Tiles.erase(i++);
+		}
+		else {
+			++i;
+		}
+	}
+
+	m_VisibleTiles.clear();
+}
+
+const vector<SkyTileStore::Tile*>& SkyTileStore::visibleTiles() const
+{
+	return m_VisibleTiles;
+}
+
+size_t SkyTileStore::residentBytes() const
+{
+	return m_ResidentBytes;
+}
+
+size_t SkyTileStore::tileBytes(const Tile *tile) const
+{
+	// entries plus their interleaved vertices (client-side copy)
+	return sizeof(Tile) + tile->stars.size() * (sizeof(SkyTileFile::Star) + 6 * sizeof(GLfloat));
+}
+
+const SkyTileFile::Tile& SkyTileStore::indexEntry(const unsigned int level, const unsigned int cell) const
+{
+	return m_Index[m_LevelStart[level] + cell];
+}
+
+void SkyTileStore::read(Tile *tile)
+{
+	const SkyTileFile::Tile &entry = indexEntry(tile->level, tile->cell);
+	vector<SkyTileFile::Star> stars(entry.count);
+
+	bool valid = fseek(m_File, (long) entry.offset, SEEK_SET) == 0 &&
+				 fread(&stars[0], sizeof(SkyTileFile::Star), entry.count, m_File) == entry.count;
+
+	// check entries (finite, sorted)
+	for(size_t i = 0; valid && i < stars.size(); ++i) {
+		valid = stars[i].x - stars[i].x == 0.0f && stars[i].y - stars[i].y == 0.0f &&
+				stars[i].z - stars[i].z == 0.0f && stars[i].magnitude - stars[i].magnitude == 0.0f;
+		valid = valid && (i == 0 || stars[i-1].magnitude <= stars[i].magnitude);
+	}
+
+	if(!valid) {
+		cerr << "Tile " << tile->cell << " (level " << tile->level << ") couldn't be read, ignoring it!" << endl;
+		stars.clear();
+	}
+
+	tile->stars.swap(stars);
+}
+
+int SkyTileStore::run(void *data)
+{
+	SkyTileStore *store = static_cast<SkyTileStore*>(data);
+
+	SDL_mutexP(store->m_Mutex);
+
+	while(store->m_Running) {
+		if(store->m_Requests.empty()) {
+			SDL_CondWait(store->m_Condition, store->m_Mutex);
+			continue;
+		}
+
+		Tile *tile = store->m_Requests.front();
+		store->m_Requests.pop_front();
+
+		// the render thread doesn't touch tiles that are neither queued nor completed
+		SDL_mutexV(store->m_Mutex);
+		store->read(tile);
+		SDL_mutexP(store->m_Mutex);
+
+		store->m_Completed.push_back(tile);
+	}
+
+	SDL_mutexV(store->m_Mutex);
+
+	return 0;
+}
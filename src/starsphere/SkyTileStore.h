@@ -0,0 +1,279 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef SKYTILESTORE_H_
+#define SKYTILESTORE_H_
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+
+#include <SDL.h>
+#include <SDL_thread.h>
+#include <SDL_opengl.h>
+
+#include "StarCatalog.h"
+#include "VertexBatch.h"
+#include "ViewFrustum.h"
+
+using namespace std;
+
+/**
+ * \addtogroup starsphere Starsphere
+ * @{
+ */
+
+/**
+ * \brief View dependent cache of the tiles of a tiled star catalog file
+ *
+ * The store keeps only the tiles (see SkyTileFile) required for the current view in memory:
+ * - \ref update() selects the tiles intersecting the view frustum, refining from one level
+ *   to the next as long as a tile covers more than \ref RefinementSize pixels on screen.
+ *   Zooming in therefore reveals fainter entries, but only in the region being looked at.
+ * - Missing tiles are read by a worker thread, so file access never stalls a frame. Requests
+ *   for tiles that went out of view before being read are discarded.
+ * - Loaded tiles are evicted in least recently used order as soon as the resident tiles
+ *   exceed the byte budget (tiles selected for the current frame are never evicted).
+ *
+ * The render thread owns all tiles that are neither queued nor being read. It creates
+ * their vertex batches lazily (see Tile).
+ *
+ * \author Oliver Bock\n
+ * Max-Planck-Institute for Gravitational Physics\n
+ * Hannover, Germany
+ */
+class SkyTileStore
+{
+public:
+	/// Resident tile
+	struct Tile {
+		/// Constructor
+		Tile(const unsigned int level, const unsigned int cell);
+
+		/// The level of the tile (equals the SkyIndex depth of its cell)
+		unsigned int level;
+
+		/// The SkyIndex cell of the tile
+		unsigned int cell;
+
+		/// The entries of the tile (sorted by magnitude, filled by the worker thread)
+		vector<SkyTileFile::Star> stars;
+
+		/// The vertex batch of the tile (render thread, see \ref generated)
+		VertexBatch batch;
+
+		/// Indicator whether \ref batch has been created
+		bool generated;
+
+		/// Indicator whether the tile has been read (set once the render thread picked it up)
+		bool loaded;
+
+		/// The number of the frame the tile has been selected last
+		unsigned int lastUsed;
+	};
+
+	/**
+	 * \brief Constructor
+	 *
+	 * \param byteBudget The memory (in bytes) the resident tiles should not exceed
+	 */
+	SkyTileStore(const size_t byteBudget = 32 << 20);
+
+	/// Destructor (stops the worker thread and deletes all tiles)
+	virtual ~SkyTileStore();
+
+	/**
+	 * \brief Opens and validates a tiled star catalog file and starts the worker thread
+	 *
+	 * \param filename The name of the tiled star catalog file
+	 *
+	 * \return TRUE if successful, otherwise FALSE
+	 */
+	bool open(const string filename);
+
+	/**
+	 * \brief Query whether a tiled star catalog file has been opened
+	 *
+	 * \return TRUE if a file is available, otherwise FALSE
+	 */
+	bool isOpen() const;
+
+	/**
+	 * \brief Retrieve the number of levels of the opened file
+	 *
+	 * \return The number of levels
+	 */
+	unsigned int levelCount() const;
+
+	/**
+	 * \brief Retrieve the faintest magnitude of a level
+	 *
+	 * \param level The level
+	 *
+	 * \return The magnitude limit of the level
+	 */
+	float magnitudeLimit(const unsigned int level) const;
+
+	/**
+	 * \brief Selects, requests and evicts tiles for the current view
+	 *
+	 * \param frustum The view frustum (sky coordinates)
+	 * \param radius The radius of the sky sphere
+	 * \param maxLevel The deepest level to be used
+	 */
+	void update(const ViewFrustum &frustum, const GLfloat radius, const unsigned int maxLevel);
+
+	/**
+	 * \brief Retrieve the loaded tiles selected by the last \ref update()
+	 *
+	 * \return The tiles (in selection order, parents precede their children)
+	 */
+	const vector<Tile*>& visibleTiles() const;
+
+	/**
+	 * \brief Retrieve the memory occupied by the resident tiles
+	 *
+	 * \return The memory (in bytes)
+	 */
+	size_t residentBytes() const;
+
+	/**
+	 * \brief Deletes all tiles that aren't queued or being read
+	 *
+	 * This is required when the OpenGL context has been recreated (windoze).
+	 */
+	void clear();
+
+	/// Minimum size (in pixels) of a tile on screen that causes the next level to be selected
+	static const int RefinementSize = 320;
+
+private:
+	/**
+	 * \brief Selects a tile and (if sufficiently large on screen) its children
+	 *
+	 * \param frustum The view frustum
+	 * \param radius The radius of the sky sphere
+	 * \param maxLevel The deepest level to be used
+	 * \param level The level of the tile
+	 * \param cell The cell of the tile
+	 */
+	void select(const ViewFrustum &frustum, const GLfloat radius, const unsigned int maxLevel,
+				const unsigned int level, const unsigned int cell);
+
+	/// Picks up tiles read by the worker thread and discards stale requests
+	void synchronize();
+
+	/// Evicts least recently used tiles until the byte budget is met
+	void evict();
+
+	/**
+	 * \brief Reads a tile from the file (worker thread)
+	 *
+	 * \param tile The tile to be read
+	 */
+	void read(Tile *tile);
+
+	/**
+	 * \brief Retrieve the memory occupied by a tile
+	 *
+	 * \param tile The tile
+	 *
+	 * \return The memory (in bytes)
+	 */
+	size_t tileBytes(const Tile *tile) const;
+
+	/**
+	 * \brief Retrieve the index entry of a tile
+	 *
+	 * \param level The level of the tile
+	 * \param cell The cell of the tile
+	 *
+	 * \return The index entry
+	 */
+	const SkyTileFile::Tile& indexEntry(const unsigned int level, const unsigned int cell) const;
+
+	/**
+	 * \brief The worker thread's main function
+	 *
+	 * \param data Pointer to the %SkyTileStore instance
+	 *
+	 * \return Always zero
+	 */
+	static int run(void *data);
+
+	/// Stops the worker thread, deletes all tiles and closes the file
+	void close();
+
+	/// The tiled star catalog file (read by the worker thread once started)
+	FILE *m_File;
+
+	/// The file header
+	SkyTileFile::Header m_Header;
+
+	/// The file index
+	vector<SkyTileFile::Tile> m_Index;
+
+	/// First index entry of every level
+	vector<size_t> m_LevelStart;
+
+	/// All tiles known to the render thread, keyed by their index entry number
+	map<size_t, Tile*> m_Tiles;
+
+	/// The loaded tiles selected by the last update
+	vector<Tile*> m_VisibleTiles;
+
+	/// The tiles created by the current update (to be queued)
+	vector<Tile*> m_NewTiles;
+
+	/// The memory budget (in bytes)
+	size_t m_ByteBudget;
+
+	/// The memory occupied by the loaded tiles (in bytes)
+	size_t m_ResidentBytes;
+
+	/// The number of the current frame
+	unsigned int m_Frame;
+
+	/// Tiles waiting to be read (guarded by \ref m_Mutex)
+	deque<Tile*> m_Requests;
+
+	/// Tiles read by the worker thread (guarded by \ref m_Mutex)
+	vector<Tile*> m_Completed;
+
+	/// Mutex guarding the request and completion queues
+	SDL_mutex *m_Mutex;
+
+	/// Condition signalling new requests (or stop)
+	SDL_cond *m_Condition;
+
+	/// The worker thread handle
+	SDL_Thread *m_Thread;
+
+	/// Run indicator (cleared to stop the worker thread, guarded by \ref m_Mutex)
+	bool m_Running;
+};
+
+/**
+ * @}
+ */
+
+#endif /*SKYTILESTORE_H_*/
@@ -0,0 +1,309 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "SphericalCoordinates.h"
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define SPHERICALCOORDINATES_X86
+#include <immintrin.h>
+#endif
+
+#if defined(__GNUC__) && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#define SPHERICALCOORDINATES_NEON
+#include <arm_neon.h>
+#endif
+
+SphericalCoordinates::CodePath SphericalCoordinates::m_CodePath = SphericalCoordinates::CodePathAuto;
+
+/// Degrees to radians
+static const float Radians = 3.14159265358979323846f / 180.0f;
+
+/// Minimax coefficients of sin(x) on [-pi/4, pi/4] (Cephes)
+static const float SinCoefficients[3] = {-1.9515295891e-4f, 8.3321608736e-3f, -1.6666654611e-1f};
+
+/// Minimax coefficients of cos(x) on [-pi/4, pi/4] (Cephes)
+static const float CosCoefficients[3] = {2.443315711809948e-5f, -1.388731625493765e-3f, 4.166664568298827e-2f};
+
+/**
+ * Computes sine and cosine of an angle given in degrees (scalar)
+ */
+static inline void sinCosScalar(const float degrees, float &sine, float &cosine)
+{
+	// nearest multiple of 90 degrees (quadrant) and remainder in radians
+	const float quotient = degrees * (1.0f / 90.0f);
+	const int quadrant = (int) (quotient + (quotient < 0.0f ? -0.5f : 0.5f));
+	const float x = (degrees - quadrant * 90.0f) * Radians;
+	const float z = x * x;
+
+	const float s = ((SinCoefficients[0] * z + SinCoefficients[1]) * z + SinCoefficients[2]) * z * x + x;
+	const float c = ((CosCoefficients[0] * z + CosCoefficients[1]) * z + CosCoefficients[2]) * z * z - 0.5f * z + 1.0f;
+
+	// odd quadrants swap sine and cosine, the signs follow the quadrant
+	sine = quadrant & 1 ? c : s;
+	cosine = quadrant & 1 ? s : c;
+	if(quadrant & 2) sine = -sine;
+	if((quadrant + 1) & 2) cosine = -cosine;
+}
+
+#ifdef SPHERICALCOORDINATES_X86
+
+/**
+ * Computes sine and cosine of four angles given in degrees (SSE2)
+ */
+__attribute__((target("sse2")))
+static inline void sinCosSSE2(const __m128 degrees, __m128 &sine, __m128 &cosine)
+{
+	const __m128i quadrant = _mm_cvtps_epi32(_mm_mul_ps(degrees, _mm_set1_ps(1.0f / 90.0f)));
+	const __m128 x = _mm_mul_ps(_mm_sub_ps(degrees, _mm_mul_ps(_mm_cvtepi32_ps(quadrant), _mm_set1_ps(90.0f))),
+								_mm_set1_ps(Radians));
+	const __m128 z = _mm_mul_ps(x, x);
+
+	__m128 s = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(SinCoefficients[0]), z), _mm_set1_ps(SinCoefficients[1]));
+	s = _mm_add_ps(_mm_mul_ps(s, z), _mm_set1_ps(SinCoefficients[2]));
+	s = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(s, z), x), x);
+
+	__m128 c = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(CosCoefficients[0]), z), _mm_set1_ps(CosCoefficients[1]));
+	c = _mm_add_ps(_mm_mul_ps(c, z), _mm_set1_ps(CosCoefficients[2]));
+	c = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(_mm_mul_ps(c, z), z), _mm_mul_ps(_mm_set1_ps(0.5f), z)), _mm_set1_ps(1.0f));
+
+	// odd quadrants swap sine and cosine, the signs follow the quadrant
+	const __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+	const __m128 sineSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(2)), 30));
+	const __m128 cosineSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(2)), 30));
+
+	sine = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, c), _mm_andnot_ps(swap, s)), sineSign);
+	cosine = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, s), _mm_andnot_ps(swap, c)), cosineSign);
+}
+
+/**
+ * Converts four coordinates per iteration (SSE2)
+ *
+ * Returns the number of coordinates converted.
+ */
+__attribute__((target("sse2")))
+static size_t toCartesianSSE2(const float *rightAscension, const float *declination, const size_t count,
+							  const float radius, float *x, float *y, float *z)
+{
+	const __m128 r = _mm_set1_ps(radius);
+	size_t i = 0;
+
+	for(; i + 4 <= count; i += 4) {
+		__m128 sinRA, cosRA, sinDE, cosDE;
+		sinCosSSE2(_mm_loadu_ps(rightAscension + i), sinRA, cosRA);
+		sinCosSSE2(_mm_loadu_ps(declination + i), sinDE, cosDE);
+
+		const __m128 projection = _mm_mul_ps(r, cosDE);
+		_mm_storeu_ps(x + i, _mm_mul_ps(projection, cosRA));
+		_mm_storeu_ps(y + i, _mm_mul_ps(r, sinDE));
+		_mm_storeu_ps(z + i, _mm_xor_ps(_mm_mul_ps(projection, sinRA), _mm_set1_ps(-0.0f)));
+	}
+
+	return i;
+}
+
+/**
+ * Computes sine and cosine of eight angles given in degrees (AVX2)
+ */
+__attribute__((target("avx2")))
+static inline void sinCosAVX2(const __m256 degrees, __m256 &sine, __m256 &cosine)
+{
+	const __m256i quadrant = _mm256_cvtps_epi32(_mm256_mul_ps(degrees, _mm256_set1_ps(1.0f / 90.0f)));
+	const __m256 x = _mm256_mul_ps(_mm256_sub_ps(degrees, _mm256_mul_ps(_mm256_cvtepi32_ps(quadrant), _mm256_set1_ps(90.0f))),
+								   _mm256_set1_ps(Radians));
+	const __m256 z = _mm256_mul_ps(x, x);
+
+	__m256 s = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(SinCoefficients[0]), z), _mm256_set1_ps(SinCoefficients[1]));
+	s = _mm256_add_ps(_mm256_mul_ps(s, z), _mm256_set1_ps(SinCoefficients[2]));
+	s = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(s, z), x), x);
+
+	__m256 c = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(CosCoefficients[0]), z), _mm256_set1_ps(CosCoefficients[1]));
+	c = _mm256_add_ps(_mm256_mul_ps(c, z), _mm256_set1_ps(CosCoefficients[2]));
+	c = _mm256_add_ps(_mm256_sub_ps(_mm256_mul_ps(_mm256_mul_ps(c, z), z), _mm256_mul_ps(_mm256_set1_ps(0.5f), z)), _mm256_set1_ps(1.0f));
+
+	// odd quadrants swap sine and cosine, the signs follow the quadrant
+	const __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(quadrant, _mm256_set1_epi32(1)), _mm256_set1_epi32(1)));
+	const __m256 sineSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(quadrant, _mm256_set1_epi32(2)), 30));
+	const __m256 cosineSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(quadrant, _mm256_set1_epi32(1)), _mm256_set1_epi32(2)), 30));
+
+	sine = _mm256_xor_ps(_mm256_blendv_ps(s, c, swap), sineSign);
+	cosine = _mm256_xor_ps(_mm256_blendv_ps(c, s, swap), cosineSign);
+}
+
+/**
+ * Converts eight coordinates per iteration (AVX2)
+ *
+ * Returns the number of coordinates converted.
+ */
+__attribute__((target("avx2")))
+static size_t toCartesianAVX2(const float *rightAscension, const float *declination, const size_t count,
+							  const float radius, float *x, float *y, float *z)
+{
+	const __m256 r = _mm256_set1_ps(radius);
+	size_t i = 0;
+
+	for(; i + 8 <= count; i += 8) {
+		__m256 sinRA, cosRA, sinDE, cosDE;
+		sinCosAVX2(_mm256_loadu_ps(rightAscension + i), sinRA, cosRA);
+		sinCosAVX2(_mm256_loadu_ps(declination + i), sinDE, cosDE);
+
+		const __m256 projection = _mm256_mul_ps(r, cosDE);
+		_mm256_storeu_ps(x + i, _mm256_mul_ps(projection, cosRA));
+		_mm256_storeu_ps(y + i, _mm256_mul_ps(r, sinDE));
+		_mm256_storeu_ps(z + i, _mm256_xor_ps(_mm256_mul_ps(projection, sinRA), _mm256_set1_ps(-0.0f)));
+	}
+
+	_mm256_zeroupper();
+
+	return i;
+}
+
+#endif
+
+#ifdef SPHERICALCOORDINATES_NEON
+
+/**
+ * Computes sine and cosine of four angles given in degrees (NEON)
+ */
+static inline void sinCosNEON(const float32x4_t degrees, float32x4_t &sine, float32x4_t &cosine)
+{
+	// round to nearest (ARMv7 only truncates): add 0.5 with the sign of the quotient
+	const float32x4_t quotient = vmulq_n_f32(degrees, 1.0f / 90.0f);
+	const uint32x4_t signBit = vandq_u32(vreinterpretq_u32_f32(quotient), vdupq_n_u32(0x80000000));
+	const float32x4_t half = vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(vdupq_n_f32(0.5f)), signBit));
+	const int32x4_t quadrant = vcvtq_s32_f32(vaddq_f32(quotient, half));
+
+	const float32x4_t x = vmulq_n_f32(vsubq_f32(degrees, vmulq_n_f32(vcvtq_f32_s32(quadrant), 90.0f)), Radians);
+	const float32x4_t z = vmulq_f32(x, x);
+
+	float32x4_t s = vaddq_f32(vmulq_n_f32(z, SinCoefficients[0]), vdupq_n_f32(SinCoefficients[1]));
+	s = vaddq_f32(vmulq_f32(s, z), vdupq_n_f32(SinCoefficients[2]));
+	s = vaddq_f32(vmulq_f32(vmulq_f32(s, z), x), x);
+
+	float32x4_t c = vaddq_f32(vmulq_n_f32(z, CosCoefficients[0]), vdupq_n_f32(CosCoefficients[1]));
+	c = vaddq_f32(vmulq_f32(c, z), vdupq_n_f32(CosCoefficients[2]));
+	c = vaddq_f32(vsubq_f32(vmulq_f32(vmulq_f32(c, z), z), vmulq_n_f32(z, 0.5f)), vdupq_n_f32(1.0f));
+
+	// odd quadrants swap sine and cosine, the signs follow the quadrant
+	const uint32x4_t swap = vtstq_s32(quadrant, vdupq_n_s32(1));
+	const uint32x4_t sineSign = vshlq_n_u32(vreinterpretq_u32_s32(vandq_s32(quadrant, vdupq_n_s32(2))), 30);
+	const uint32x4_t cosineSign = vshlq_n_u32(vreinterpretq_u32_s32(vandq_s32(vaddq_s32(quadrant, vdupq_n_s32(1)), vdupq_n_s32(2))), 30);
+
+	sine = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(vbslq_f32(swap, c, s)), sineSign));
+	cosine = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(vbslq_f32(swap, s, c)), cosineSign));
+}
+
+/**
+ * Converts four coordinates per iteration (NEON)
+ *
+ * Returns the number of coordinates converted.
+ */
+static size_t toCartesianNEON(const float *rightAscension, const float *declination, const size_t count,
+							  const float radius, float *x, float *y, float *z)
+{
+	size_t i = 0;
+
+	for(; i + 4 <= count; i += 4) {
+		float32x4_t sinRA, cosRA, sinDE, cosDE;
+		sinCosNEON(vld1q_f32(rightAscension + i), sinRA, cosRA);
+		sinCosNEON(vld1q_f32(declination + i), sinDE, cosDE);
+
+		const float32x4_t projection = vmulq_n_f32(cosDE, radius);
+		vst1q_f32(x + i, vmulq_f32(projection, cosRA));
+		vst1q_f32(y + i, vmulq_n_f32(sinDE, radius));
+		vst1q_f32(z + i, vnegq_f32(vmulq_f32(projection, sinRA)));
+	}
+
+	return i;
+}
+
+#endif
+
+void SphericalCoordinates::toCartesian(const float *rightAscension, const float *declination, const size_t count,
+									   const float radius, float *x, float *y, float *z)
+{
+	size_t done = 0;
+
+	switch(codePath()) {
+#ifdef SPHERICALCOORDINATES_X86
+		case CodePathAVX2:
+			done = toCartesianAVX2(rightAscension, declination, count, radius, x, y, z);
+			break;
+		case CodePathSSE2:
+			done = toCartesianSSE2(rightAscension, declination, count, radius, x, y, z);
+			break;
+#endif
+#ifdef SPHERICALCOORDINATES_NEON
+		case CodePathNEON:
+			done = toCartesianNEON(rightAscension, declination, count, radius, x, y, z);
+			break;
+#endif
+		default:
+			break;
+	}
+
+	// remainder
+	toCartesianScalar(rightAscension + done, declination + done, count - done, radius, x + done, y + done, z + done);
+}
+
+void SphericalCoordinates::setCodePath(const CodePath codePath)
+{
+	m_CodePath = codePath;
+}
+
+SphericalCoordinates::CodePath SphericalCoordinates::codePath()
+{
+#ifdef SPHERICALCOORDINATES_X86
+	const bool avx2 = __builtin_cpu_supports("avx2");
+	const bool sse2 = __builtin_cpu_supports("sse2");
+
+	switch(m_CodePath) {
+		case CodePathScalar:
+			return CodePathScalar;
+		case CodePathSSE2:
+			if(sse2) return CodePathSSE2;
+			break;
+		default:
+			if(avx2) return CodePathAVX2;
+			if(sse2) return CodePathSSE2;
+			break;
+	}
+#endif
+
+#ifdef SPHERICALCOORDINATES_NEON
+	if(m_CodePath != CodePathScalar) return CodePathNEON;
+#endif
+
+	return CodePathScalar;
+}
+
+void SphericalCoordinates::toCartesianScalar(const float *rightAscension, const float *declination, const size_t count,
+											 const float radius, float *x, float *y, float *z)
+{
+	for(size_t i = 0; i < count; ++i) {
+		float sinRA, cosRA, sinDE, cosDE;
+		sinCosScalar(rightAscension[i], sinRA, cosRA);
+		sinCosScalar(declination[i], sinDE, cosDE);
+
+		const float projection = radius * cosDE;
+		x[i] = projection * cosRA;
+		y[i] = radius * sinDE;
+		z[i] = -(projection * sinRA);
+	}
+}
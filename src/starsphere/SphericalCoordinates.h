@@ -0,0 +1,122 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef SPHERICALCOORDINATES_H_
+#define SPHERICALCOORDINATES_H_
+
+#include <cstddef>
+
+/**
+ * \addtogroup starsphere Starsphere
+ * @{
+ */
+
+/**
+ * \brief Bulk conversion of sky coordinates into cartesian coordinates
+ *
+ * Converts arrays of right ascension and declination (in degrees) into positions on
+ * a sphere of the given radius, using the starsphere's cartesian frame:
+ * - <code>x = radius * cos(DE) * cos(RA)</code>
+ * - <code>y = radius * sin(DE)</code>
+ * - <code>z = -radius * cos(DE) * sin(RA)</code>
+ *
+ * Sine and cosine are computed together in single precision: the angle is reduced to
+ * [-45, 45] degrees (exact for the angles used here) and evaluated by minimax polynomials,
+ * which yields an absolute error below 1e-6 (compared to double precision libm) for angles
+ * within +/- 10^5 degrees.
+ *
+ * The conversion is vectorised: on x86 CPUs supporting AVX2 or SSE2 respectively on ARM CPUs
+ * supporting NEON wide code paths are used (x86 detected at runtime). All other CPUs and the
+ * remainders of the input use the scalar implementation of the same algorithm.
+ *
+ * \author Oliver Bock\n
+ * Max-Planck-Institute for Gravitational Physics\n
+ * Hannover, Germany
+ */
+class SphericalCoordinates
+{
+public:
+	/**
+	 * \brief Available code paths
+	 *
+	 * \see setCodePath()
+	 */
+	enum CodePath {
+		CodePathAuto,
+		CodePathScalar,
+		CodePathSSE2,
+		CodePathAVX2,
+		CodePathNEON
+	};
+
+	/**
+	 * \brief Converts sky coordinates into cartesian coordinates
+	 *
+	 * The output arrays may not overlap the input arrays.
+	 *
+	 * \param rightAscension Pointer to the right ascensions (degrees)
+	 * \param declination Pointer to the declinations (degrees)
+	 * \param count The number of coordinates to convert
+	 * \param radius The radius of the sphere
+	 * \param x Pointer to the buffer receiving the x coordinates (\c count values)
+	 * \param y Pointer to the buffer receiving the y coordinates (\c count values)
+	 * \param z Pointer to the buffer receiving the z coordinates (\c count values)
+	 */
+	static void toCartesian(const float *rightAscension, const float *declination, const size_t count,
+							const float radius, float *x, float *y, float *z);
+
+	/**
+	 * \brief Overrides the code path used by the conversion
+	 *
+	 * This is meant for benchmarking and verification. Requesting a code path not
+	 * supported by the CPU falls back to the best supported one.
+	 *
+	 * \param codePath The code path to be used (default: \ref CodePathAuto)
+	 */
+	static void setCodePath(const CodePath codePath);
+
+	/**
+	 * \brief Determines the code path to be used
+	 *
+	 * \return The requested code path if supported, otherwise the best supported one
+	 *
+	 * \see setCodePath()
+	 */
+	static CodePath codePath();
+
+private:
+
+	/**
+	 * \brief Scalar conversion
+	 *
+	 * \see toCartesian()
+	 */
+	static void toCartesianScalar(const float *rightAscension, const float *declination, const size_t count,
+								  const float radius, float *x, float *y, float *z);
+
+	/// Code path requested via setCodePath()
+	static CodePath m_CodePath;
+};
+
+/**
+ * @}
+ */
+
+#endif /*SPHERICALCOORDINATES_H_*/
@@ -0,0 +1,203 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+/*
+ * Accuracy check and micro-benchmark of the SphericalCoordinates code paths.
+ * Random sky coordinates (including quadrant boundaries and large angles) are
+ * converted by all code paths and compared with the double precision reference
+ * (the former per-vertex conversion). Afterwards the throughput of each code path
+ * is measured. Build with "make coordinatesbenchmark".
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cstdlib>
+#include <cmath>
+
+#include <sys/time.h>
+
+#include "SphericalCoordinates.h"
+
+using namespace std;
+
+/// Maximum absolute error accepted (unit sphere)
+static const double Tolerance = 1e-6;
+
+static double timestamp()
+{
+	struct timeval now;
+	gettimeofday(&now, NULL);
+
+	return now.tv_sec + now.tv_usec / 1e6;
+}
+
+static float randomAngle(const double range)
+{
+	// every fourth angle is a multiple of 45 degrees (quadrant boundaries and ties)
+	if(rand() % 4 == 0) {
+		return (float) (45.0 * (rand() % (2 * (int) (range / 45.0) + 1) - (int) (range / 45.0)));
+	}
+
+	return (float) ((2.0 * rand() / RAND_MAX - 1.0) * range);
+}
+
+static void reference(const vector<float> &rightAscension, const vector<float> &declination, const float radius,
+					  vector<double> &x, vector<double> &y, vector<double> &z)
+{
+	const double radians = M_PI / 180.0;
+
+	for(size_t i = 0; i < rightAscension.size(); ++i) {
+		x[i] = radius * cos(declination[i] * radians) * cos(rightAscension[i] * radians);
+		y[i] = radius * sin(declination[i] * radians);
+		z[i] = -radius * cos(declination[i] * radians) * sin(rightAscension[i] * radians);
+	}
+}
+
+static bool verify(const char *name, const SphericalCoordinates::CodePath path, const double range, const int rounds)
+{
+	vector<float> rightAscension, declination, x, y, z;
+	vector<double> expectedX, expectedY, expectedZ;
+	double maximumError = 0.0;
+
+	SphericalCoordinates::setCodePath(path);
+
+	for(int i = 0; i < rounds; ++i) {
+		// random lengths exercise the remainders of the wide code paths
+		const size_t count = rand() % 2 ? rand() % 20 : rand() % 5000;
+		const float radius = rand() % 2 ? 1.0f : 5.5f;
+
+		rightAscension.resize(count);
+		declination.resize(count);
+		for(size_t j = 0; j < count; ++j) {
+			rightAscension[j] = randomAngle(range);
+			declination[j] = randomAngle(range);
+		}
+
+		x.assign(count, 0.0f);
+		y.assign(count, 0.0f);
+		z.assign(count, 0.0f);
+		expectedX.resize(count);
+		expectedY.resize(count);
+		expectedZ.resize(count);
+
+		reference(rightAscension, declination, radius, expectedX, expectedY, expectedZ);
+		if(count > 0) {
+			SphericalCoordinates::toCartesian(&rightAscension[0], &declination[0], count, radius, &x[0], &y[0], &z[0]);
+		}
+
+		for(size_t j = 0; j < count; ++j) {
+			const double error = max(fabs(x[j] - expectedX[j]), max(fabs(y[j] - expectedY[j]), fabs(z[j] - expectedZ[j]))) / radius;
+			if(!(error <= Tolerance)) {
+				cerr << name << ": conversion of (" << rightAscension[j] << ", " << declination[j]
+					 << ") is off by " << error << "!" << endl;
+				return false;
+			}
+			maximumError = max(maximumError, error);
+		}
+	}
+
+	cout << setw(8) << name << ": maximum error " << scientific << setprecision(2) << maximumError
+		 << " (angles within +/- " << fixed << setprecision(0) << range << " degrees)" << endl;
+
+	SphericalCoordinates::setCodePath(SphericalCoordinates::CodePathAuto);
+
+	return true;
+}
+
+static bool isSupported(const SphericalCoordinates::CodePath path)
+{
+	// unsupported code paths silently fall back to another one
+	SphericalCoordinates::setCodePath(path);
+	const bool supported = SphericalCoordinates::codePath() == path;
+	SphericalCoordinates::setCodePath(SphericalCoordinates::CodePathAuto);
+
+	return supported;
+}
+
+static void benchmark(const char *name, const SphericalCoordinates::CodePath path,
+					  const vector<float> &rightAscension, const vector<float> &declination, const int iterations)
+{
+	const size_t count = rightAscension.size();
+	vector<float> x(count), y(count), z(count);
+	SphericalCoordinates::setCodePath(path);
+
+	const double start = timestamp();
+	for(int i = 0; i < iterations; ++i) {
+		SphericalCoordinates::toCartesian(&rightAscension[0], &declination[0], count, 1.0f, &x[0], &y[0], &z[0]);
+	}
+	const double time = (timestamp() - start) / iterations;
+
+	cout << setw(8) << name << ": " << setw(8) << time * 1e3 << " ms per catalog, "
+		 << setw(8) << count / time / 1e6 << " Mcoordinates/s" << endl;
+}
+
+int main(int argc, char **argv)
+{
+	const int iterations = argc > 1 ? atoi(argv[1]) : 50;
+	const size_t count = argc > 2 ? atoi(argv[2]) : 1000000;
+
+	const char *names[] = {"scalar", "sse2", "avx2", "neon"};
+	const SphericalCoordinates::CodePath paths[] = {
+		SphericalCoordinates::CodePathScalar,
+		SphericalCoordinates::CodePathSSE2,
+		SphericalCoordinates::CodePathAVX2,
+		SphericalCoordinates::CodePathNEON
+	};
+	const size_t pathCount = sizeof(paths) / sizeof(paths[0]);
+
+	srand(42);
+
+	for(size_t i = 0; i < pathCount; ++i) {
+		if(!isSupported(paths[i])) {
+			cout << setw(8) << names[i] << ": not supported, skipped" << endl;
+			continue;
+		}
+		if(!verify(names[i], paths[i], 720.0, 2000) || !verify(names[i], paths[i], 1e5, 500)) {
+			return 1;
+		}
+	}
+
+	// typical catalog: RA within [0, 360), DE within [-90, 90]
+	vector<float> rightAscension(count), declination(count);
+	for(size_t i = 0; i < count; ++i) {
+		rightAscension[i] = 360.0f * rand() / ((double) RAND_MAX + 1.0);
+		declination[i] = 180.0f * rand() / RAND_MAX - 90.0f;
+	}
+
+	cout << "Catalog size: " << count << " coordinates, " << iterations << " iterations" << endl;
+	cout << fixed << setprecision(2);
+
+	// former per-vertex conversion (double precision libm)
+	vector<double> x(count), y(count), z(count);
+	const double start = timestamp();
+	for(int i = 0; i < iterations; ++i) {
+		reference(rightAscension, declination, 1.0f, x, y, z);
+	}
+	const double time = (timestamp() - start) / iterations;
+	cout << setw(8) << "libm" << ": " << setw(8) << time * 1e3 << " ms per catalog, "
+		 << setw(8) << count / time / 1e6 << " Mcoordinates/s" << endl;
+
+	for(size_t i = 0; i < pathCount; ++i) {
+		if(isSupported(paths[i])) benchmark(names[i], paths[i], rightAscension, declination, iterations);
+	}
+
+	return 0;
+}
@@ -0,0 +1,231 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef STARCATALOG_H_
+#define STARCATALOG_H_
+
+#include <cstddef>
+#include <stdint.h>
+
+/**
+ * \addtogroup starsphere Starsphere
+ * @{
+ */
+
+/**
+ * \brief Precomputed star catalog (structure of arrays)
+ *
+ * Star catalogs are compiled offline by the star catalog compiler (\c starcat, see
+ * StarCatalogCompiler) from plain text catalogs. Every entry is stored as unit vector
+ * in the starsphere's cartesian frame, so no trigonometry is required at runtime:
+ * - <code>x = cos(DE) * cos(RA)</code>
+ * - <code>y = sin(DE)</code>
+ * - <code>z = -cos(DE) * sin(RA)</code>
+ *
+ * Duplicate entries (same right ascension and declination) are removed by the compiler.
+ * All tables are \c const and initialized statically, hence they reside in read-only
+ * data pages shared by all instances of the application.
+ *
+ * \author Oliver Bock\n
+ * Max-Planck-Institute for Gravitational Physics\n
+ * Hannover, Germany
+ */
+struct StarCatalog
+{
+	/// Number of (unique) entries
+	size_t count;
+
+	/// X coordinates of the entries (unit sphere)
+	const float *x;
+
+	/// Y coordinates of the entries (unit sphere)
+	const float *y;
+
+	/// Z coordinates of the entries (unit sphere)
+	const float *z;
+
+	/// Visual magnitudes of the entries (\c NULL if the catalog doesn't provide them)
+	const float *magnitude;
+
+	/// Colours of the entries as \c 0xRRGGBB (\c NULL if the catalog doesn't provide them)
+	const unsigned int *colour;
+
+	/// Number of links (line segments) between entries
+	size_t linkCount;
+
+	/// Entry indices of the link end points (two per link, \c NULL if there are no links)
+	const unsigned int *links;
+};
+
+/**
+ * \brief Binary layout of external star catalog files
+ *
+ * Star catalog files are written by the star catalog compiler (<code>starcat --binary</code>)
+ * and memory-mapped read-only by StarField. A file comprises:
+ * -# A \ref Header (at offset 0)
+ * -# The x, y and z coordinates of the entries (unit sphere, \c float)
+ * -# The magnitudes of the entries (\c float, sorted in ascending order, i.e. brightest first)
+ * -# Optionally the colours of the entries (\c 0xRRGGBB, \c uint32_t)
+ *
+ * Every table starts at a multiple of \ref Alignment and all offsets are relative to the
+ * beginning of the file. All values are stored in the byte order of the machine that wrote
+ * the file (a foreign byte order fails the \ref Magic check).
+ *
+ * \see StarField::load
+ * \see StarCatalogCompiler
+ */
+struct StarCatalogFile
+{
+	/// File signature ("EaHs" in little endian byte order)
+	static const uint32_t Magic = 0x73486145;
+
+	/// Format version
+	static const uint32_t Version = 1;
+
+	/// Alignment of the tables (in bytes)
+	static const uint32_t Alignment = 16;
+
+	/// File header
+	struct Header {
+		/// File signature (\ref Magic)
+		uint32_t magic;
+
+		/// Format version (\ref Version)
+		uint32_t version;
+
+		/// Number of entries
+		uint32_t count;
+
+		/// Reserved (zero)
+		uint32_t reserved;
+
+		/// Offset of the x coordinates
+		uint64_t xOffset;
+
+		/// Offset of the y coordinates
+		uint64_t yOffset;
+
+		/// Offset of the z coordinates
+		uint64_t zOffset;
+
+		/// Offset of the magnitudes
+		uint64_t magnitudeOffset;
+
+		/// Offset of the colours (zero if not available)
+		uint64_t colourOffset;
+
+		/// Total size of the file (in bytes)
+		uint64_t fileSize;
+	};
+};
+
+/**
+ * \brief Binary layout of tiled star catalog files
+ *
+ * Tiled star catalogs are written by the star catalog compiler (<code>starcat --tiles</code>)
+ * and streamed tile by tile by SkyTileStore. The catalog is split into levels of increasing
+ * magnitude: level \c n contains the entries fainter than the limit of level <code>n-1</code>
+ * up to its own \ref Header::magnitudeLimit and is partitioned into the SkyIndex cells of
+ * depth \c n. Since faint entries are much more numerous, all tiles hold comparable numbers
+ * of entries and only the levels relevant at the current zoom need to be loaded. A file comprises:
+ * -# A \ref Header (at offset 0)
+ * -# The index: one \ref Tile per cell, all cells of level 0 followed by those of level 1 etc.
+ * -# The entries (\ref Star), grouped by tile and sorted by magnitude within every tile
+ *
+ * All offsets are relative to the beginning of the file and all values are stored in the
+ * byte order of the machine that wrote the file (a foreign byte order fails the \ref Magic check).
+ *
+ * \see SkyTileStore
+ * \see StarCatalogCompiler
+ */
+struct SkyTileFile
+{
+	/// File signature ("EaHt" in little endian byte order)
+	static const uint32_t Magic = 0x74486145;
+
+	/// Format version
+	static const uint32_t Version = 1;
+
+	/// Maximum number of levels
+	static const uint32_t MaxLevels = 8;
+
+	/// File header
+	struct Header {
+		/// File signature (\ref Magic)
+		uint32_t magic;
+
+		/// Format version (\ref Version)
+		uint32_t version;
+
+		/// Number of levels (1 to \ref MaxLevels)
+		uint32_t levelCount;
+
+		/// Reserved (zero)
+		uint32_t reserved;
+
+		/// Faintest magnitude of every level (ascending, unused levels are zero)
+		float magnitudeLimit[MaxLevels];
+
+		/// Offset of the index
+		uint64_t indexOffset;
+
+		/// Total size of the file (in bytes)
+		uint64_t fileSize;
+	};
+
+	/// Index entry describing a single tile
+	struct Tile {
+		/// Offset of the tile's first entry
+		uint64_t offset;
+
+		/// Number of entries
+		uint32_t count;
+
+		/// Reserved (zero)
+		uint32_t reserved;
+	};
+
+	/// Catalog entry
+	struct Star {
+		/// Position (unit sphere, see StarCatalog)
+		float x, y, z;
+
+		/// Visual magnitude
+		float magnitude;
+
+		/// Colour as \c 0xRRGGBB (white if the catalog doesn't provide colours)
+		uint32_t colour;
+	};
+};
+
+/// Constellation stars and their links (catalogs/constellations.cat)
+extern const StarCatalog c_StarCatalogConstellations;
+
+/// Pulsars (catalogs/pulsars.cat)
+extern const StarCatalog c_StarCatalogPulsars;
+
+/// Supernova remnants (catalogs/snrs.cat)
+extern const StarCatalog c_StarCatalogSNRs;
+
+/**
+ * @}
+ */
+
+#endif /*STARCATALOG_H_*/
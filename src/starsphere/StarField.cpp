@@ -0,0 +1,353 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "StarField.h"
+
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <algorithm>
+
+#ifndef GL_POINT_SPRITE_ARB
+#define GL_POINT_SPRITE_ARB 0x8861
+#endif
+
+#ifndef GL_COORD_REPLACE_ARB
+#define GL_COORD_REPLACE_ARB 0x8862
+#endif
+
+const float StarField::SizeClassMagnitudes[StarField::SizeClassCount] = {
+	0.0, 1.0, 2.0, 3.0, 4.0, 5.0, 6.5, 1e30
+};
+
+const GLfloat StarField::SizeClassSizes[StarField::SizeClassCount] = {
+	6.0, 5.0, 4.5, 4.0, 3.5, 3.0, 2.5, 2.0
+};
+
+const float StarField::ZoomMagnitudeRange = 4.0;
+
+/// Magnitude order of tile entries (for binary searches)
+struct StarMagnitudeOrder {
+	bool operator()(const SkyTileFile::Star &star, const float magnitude) const {
+		return star.magnitude < magnitude;
+	}
+
+	bool operator()(const float magnitude, const SkyTileFile::Star &star) const {
+		return magnitude < star.magnitude;
+	}
+
+	bool operator()(const SkyTileFile::Star &first, const SkyTileFile::Star &second) const {
+		return first.magnitude < second.magnitude;
+	}
+};
+
+StarField::StarField() : m_Batch(GL_POINTS)
+{
+	m_File = NULL;
+	memset(&m_Catalog, 0, sizeof(m_Catalog));
+	memset(m_SizeClassStart, 0, sizeof(m_SizeClassStart));
+	m_MagnitudeLimit = 6.5;
+	m_VisibleCount = 0;
+	m_TileVisibleCount = 0;
+	m_Radius = 1.0;
+	m_SpriteTexture = 0;
+}
+
+StarField::~StarField()
+{
+	if(m_File) m_File->release();
+}
+
+bool StarField::load(const string filename)
+{
+	ResourceBuffer *file = ResourceBuffer::createMapping(filename);
+	if(!file) return false;
+
+	if(!validate(file)) {
+		cerr << "Star catalog \"" << filename << "\" is invalid, ignoring it!" << endl;
+		file->release();
+		return false;
+	}
+
+	// replace previous catalog
+	if(m_File) {
+		m_File->release();
+	}
+
+	const unsigned char *data = file->data();
+	const StarCatalogFile::Header *header = (const StarCatalogFile::Header*) data;
+
+	m_File = file;
+	memset(&m_Catalog, 0, sizeof(m_Catalog));
+	m_Catalog.count = header->count;
+	m_Catalog.x = (const float*) (data + header->xOffset);
+	m_Catalog.y = (const float*) (data + header->yOffset);
+	m_Catalog.z = (const float*) (data + header->zOffset);
+	m_Catalog.magnitude = (const float*) (data + header->magnitudeOffset);
+	m_Catalog.colour = header->colourOffset ? (const unsigned int*) (data + header->colourOffset) : NULL;
+
+	return true;
+}
+
+bool StarField::validate(ResourceBuffer *file)
+{
+	const unsigned char *data = file->data();
+	const uint64_t size = file->size();
+
+	// check header
+	if(size < sizeof(StarCatalogFile::Header)) return false;
+
+	const StarCatalogFile::Header *header = (const StarCatalogFile::Header*) data;
+	if(header->magic != StarCatalogFile::Magic || header->version != StarCatalogFile::Version) return false;
+	if(header->fileSize != size) return false;
+
+	// check tables (alignment, bounds)
+	const uint64_t offsets[] = {
+		header->xOffset, header->yOffset, header->zOffset, header->magnitudeOffset, header->colourOffset
+	};
+	const uint64_t tableSize = (uint64_t) header->count * sizeof(float);
+
+	for(size_t i = 0; i < sizeof(offsets) / sizeof(offsets[0]); ++i) {
+		// colours are optional
+		if(i == 4 && offsets[i] == 0) continue;
+
+		if(offsets[i] % StarCatalogFile::Alignment != 0 || offsets[i] < sizeof(StarCatalogFile::Header)) return false;
+		if(offsets[i] > size || tableSize > size - offsets[i]) return false;
+	}
+
+	// check magnitudes (finite, sorted)
+	const float *magnitude = (const float*) (data + header->magnitudeOffset);
+	for(size_t i = 0; i < header->count; ++i) {
+		if(magnitude[i] - magnitude[i] != 0.0f) return false;
+		if(i > 0 && magnitude[i-1] > magnitude[i]) return false;
+	}
+
+	return true;
+}
+
+bool StarField::openTiles(const string filename)
+{
+	return m_Tiles.open(filename);
+}
+
+bool StarField::isLoaded() const
+{
+	return m_File != NULL || m_Tiles.isOpen();
+}
+
+const StarCatalog& StarField::catalog() const
+{
+	return m_Catalog;
+}
+
+void StarField::generate(const GLfloat radius)
+{
+	m_Radius = radius;
+
+	// the context has been (re)created, a previous buffer object is gone already
+	m_Batch.invalidate();
+	m_Batch.clear();
+
+	for(size_t i = 0; i < m_Catalog.count; ++i) {
+		appendStar(m_Batch, radius, m_Catalog.x[i], m_Catalog.y[i], m_Catalog.z[i], m_Catalog.magnitude[i],
+				   m_Catalog.colour ? m_Catalog.colour[i] : 0xffffff);
+	}
+
+	m_Batch.upload();
+
+	// size classes are contiguous ranges (catalog is sorted by magnitude)
+	const float *end = m_Catalog.magnitude + m_Catalog.count;
+	m_SizeClassStart[0] = 0;
+	for(int i = 0; i < SizeClassCount; ++i) {
+		m_SizeClassStart[i+1] = lower_bound(m_Catalog.magnitude, end, SizeClassMagnitudes[i]) - m_Catalog.magnitude;
+	}
+
+	// tile batches are recreated on demand (context might have been recreated)
+	m_Tiles.clear();
+
+	generateSpriteTexture();
+	setMagnitudeLimit(m_MagnitudeLimit);
+}
+
+void StarField::generateTile(SkyTileStore::Tile *tile)
+{
+	tile->batch.clear();
+
+	for(size_t i = 0; i < tile->stars.size(); ++i) {
+		const SkyTileFile::Star &star = tile->stars[i];
+		appendStar(tile->batch, m_Radius, star.x, star.y, star.z, star.magnitude, star.colour);
+	}
+
+	tile->batch.upload();
+	tile->generated = true;
+}
+
+void StarField::appendStar(VertexBatch &batch, const GLfloat radius, const float x, const float y, const float z,
+						   const float magnitude, const unsigned int colour)
+{
+	// fainter stars are dimmed (but remain visible)
+	const GLfloat brightness = max(0.35f, min(1.0f, 1.0f - 0.08f * (magnitude - 1.0f)));
+
+	batch.color(brightness * ((colour >> 16) & 0xff) / 255.0f,
+				brightness * ((colour >> 8) & 0xff) / 255.0f,
+				brightness * (colour & 0xff) / 255.0f);
+	batch.vertex(radius * x, radius * y, radius * z);
+}
+
+void StarField::generateSpriteTexture()
+{
+	// delete existing (harmless if the context has been recreated)
+	if(m_SpriteTexture) glDeleteTextures(1, &m_SpriteTexture);
+	m_SpriteTexture = 0;
+
+	const char *extensions = (const char*) glGetString(GL_EXTENSIONS);
+	if(!extensions || !strstr(extensions, "GL_ARB_point_sprite")) {
+		cerr << "Point sprites not supported, using plain points..." << endl;
+		return;
+	}
+
+	// gaussian falloff (alpha only, the colour is taken from the vertices)
+	const int size = 32;
+	GLubyte texels[size * size];
+
+	for(int y = 0; y < size; ++y) {
+		for(int x = 0; x < size; ++x) {
+			const float dx = (x + 0.5f) / size * 2.0f - 1.0f;
+			const float dy = (y + 0.5f) / size * 2.0f - 1.0f;
+			texels[y * size + x] = (GLubyte) (255.0f * exp(-4.0f * (dx * dx + dy * dy)) + 0.5f);
+		}
+	}
+
+	glGenTextures(1, &m_SpriteTexture);
+	glBindTexture(GL_TEXTURE_2D, m_SpriteTexture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, size, size, 0, GL_ALPHA, GL_UNSIGNED_BYTE, texels);
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void StarField::setMagnitudeLimit(const float magnitude)
+{
+	m_MagnitudeLimit = magnitude;
+
+	if(!m_Catalog.count) {
+		m_VisibleCount = 0;
+		return;
+	}
+
+	// stars up to and including the limit are visible
+	const float *end = m_Catalog.magnitude + m_Catalog.count;
+	m_VisibleCount = upper_bound(m_Catalog.magnitude, end, magnitude) - m_Catalog.magnitude;
+}
+
+size_t StarField::visibleCount() const
+{
+	return m_Tiles.isOpen() ? m_TileVisibleCount : m_VisibleCount;
+}
+
+void StarField::update(const ViewFrustum &frustum)
+{
+	if(!m_Tiles.isOpen()) return;
+
+	// level n+1 starts at the limit of level n
+	unsigned int maxLevel = 0;
+	while(maxLevel + 1 < m_Tiles.levelCount() &&
+		  m_Tiles.magnitudeLimit(maxLevel) < m_MagnitudeLimit + ZoomMagnitudeRange)
+	{
+		++maxLevel;
+	}
+
+	m_Tiles.update(frustum, m_Radius, maxLevel);
+}
+
+void StarField::draw()
+{
+	if(!isLoaded()) return;
+
+	if(m_SpriteTexture) {
+		glEnable(GL_POINT_SPRITE_ARB);
+		glTexEnvi(GL_POINT_SPRITE_ARB, GL_COORD_REPLACE_ARB, GL_TRUE);
+		glEnable(GL_TEXTURE_2D);
+		glBindTexture(GL_TEXTURE_2D, m_SpriteTexture);
+		glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+	}
+
+	// overlapping halos must not occlude each other
+	glDepthMask(GL_FALSE);
+
+	if(m_Tiles.isOpen()) {
+		drawTiles();
+	}
+	else {
+		drawClasses(m_Batch, m_SizeClassStart, m_VisibleCount);
+	}
+
+	glDepthMask(GL_TRUE);
+
+	if(m_SpriteTexture) {
+		glBindTexture(GL_TEXTURE_2D, 0);
+		glDisable(GL_TEXTURE_2D);
+		glDisable(GL_POINT_SPRITE_ARB);
+	}
+}
+
+void StarField::drawTiles()
+{
+	const vector<SkyTileStore::Tile*> &tiles = m_Tiles.visibleTiles();
+	m_TileVisibleCount = 0;
+
+	for(size_t i = 0; i < tiles.size(); ++i) {
+		SkyTileStore::Tile *tile = tiles[i];
+		if(tile->stars.empty()) continue;
+		if(!tile->generated) generateTile(tile);
+
+		// the whole sky level follows the magnitude limit, deeper levels show up when zooming in
+		const float limit = tile->level == 0 ? m_MagnitudeLimit : m_MagnitudeLimit + ZoomMagnitudeRange;
+		const SkyTileFile::Star *begin = &tile->stars[0];
+		const SkyTileFile::Star *end = begin + tile->stars.size();
+
+		// size classes are contiguous ranges (tiles are sorted by magnitude)
+		GLint classStart[SizeClassCount + 1];
+		classStart[0] = 0;
+		for(int j = 0; j < SizeClassCount; ++j) {
+			classStart[j+1] = lower_bound(begin, end, SizeClassMagnitudes[j], StarMagnitudeOrder()) - begin;
+		}
+
+		const GLint visibleCount = upper_bound(begin, end, limit, StarMagnitudeOrder()) - begin;
+		drawClasses(tile->batch, classStart, visibleCount);
+
+		m_TileVisibleCount += visibleCount;
+	}
+}
+
+void StarField::drawClasses(VertexBatch &batch, const GLint classStart[], const GLint visibleCount)
+{
+	// one draw call per size class, clipped to the magnitude limit
+	for(int i = 0; i < SizeClassCount; ++i) {
+		const GLint first = classStart[i];
+		const GLint last = min(classStart[i+1], visibleCount);
+		if(last <= first) continue;
+
+		batch.setSize(SizeClassSizes[i]);
+		batch.draw(first, last - first);
+	}
+}
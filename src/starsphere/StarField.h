@@ -0,0 +1,240 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef STARFIELD_H_
+#define STARFIELD_H_
+
+#include <string>
+
+#include <SDL.h>
+#include <SDL_opengl.h>
+
+#include "Resource.h"
+#include "StarCatalog.h"
+#include "VertexBatch.h"
+#include "ViewFrustum.h"
+#include "SkyTileStore.h"
+
+using namespace std;
+
+/**
+ * \addtogroup starsphere Starsphere
+ * @{
+ */
+
+/**
+ * \brief Magnitude-aware star field sourced from an external star catalog file
+ *
+ * Large star catalogs (e.g. Hipparcos/Tycho, 10^5 stars and more) aren't compiled into the
+ * application. Instead they're converted into star catalog files (see StarCatalogFile) by
+ * <code>starcat --binary</code> which are memory-mapped read-only by \ref load(). The mapping
+ * is validated once and then used directly as StarCatalog (no parsing, no copies).
+ *
+ * The stars are rendered from a single vertex batch as (textured) point sprites. Their
+ * colours are taken from the catalog and attenuated by magnitude, their sizes are chosen
+ * per magnitude class. Since the catalog is sorted by magnitude every class as well as
+ * the subset of stars brighter than the current magnitude limit (see \ref setMagnitudeLimit())
+ * is a contiguous range of the batch, so a frame needs one draw call per size class.
+ *
+ * Catalogs too large to be kept in memory as a whole are used as tiled star catalog files
+ * (see SkyTileFile, \ref openTiles()) instead. Only the tiles selected for the current view
+ * (see \ref update()) are loaded and drawn, every tile from its own vertex batch. Zoomed out
+ * the whole sky is shown up to the magnitude limit, zooming in reveals entries up to
+ * \ref ZoomMagnitudeRange magnitudes fainter in the region being looked at.
+ *
+ * \see StarCatalogFile
+ * \see SkyTileStore
+ * \see StarCatalogCompiler
+ *
+ * \author Oliver Bock\n
+ * Max-Planck-Institute for Gravitational Physics\n
+ * Hannover, Germany
+ */
+class StarField
+{
+public:
+	/// Constructor
+	StarField();
+
+	/// Destructor (releases the mapping)
+	virtual ~StarField();
+
+	/**
+	 * \brief Maps and validates the given star catalog file
+	 *
+	 * A previously loaded catalog is replaced only if the new one is valid.
+	 *
+	 * \param filename The name of the star catalog file
+	 *
+	 * \return TRUE if the catalog was loaded successfully, otherwise FALSE
+	 */
+	bool load(const string filename);
+
+	/**
+	 * \brief Opens the given tiled star catalog file (used instead of a loaded star catalog file)
+	 *
+	 * \param filename The name of the tiled star catalog file
+	 *
+	 * \return TRUE if the catalog was opened successfully, otherwise FALSE
+	 */
+	bool openTiles(const string filename);
+
+	/**
+	 * \brief Query whether a (tiled) star catalog has been loaded
+	 *
+	 * \return TRUE if a catalog is available, otherwise FALSE
+	 */
+	bool isLoaded() const;
+
+	/**
+	 * \brief Retrieve the loaded star catalog (view into the mapping)
+	 *
+	 * \return The star catalog (empty if none has been loaded)
+	 */
+	const StarCatalog& catalog() const;
+
+	/**
+	 * \brief Creates the vertex batch and the point sprite texture
+	 *
+	 * This method has to be called once the OpenGL context has been created and
+	 * every time it has been recreated (required for windoze).
+	 *
+	 * \param radius The radius of the sky sphere
+	 */
+	void generate(const GLfloat radius);
+
+	/**
+	 * \brief Sets the faintest magnitude that is still rendered
+	 *
+	 * \param magnitude The magnitude limit
+	 */
+	void setMagnitudeLimit(const float magnitude);
+
+	/**
+	 * \brief Retrieve the number of stars brighter than the current magnitude limit
+	 *
+	 * \return The number of stars rendered per frame (tiled catalogs: by the last frame)
+	 */
+	size_t visibleCount() const;
+
+	/**
+	 * \brief Selects the tiles for the current view (tiled catalogs only)
+	 *
+	 * \param frustum The view frustum (sky coordinates)
+	 */
+	void update(const ViewFrustum &frustum);
+
+	/// Renders the stars brighter than the current magnitude limit
+	void draw();
+
+	/// Magnitudes beyond the limit revealed by zooming in (tiled catalogs only)
+	static const float ZoomMagnitudeRange;
+
+private:
+	/**
+	 * \brief Validates the layout of a mapped star catalog file
+	 *
+	 * \param file The mapped file
+	 *
+	 * \return TRUE if the file is valid, otherwise FALSE
+	 */
+	static bool validate(ResourceBuffer *file);
+
+	/// Creates the (gaussian) point sprite texture
+	void generateSpriteTexture();
+
+	/**
+	 * \brief Creates the vertex batch of a tile
+	 *
+	 * \param tile The tile
+	 */
+	void generateTile(SkyTileStore::Tile *tile);
+
+	/**
+	 * \brief Adds a star to a vertex batch (colour attenuated by magnitude)
+	 *
+	 * \param batch The vertex batch
+	 * \param radius The radius of the sky sphere
+	 * \param x The x coordinate of the star (unit sphere)
+	 * \param y The y coordinate of the star (unit sphere)
+	 * \param z The z coordinate of the star (unit sphere)
+	 * \param magnitude The magnitude of the star
+	 * \param colour The colour of the star as \c 0xRRGGBB
+	 */
+	static void appendStar(VertexBatch &batch, const GLfloat radius, const float x, const float y, const float z,
+						   const float magnitude, const unsigned int colour);
+
+	/// Renders the selected tiles
+	void drawTiles();
+
+	/**
+	 * \brief Renders a vertex batch sorted by magnitude (one draw call per size class)
+	 *
+	 * \param batch The vertex batch
+	 * \param classStart First vertex of every size class (plus end marker)
+	 * \param visibleCount The number of vertices brighter than the magnitude limit
+	 */
+	static void drawClasses(VertexBatch &batch, const GLint classStart[], const GLint visibleCount);
+
+	/// Number of magnitude (size) classes
+	static const int SizeClassCount = 8;
+
+	/// Upper magnitude bounds of the size classes (exclusive)
+	static const float SizeClassMagnitudes[SizeClassCount];
+
+	/// Point sizes of the size classes
+	static const GLfloat SizeClassSizes[SizeClassCount];
+
+	/// The mapped star catalog file (NULL if none has been loaded)
+	ResourceBuffer *m_File;
+
+	/// The star catalog (view into \ref m_File)
+	StarCatalog m_Catalog;
+
+	/// The vertex batch holding all stars (sorted by magnitude)
+	VertexBatch m_Batch;
+
+	/// First vertex of every size class (plus end marker)
+	GLint m_SizeClassStart[SizeClassCount + 1];
+
+	/// The current magnitude limit
+	float m_MagnitudeLimit;
+
+	/// The number of stars brighter than \ref m_MagnitudeLimit
+	GLint m_VisibleCount;
+
+	/// The number of stars rendered from tiles by the last frame
+	size_t m_TileVisibleCount;
+
+	/// The radius of the sky sphere
+	GLfloat m_Radius;
+
+	/// The tiles of the tiled star catalog (if any)
+	SkyTileStore m_Tiles;
+
+	/// The point sprite texture (0 if point sprites aren't supported)
+	GLuint m_SpriteTexture;
+};
+
+/**
+ * @}
+ */
+
+#endif /*STARFIELD_H_*/
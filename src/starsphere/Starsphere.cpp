@@ -24,7 +24,13 @@
 #include "Starsphere.h"
 
 Starsphere::Starsphere(string sharedMemoryAreaIdentifier) :
-	AbstractGraphicsEngine(sharedMemoryAreaIdentifier)
+	AbstractGraphicsEngine(sharedMemoryAreaIdentifier),
+	m_StarsBatch(GL_POINTS, 4.0),
+	m_PulsarsBatch(GL_POINTS, 3.0),
+	m_SNRsBatch(GL_POINTS, 3.0),
+	m_ConstellationsBatch(GL_LINES, 1.0),
+	m_GlobeBatch(GL_LINES, 1.0),
+	m_AxesBatch(GL_LINES, 2.0)
 {
 	m_FontResource = 0;
 	m_FontLogo1 = 0;
@@ -60,10 +66,27 @@ Starsphere::Starsphere(string sharedMemoryAreaIdentifier) :
 	m_CurrentRightAscension = -1.0;
 	m_CurrentDeclination = -1.0;
 	m_RefreshSearchMarker = true;
+
+	m_QualitySetting = BOINCClientAdapter::LowGraphicsQualitySetting;
+
+	m_AnimationStartTime = -1.0;
+	m_AnimationLastTime = -1.0;
+
+	m_UseVertexBatches = true;
+	m_RenderPathFrameTime = 0.0;
+	m_RenderPathFrameCount = 0;
+
+	m_CullLayers = true;
+	m_CullingDrawnPrimitives = 0.0;
+	m_CullingTotalPrimitives = 0.0;
+	m_CullingFrameCount = 0;
 }
 
 Starsphere::~Starsphere()
 {
+	reportRenderPathTiming();
+	reportCullingStatistics();
+
 	if(m_FontLogo1) delete m_FontLogo1;
 	if(m_FontLogo2) delete m_FontLogo2;
 	if(m_FontHeader) delete m_FontHeader;
@@ -74,29 +97,59 @@ void Starsphere::sphVertex3D(GLfloat RAdeg, GLfloat DEdeg, GLfloat radius)
 {
 	GLfloat x, y, z;
 
-	x = radius * COS(DEdeg) * COS(RAdeg);
-	z = -radius * COS(DEdeg) * SIN(RAdeg);
-	y = radius * SIN(DEdeg);
+	SphericalCoordinates::toCartesian(&RAdeg, &DEdeg, 1, radius, &x, &y, &z);
 	glVertex3f(x, y, z);
 	return;
 }
 
+void Starsphere::sphVertex3D(VertexBatch &batch, GLfloat RAdeg, GLfloat DEdeg, GLfloat radius)
+{
+	GLfloat x, y, z;
+
+	SphericalCoordinates::toCartesian(&RAdeg, &DEdeg, 1, radius, &x, &y, &z);
+	batch.vertex(x, y, z);
+}
+
+void Starsphere::sphConvert(const vector<GLfloat> &RAdeg, const vector<GLfloat> &DEdeg, GLfloat radius)
+{
+	const size_t count = RAdeg.size();
+
+	m_SphereX.resize(count);
+	m_SphereY.resize(count);
+	m_SphereZ.resize(count);
+
+	if(count > 0) {
+		SphericalCoordinates::toCartesian(&RAdeg[0], &DEdeg[0], count, radius, &m_SphereX[0], &m_SphereY[0], &m_SphereZ[0]);
+	}
+}
+
+void Starsphere::sphVertices(VertexBatch &batch, const vector<GLfloat> &RAdeg, const vector<GLfloat> &DEdeg)
+{
+	sphConvert(RAdeg, DEdeg, sphRadius);
+
+	if(!m_SphereX.empty()) {
+		batch.vertices(&m_SphereX[0], &m_SphereY[0], &m_SphereZ[0], m_SphereX.size());
+	}
+}
+
 void Starsphere::sphVertex(GLfloat RAdeg, GLfloat DEdeg)
 {
 	sphVertex3D(RAdeg, DEdeg, sphRadius);
 }
 
+void Starsphere::sphVertex(VertexBatch &batch, GLfloat RAdeg, GLfloat DEdeg)
+{
+	sphVertex3D(batch, RAdeg, DEdeg, sphRadius);
+}
+
 /**
- * Star Marker:
- * Makes a marker for one star at a given position and angular size.
+ * Adds all entries of a precompiled star catalog to a vertex batch
  */
-void Starsphere::star_marker(float RAdeg, float DEdeg, float size)
+void Starsphere::catalogVertices(VertexBatch &batch, const StarCatalog &catalog)
 {
-	glPointSize((GLfloat) size);
-	glBegin(GL_POINTS);
-	sphVertex((GLfloat) RAdeg, (GLfloat) DEdeg);
-	glEnd();
-	return;
+	for (size_t i=0; i < catalog.count; ++i) {
+		batch.vertex(sphRadius * catalog.x[i], sphRadius * catalog.y[i], sphRadius * catalog.z[i]);
+	}
 }
 
 /**
@@ -104,41 +157,21 @@ void Starsphere::star_marker(float RAdeg, float DEdeg, float size)
  */
 void Starsphere::make_stars()
 {
-	GLfloat mag_size;
-	int i, j;
-	bool is_dupe;
-	int Ndupes=0;
+	m_StarsBatch.clear();
+	m_StarsBatch.color(1.0, 1.0, 1.0);
 
-	// delete existing, create new (required for windoze)
-	if(Stars) glDeleteLists(Stars, 1);
-	Stars = glGenLists(1);
-	glNewList(Stars, GL_COMPILE);
-
-		glColor3f(1.0, 1.0, 1.0);
-
-		/**
-		 * At some point in the future star_info[][] will also contain
-		 * star magnitude and the marker size will vary with this.
-		 */
-		for (i=0; i < Nstars; i++) {
-			// same stars appear more than once in constallations so ignore dupes
-			is_dupe=false;
-			for (j=0; j< i; j++) {
-				if (star_info[j][0] == star_info[i][0] && star_info[j][0]
-				        == star_info[i][0]) {
-					is_dupe=true;
-					Ndupes++;
-					break;
-				}
-			}
-			if (!is_dupe) {
-				// mag_size = 0.05 + 0.50*rand()/RAND_MAX;
-				mag_size = 4.0;
-				star_marker(star_info[i][0], star_info[i][1], mag_size);
-			}
-		}
+	/**
+	 * Note: stars appearing more than once in the constellations
+	 * have already been removed by the catalog compiler. Magnitudes
+	 * are taken into account by the star field (if available).
+	 */
+	catalogVertices(m_StarsBatch, c_StarCatalogConstellations);
 
-	glEndList();
+	m_StarsBatch.partition();
+	Stars = m_StarsBatch.compile(Stars);
+	m_StarsBatch.upload();
+
+	m_StarField.generate(sphRadius);
 }
 
 /**
@@ -146,21 +179,14 @@ void Starsphere::make_stars()
  */
 void Starsphere::make_pulsars()
 {
-	GLfloat mag_size=3.0;
-	int i;
-
-	// delete existing, create new (required for windoze)
-	if(Pulsars) glDeleteLists(Pulsars, 1);
-	Pulsars = glGenLists(1);
-	glNewList(Pulsars, GL_COMPILE);
-
-		glColor3f(0.80, 0.0, 0.85); // _P_ulsars are _P_urple
+	m_PulsarsBatch.clear();
+	m_PulsarsBatch.color(0.80, 0.0, 0.85); // _P_ulsars are _P_urple
 
-		for (i=0; i < Npulsars; i++) {
-			star_marker(pulsar_info[i][0], pulsar_info[i][1], mag_size);
-		}
+	catalogVertices(m_PulsarsBatch, c_StarCatalogPulsars);
 
-	glEndList();
+	m_PulsarsBatch.partition();
+	Pulsars = m_PulsarsBatch.compile(Pulsars);
+	m_PulsarsBatch.upload();
 }
 
 /**
@@ -168,21 +194,14 @@ void Starsphere::make_pulsars()
  */
 void Starsphere::make_snrs()
 {
-	GLfloat mag_size=3.0;
-	int i;
-
-	// delete existing, create new (required for windoze)
-	if(SNRs) glDeleteLists(SNRs, 1);
-	SNRs = glGenLists(1);
-	glNewList(SNRs, GL_COMPILE);
-
-		glColor3f(0.7, 0.176, 0.0); // _S_NRs are _S_ienna
+	m_SNRsBatch.clear();
+	m_SNRsBatch.color(0.7, 0.176, 0.0); // _S_NRs are _S_ienna
 
-		for (i=0; i < NSNRs; i++) {
-			star_marker(SNR_info[i][0], SNR_info[i][1], mag_size);
-		}
+	catalogVertices(m_SNRsBatch, c_StarCatalogSNRs);
 
-	glEndList();
+	m_SNRsBatch.partition();
+	SNRs = m_SNRsBatch.compile(SNRs);
+	m_SNRsBatch.upload();
 }
 
 /**
@@ -191,25 +210,20 @@ void Starsphere::make_snrs()
  */
 void Starsphere::make_constellations()
 {
-	GLint star_num=0;
+	const StarCatalog &catalog = c_StarCatalogConstellations;
 
-	// delete existing, create new (required for windoze)
-	if(Constellations) glDeleteLists(Constellations, 1);
-	Constellations = glGenLists(1);
-	glNewList(Constellations, GL_COMPILE);
-
-		glLineWidth(1.0);
-		glColor3f(0.7, 0.7, 0.0); // light yellow
-
-		glBegin(GL_LINES); // draws lines between *pairs* of vertices
-			for (star_num=0; star_num < Nstars; ++star_num) {
-				sphVertex(star_info[star_num][0], star_info[star_num][1]);
-				star_num++;
-				sphVertex(star_info[star_num][0], star_info[star_num][1]);
-			}
-		glEnd();
+	m_ConstellationsBatch.clear();
+	m_ConstellationsBatch.color(0.7, 0.7, 0.0); // light yellow
 
-	glEndList();
+	// draws lines between *pairs* of vertices
+	for (size_t link=0; link < 2 * catalog.linkCount; ++link) {
+		const unsigned int star = catalog.links[link];
+		m_ConstellationsBatch.vertex(sphRadius * catalog.x[star], sphRadius * catalog.y[star], sphRadius * catalog.z[star]);
+	}
+
+	m_ConstellationsBatch.partition();
+	Constellations = m_ConstellationsBatch.compile(Constellations);
+	m_ConstellationsBatch.upload();
 }
 
 /**
@@ -259,7 +273,7 @@ void Starsphere::generateObservatories(float dimFactor)
 	GLfloat h2=0.400; // slight offset for H2 arms
 
 	// get current time and UTC offset (for zenith position)
-	m_ObservatoryDrawTimeLocal = dtime();
+	m_ObservatoryDrawTimeLocal = currentTime();
 	time_t local = m_ObservatoryDrawTimeLocal;
 	tm *utc = gmtime(&local);
 	double utcOffset = difftime(local, mktime(utc));
@@ -426,7 +440,6 @@ void Starsphere::generateObservatories(float dimFactor)
 
 void Starsphere::make_search_marker(GLfloat RAdeg, GLfloat DEdeg, GLfloat size)
 {
-	GLfloat x, y;
 	GLfloat r1, r2, r3;
 	float theta;
 	int i, Nstep=20;
@@ -450,40 +463,44 @@ void Starsphere::make_search_marker(GLfloat RAdeg, GLfloat DEdeg, GLfloat size)
 		// Then rotate up to DEC position around z (not x)
 		glRotatef(DEdeg, 0.0, 0.0, 1.0);
 
+		// Inner and outer circle followed by the arms (converted at once)
+		vector<GLfloat> RAs, DEs;
+		for (i=0; i<Nstep; i++) {
+			theta = i*360.0/Nstep;
+			RAs.push_back(r1*COS(theta));
+			DEs.push_back(r1*SIN(theta));
+		}
+		for (i=0; i<Nstep; i++) {
+			theta = i*360.0/Nstep;
+			RAs.push_back(r2*COS(theta));
+			DEs.push_back(r2*SIN(theta));
+		}
+		const GLfloat armRAs[] = {0.0, 0.0, 0.0, 0.0, -r1, -r3, +r1, +r3};
+		const GLfloat armDEs[] = {+r1, +r3, -r1, -r3, 0.0, 0.0, 0.0, 0.0};
+		RAs.insert(RAs.end(), armRAs, armRAs + 8);
+		DEs.insert(DEs.end(), armDEs, armDEs + 8);
+
+		sphConvert(RAs, DEs, sphRadius);
+
 		// Inner circle
 		glBegin(GL_LINE_LOOP);
 			for (i=0; i<Nstep; i++) {
-				theta = i*360.0/Nstep;
-				x = r1*COS(theta);
-				y = r1*SIN(theta);
-				sphVertex(x, y);
+				glVertex3f(m_SphereX[i], m_SphereY[i], m_SphereZ[i]);
 			}
 		glEnd();
 
 		// Outer circle
 		glBegin(GL_LINE_LOOP);
-			for (i=0; i<Nstep; i++) {
-				theta = i*360.0/Nstep;
-				x = r2*COS(theta);
-				y = r2*SIN(theta);
-				sphVertex(x, y);
+			for (i=Nstep; i<2*Nstep; i++) {
+				glVertex3f(m_SphereX[i], m_SphereY[i], m_SphereZ[i]);
 			}
 		glEnd();
 
-		// Arms that form the gunsight
+		// Arms that form the gunsight (north, south, east, west)
 		glBegin(GL_LINES);
-			//  North arm:
-			sphVertex(0.0, +r1);
-			sphVertex(0.0, +r3);
-			//  South arm:
-			sphVertex(0.0, -r1);
-			sphVertex(0.0, -r3);
-			// East arm:
-			sphVertex(-r1, 0.0);
-			sphVertex(-r3, 0.0);
-			// West arm:
-			sphVertex(+r1, 0.0);
-			sphVertex(+r3, 0.0);
+			for (i=2*Nstep; i<2*Nstep+8; i++) {
+				glVertex3f(m_SphereX[i], m_SphereY[i], m_SphereZ[i]);
+			}
 		glEnd();
 
 		glPopMatrix();
@@ -507,28 +524,22 @@ void Starsphere::make_axes()
 {
 	GLfloat axl=10.0;
 
-	// delete existing, create new (required for windoze)
-	if(Axes) glDeleteLists(Axes, 1);
-	Axes = glGenLists(1);
-	glNewList(Axes, GL_COMPILE);
-
-		glLineWidth(2.0);
+	m_AxesBatch.clear();
 
-		glBegin(GL_LINES);
-			glColor3f(1.0, 0.0, 0.0);
-			glVertex3f(-axl, 0.0, 0.0);
-			glVertex3f(axl, 0.0, 0.0);
+	m_AxesBatch.color(1.0, 0.0, 0.0);
+	m_AxesBatch.vertex(-axl, 0.0, 0.0);
+	m_AxesBatch.vertex(axl, 0.0, 0.0);
 
-			glColor3f(0.0, 1.0, 0.0);
-			glVertex3f(0.0, -axl, 0.0);
-			glVertex3f(0.0, axl, 0.0);
+	m_AxesBatch.color(0.0, 1.0, 0.0);
+	m_AxesBatch.vertex(0.0, -axl, 0.0);
+	m_AxesBatch.vertex(0.0, axl, 0.0);
 
-			glColor3f(0.0, 0.0, 1.0);
-			glVertex3f(0.0, 0.0, -axl);
-			glVertex3f(0.0, 0.0, axl);
-		glEnd();
+	m_AxesBatch.color(0.0, 0.0, 1.0);
+	m_AxesBatch.vertex(0.0, 0.0, -axl);
+	m_AxesBatch.vertex(0.0, 0.0, axl);
 
-	glEndList();
+	Axes = m_AxesBatch.compile(Axes);
+	m_AxesBatch.upload();
 }
 
 /**
@@ -537,44 +548,46 @@ void Starsphere::make_axes()
 void Starsphere::make_globe()
 {
 	int hr, j, i, iMax=100;
-	GLfloat RAdeg, DEdeg;
-
-	// delete existing, create new (required for windoze)
-	if(sphGrid) glDeleteLists(sphGrid, 1);
-	sphGrid = glGenLists(1);
-	glNewList(sphGrid, GL_COMPILE);
-
-		glLineWidth(1.0);
-
-		// Lines of constant Right Ascencion (East Longitude)
-		for (hr=0; hr<24; hr++) {
-			RAdeg=hr*15.0;
-			glColor3f(0.25, 0.25, 0.25);
-
-			// mark median
-			if(hr==0) glColor3f(0.55, 0.55, 0.55);
-
-			glBegin(GL_LINE_STRIP);
-				for (i=0; i<=iMax; i++) {
-					DEdeg = i*180.0/iMax - 90.0;
-					sphVertex(RAdeg, DEdeg);
-				}
-			glEnd();
+	vector<GLfloat> RAs, DEs;
+
+	// note: line strips are split into line segments (GL_LINES)
+	// such that the whole grid can be drawn with a single call
+	m_GlobeBatch.clear();
+
+	// Lines of constant Right Ascencion (East Longitude)
+	for (hr=0; hr<24; hr++) {
+		for (i=0; i<iMax; i++) {
+			RAs.push_back(hr*15.0);
+			DEs.push_back(i*180.0/iMax - 90.0);
+			RAs.push_back(hr*15.0);
+			DEs.push_back((i+1)*180.0/iMax - 90.0);
 		}
 
-		// Lines of constant Declination (Lattitude)
-		for (j=1; j<=12; j++) {
-			DEdeg = 90.0 - j*15.0;
+		// mark median
+		if(hr==0) {
+			m_GlobeBatch.color(0.55, 0.55, 0.55);
+			sphVertices(m_GlobeBatch, RAs, DEs);
+			RAs.clear();
+			DEs.clear();
+		}
+	}
 
-			glBegin(GL_LINE_STRIP);
-				for (i=0; i<=iMax; i++) {
-					RAdeg = i*360.0/iMax;
-					sphVertex(RAdeg, DEdeg);
-				}
-			glEnd();
+	// Lines of constant Declination (Lattitude)
+	for (j=1; j<=12; j++) {
+		for (i=0; i<iMax; i++) {
+			RAs.push_back(i*360.0/iMax);
+			DEs.push_back(90.0 - j*15.0);
+			RAs.push_back((i+1)*360.0/iMax);
+			DEs.push_back(90.0 - j*15.0);
 		}
+	}
 
-	glEndList();
+	m_GlobeBatch.color(0.25, 0.25, 0.25);
+	sphVertices(m_GlobeBatch, RAs, DEs);
+
+	m_GlobeBatch.partition();
+	sphGrid = m_GlobeBatch.compile(sphGrid);
+	m_GlobeBatch.upload();
 }
 
 /**
@@ -615,6 +628,22 @@ void Starsphere::initialize(const int width, const int height, const Resource *f
 		// initialize the BOINC client adapter
 		m_BoincAdapter.initialize();
 
+		// initial quality setting (later changes are applied via snapshots)
+		m_QualitySetting = m_BoincAdapter.graphicsQualitySetting();
+
+		// use external (tiled) star catalog (if available), falling back to the constellation stars
+		string starsFilename;
+		boinc_resolve_filename_s("starsphere.tiles", starsFilename);
+		if(m_StarField.openTiles(starsFilename)) {
+			cerr << "Using tiled star catalog: " << starsFilename << endl;
+		}
+		else {
+			boinc_resolve_filename_s("starsphere.stars", starsFilename);
+			if(m_StarField.load(starsFilename)) {
+				cerr << "Using star catalog: " << starsFilename << " (" << m_StarField.catalog().count << " stars)" << endl;
+			}
+		}
+
 		// inital HUD offset setup
 		m_XStartPosLeft = 5;
 		m_YOffsetLarge = 18;
@@ -627,6 +656,7 @@ void Starsphere::initialize(const int width, const int height, const Resource *f
 		setFeature(SEARCHINFO, true);
 		setFeature(LOGO, true);
 		setFeature(MARKER, true);
+		setFeature(WATERFALL, true);
 	}
 	else {
 
@@ -636,6 +666,14 @@ void Starsphere::initialize(const int width, const int height, const Resource *f
 		if(m_FontLogo2) delete m_FontLogo2;
 		if(m_FontHeader)delete m_FontHeader;
 		if(m_FontText)  delete m_FontText;
+
+		// the buffer objects died with the previous context (don't delete names that might be reused)
+		m_StarsBatch.invalidate();
+		m_PulsarsBatch.invalidate();
+		m_SNRsBatch.invalidate();
+		m_ConstellationsBatch.invalidate();
+		m_GlobeBatch.invalidate();
+		m_AxesBatch.invalidate();
 	}
 
 	// we might be called to recycle even before initialization
@@ -650,8 +688,8 @@ void Starsphere::initialize(const int width, const int height, const Resource *f
 
 		// create medium font instances using font resource (base address + size)
 		m_FontHeader = new OGLFT::TranslucentTexture(
-									&m_FontResource->data()->at(0),
-									m_FontResource->data()->size(),
+									m_FontResource->data(),
+									m_FontResource->size(),
 									13, 78 );
 
 		if ( m_FontHeader == 0 || !m_FontHeader->isValid() ) {
@@ -663,8 +701,8 @@ void Starsphere::initialize(const int width, const int height, const Resource *f
 
 		// create small font instances using font resource (base address + size)
 		m_FontText = new OGLFT::TranslucentTexture(
-									&m_FontResource->data()->at(0),
-									m_FontResource->data()->size(),
+									m_FontResource->data(),
+									m_FontResource->size(),
 									11, 72 );
 
 		if ( m_FontText == 0 || !m_FontText->isValid() ) {
@@ -690,15 +728,8 @@ void Starsphere::initialize(const int width, const int height, const Resource *f
 	glFrontFace(GL_CCW);
 	glHint(GL_PERSPECTIVE_CORRECTION_HINT, GL_NICEST);
 
-	// enable opt-in quality feature
-	if(m_BoincAdapter.graphicsQualitySetting() == BOINCClientAdapter::HighGraphicsQualitySetting) {
-		// some polishing
-		glShadeModel(GL_SMOOTH);
-		glEnable(GL_POINT_SMOOTH);
-		glEnable(GL_LINE_SMOOTH);
-		glHint(GL_POINT_SMOOTH_HINT, GL_NICEST);
-		glHint(GL_LINE_SMOOTH_HINT, GL_NICEST);
-	}
+	// enable opt-in quality features
+	applyQualitySetting();
 
 	// FSAA will be enabled explicitly when needed!
 	glDisable(GL_MULTISAMPLE_ARB);
@@ -712,18 +743,10 @@ void Starsphere::initialize(const int width, const int height, const Resource *f
 	glEnable(GL_DEPTH_TEST);
 	glDepthFunc(GL_LEQUAL);
 
-	// enable opt-in quality feature
-	if(m_BoincAdapter.graphicsQualitySetting() == BOINCClientAdapter::MediumGraphicsQualitySetting ||
-	   m_BoincAdapter.graphicsQualitySetting() == BOINCClientAdapter::HighGraphicsQualitySetting)
-	{
-		// fog aids depth perception
-		glEnable(GL_FOG);
-		glFogi(GL_FOG_MODE, GL_EXP2);
-		glFogf(GL_FOG_DENSITY, 0.085);
-		glHint(GL_FOG_HINT, GL_DONT_CARE);
-	}
+	// prepare vertex buffer support (context might have been recreated)
+	VertexBatch::initializeExtensions();
 
-	// create pre-drawn display lists
+	// create pre-drawn display lists and vertex batches
 	make_stars();
 	make_constellations();
 	make_pulsars();
@@ -743,21 +766,21 @@ void Starsphere::render(const double timeOfDay)
 	GLfloat xvp, yvp, zvp, vp_theta, vp_phi, vp_rad;
 	GLfloat Zrot = 0.0, Zobs=0.0;
 	double revs, t, dt = 0;
-	static double start_time=-1.0, last_time=-1.0;
+	double frameStart = dtime();
 
 	// Calculate the real time t since we started (or reset) and the
 	// time dt since the last render() call.    Both may be useful
 	// for timing animations.  Note that time_of_day is dtime().
 
-	if (start_time < 0.0)
-		start_time = timeOfDay;
-	t = timeOfDay - start_time;
+	if (m_AnimationStartTime < 0.0)
+		m_AnimationStartTime = timeOfDay;
+	t = timeOfDay - m_AnimationStartTime;
 
-	if (last_time < 0.0)
-		last_time = timeOfDay - 0.01;
-	dt = timeOfDay - last_time;
+	if (m_AnimationLastTime < 0.0)
+		m_AnimationLastTime = timeOfDay - 0.01;
+	dt = timeOfDay - m_AnimationLastTime;
 
-	last_time = timeOfDay; // remember for next time
+	m_AnimationLastTime = timeOfDay; // remember for next time
 
 	// Now determine the rotation angle based on the time since start
 	// It is negative to get the rotation direction correct (the sun
@@ -768,7 +791,9 @@ void Starsphere::render(const double timeOfDay)
 	Zrot = -360.0 * (revs - (int)revs);
 
 	// and start drawing...
+	m_Profiler.startPhase(FrameProfiler::PhaseClear);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	m_Profiler.stopPhase(FrameProfiler::PhaseClear);
 
 	// now draw the scene...
 	glLoadIdentity();
@@ -791,22 +816,59 @@ void Starsphere::render(const double timeOfDay)
 	        0.0, 0.0, 0.0, // looking toward here
 	        0.0, 1.0, 0.0); // which way is up?  y axis!
 
-	// draw axes before any rotation so they stay put
-	if (isFeature(AXES)) glCallList(Axes);
+	m_Profiler.startPhase(FrameProfiler::PhaseLayers);
+
+	if(m_UseVertexBatches) {
+		// draw axes before any rotation so they stay put
+		if (isFeature(AXES)) m_AxesBatch.draw();
+
+		// draw the sky sphere, with rotation:
+		glPushMatrix();
+		glRotatef(Zrot - rotation_offset, 0.0, 1.0, 0.0);
+
+		// view dependent layers need the frustum in sky coordinates
+		m_SkyFrustum.update();
+		if (isFeature(STARS)) m_StarField.update(m_SkyFrustum);
+
+		// stars, pulsars, supernovae, grid
+		if (isFeature(STARS)) {
+			if(m_StarField.isLoaded())	m_StarField.draw();
+			else						drawSkyLayer(m_StarsBatch);
+		}
+		if (isFeature(PULSARS))			drawSkyLayer(m_PulsarsBatch);
+		if (isFeature(SNRS))			drawSkyLayer(m_SNRsBatch);
+		if (isFeature(CONSTELLATIONS))	drawSkyLayer(m_ConstellationsBatch);
+		if (isFeature(GLOBE))			drawSkyLayer(m_GlobeBatch);
+		m_CullingFrameCount++;
+	}
+	else {
+		// draw axes before any rotation so they stay put
+		if (isFeature(AXES)) glCallList(Axes);
+
+		// draw the sky sphere, with rotation:
+		glPushMatrix();
+		glRotatef(Zrot - rotation_offset, 0.0, 1.0, 0.0);
+
+		// view dependent layers need the frustum in sky coordinates
+		m_SkyFrustum.update();
+		if (isFeature(STARS)) m_StarField.update(m_SkyFrustum);
 
-	// draw the sky sphere, with rotation:
-	glPushMatrix();
-	glRotatef(Zrot - rotation_offset, 0.0, 1.0, 0.0);
+		// stars, pulsars, supernovae, grid
+		if (isFeature(STARS)) {
+			if(m_StarField.isLoaded())	m_StarField.draw();
+			else						glCallList(Stars);
+		}
+		if (isFeature(PULSARS))			glCallList(Pulsars);
+		if (isFeature(SNRS))			glCallList(SNRs);
+		if (isFeature(CONSTELLATIONS))	glCallList(Constellations);
+		if (isFeature(GLOBE))			glCallList(sphGrid);
+	}
 
-	// stars, pulsars, supernovae, grid
-	if (isFeature(STARS))			glCallList(Stars);
-	if (isFeature(PULSARS))			glCallList(Pulsars);
-	if (isFeature(SNRS))			glCallList(SNRs);
-	if (isFeature(CONSTELLATIONS))	glCallList(Constellations);
-	if (isFeature(GLOBE))			glCallList(sphGrid);
+	m_Profiler.stopPhase(FrameProfiler::PhaseLayers);
 
 	// observatories move an extra 15 degrees/hr since they were drawn
 	if (isFeature(OBSERVATORIES)) {
+		m_Profiler.startPhase(FrameProfiler::PhaseObservatories);
 		glPushMatrix();
 		Zobs = (timeOfDay - m_ObservatoryDrawTimeLocal) * 15.0/3600.0;
 		glRotatef(Zobs, 0.0, 1.0, 0.0);
@@ -816,10 +878,12 @@ void Starsphere::render(const double timeOfDay)
 		glCallList(VIRGOmarker);
 		renderAdditionalObservatories();
 		glPopMatrix();
+		m_Profiler.stopPhase(FrameProfiler::PhaseObservatories);
 	}
 
 	// draw the search marker (gunsight)
 	if (isFeature(MARKER)) {
+		m_Profiler.startPhase(FrameProfiler::PhaseSearchMarker);
 		if(m_RefreshSearchMarker) {
 			make_search_marker(m_CurrentRightAscension, m_CurrentDeclination, 0.5);
 			m_RefreshSearchMarker = false;
@@ -827,12 +891,14 @@ void Starsphere::render(const double timeOfDay)
 		else {
 			glCallList(SearchMarker);
 		}
+		m_Profiler.stopPhase(FrameProfiler::PhaseSearchMarker);
 	}
 
 	glPopMatrix();
 
 	// draw 2D vectorized HUD
 	if(isFeature(LOGO) || isFeature(SEARCHINFO)) {
+		m_Profiler.startPhase(FrameProfiler::PhaseHUD);
 
 		// disable depth testing since we're in 2D mode
 		glDisable(GL_DEPTH_TEST);
@@ -863,9 +929,13 @@ void Starsphere::render(const double timeOfDay)
 
 		// enable depth testing since we're leaving 2D mode
 		glEnable(GL_DEPTH_TEST);
+
+		m_Profiler.stopPhase(FrameProfiler::PhaseHUD);
 	}
 
-	SDL_GL_SwapBuffers();
+	// keep track of the frame time of the active render path
+	m_RenderPathFrameTime += dtime() - frameStart;
+	m_RenderPathFrameCount++;
 }
 
 void Starsphere::renderAdditionalObservatories() {
@@ -929,6 +999,19 @@ void Starsphere::keyboardPressEvent(const AbstractGraphicsEngine::KeyBoardKey ke
 		case KeyM:
 			setFeature(MARKER, isFeature(MARKER) ? false : true);
 			break;
+		case KeyW:
+			setFeature(WATERFALL, isFeature(WATERFALL) ? false : true);
+			break;
+		case KeyV:
+			// switch between vertex batches and display lists (comparison)
+			reportRenderPathTiming();
+			m_UseVertexBatches = !m_UseVertexBatches;
+			break;
+		case KeyK:
+			// switch sky layer culling on/off (comparison)
+			reportCullingStatistics();
+			m_CullLayers = !m_CullLayers;
+			break;
 		default:
 			break;
 	}
@@ -961,6 +1044,64 @@ void Starsphere::zoomSphere(const int relativeZoom)
 		viewpt_radius = 0.5;
 }
 
+void Starsphere::reportRenderPathTiming()
+{
+	if(m_RenderPathFrameCount > 0) {
+		// don't change the formatting of subsequent diagnostics
+		const ios_base::fmtflags flags = cerr.flags();
+		const streamsize precision = cerr.precision();
+
+		cerr << "Render path \""
+			 << (m_UseVertexBatches ? (VertexBatch::isBufferObjectSupported() ? "vertex buffer objects" : "vertex arrays") : "display lists")
+			 << "\": " << m_RenderPathFrameCount << " frames, average frame time: "
+			 << fixed << setprecision(3) << 1000.0 * m_RenderPathFrameTime / m_RenderPathFrameCount << " ms" << endl;
+
+		cerr.flags(flags);
+		cerr.precision(precision);
+	}
+
+	m_RenderPathFrameTime = 0.0;
+	m_RenderPathFrameCount = 0;
+}
+
+void Starsphere::drawSkyLayer(const SkyBatch &batch)
+{
+	if(m_CullLayers) {
+		m_CullingDrawnPrimitives += batch.draw(m_SkyFrustum);
+	}
+	else {
+		batch.draw();
+		m_CullingDrawnPrimitives += batch.primitiveCount();
+	}
+
+	m_CullingTotalPrimitives += batch.primitiveCount();
+}
+
+void Starsphere::reportCullingStatistics()
+{
+	if(m_CullingFrameCount > 0) {
+		// don't change the formatting of subsequent diagnostics
+		const ios_base::fmtflags flags = cerr.flags();
+		const streamsize precision = cerr.precision();
+
+		cerr << "Sky layer culling " << (m_CullLayers ? "on" : "off")
+			 << ": " << m_CullingFrameCount << " frames, average primitives drawn: "
+			 << fixed << setprecision(0) << m_CullingDrawnPrimitives / m_CullingFrameCount
+			 << " of " << m_CullingTotalPrimitives / m_CullingFrameCount;
+		if(m_CullingTotalPrimitives > 0.0) {
+			cerr << " (" << setprecision(1) << 100.0 * m_CullingDrawnPrimitives / m_CullingTotalPrimitives << "%)";
+		}
+		cerr << endl;
+
+		cerr.flags(flags);
+		cerr.precision(precision);
+	}
+
+	m_CullingDrawnPrimitives = 0.0;
+	m_CullingTotalPrimitives = 0.0;
+	m_CullingFrameCount = 0;
+}
+
 /**
  * Feature control
  */
@@ -974,7 +1115,7 @@ bool Starsphere::isFeature(const Features feature)
 	return ((featureFlags & feature) == feature ? true : false);
 }
 
-void Starsphere::refreshLocalBOINCInformation()
+void Starsphere::updateLocalBOINCInformation(HUDSnapshot &snapshot)
 {
 	// call base class implementation
 	AbstractGraphicsEngine::refreshLocalBOINCInformation();
@@ -986,15 +1127,83 @@ void Starsphere::refreshLocalBOINCInformation()
 	buffer.fill('0');
 	buffer.setf(ios::right, ios::adjustfield);
 
-	// store content required for our HUD (user info)
-	m_UserName = "User: " + m_BoincAdapter.userName();
-	m_TeamName = "Team: " + m_BoincAdapter.teamName();
+	// prepare content required for our HUD (user info)
+	snapshot.userName = "User: " + m_BoincAdapter.userName();
+	snapshot.teamName = "Team: " + m_BoincAdapter.teamName();
 
 	buffer << "Project Credit: " << fixed << m_BoincAdapter.userCredit() << ends;
-	m_UserCredit = buffer.str();
+	snapshot.userCredit = buffer.str();
 	buffer.str("");
 
 	buffer << "Project RAC: " << fixed << m_BoincAdapter.userRACredit() << ends;
-	m_UserRACredit = buffer.str();
+	snapshot.userRACredit = buffer.str();
 	buffer.str("");
+
+	// the project preferences might have changed in the meantime
+	snapshot.qualitySetting = m_BoincAdapter.graphicsQualitySetting();
+}
+
+void Starsphere::applyLocalBOINCInformation(const HUDSnapshot &snapshot)
+{
+	// store content required for our HUD (user info)
+	m_UserName = snapshot.userName;
+	m_TeamName = snapshot.teamName;
+	m_UserCredit = snapshot.userCredit;
+	m_UserRACredit = snapshot.userRACredit;
+
+	if(m_CurrentRightAscension != snapshot.rightAscension ||
+	   m_CurrentDeclination != snapshot.declination) {
+		// we've got a new position, update search marker
+		m_CurrentRightAscension = snapshot.rightAscension;
+		m_CurrentDeclination = snapshot.declination;
+		m_RefreshSearchMarker = true;
+	}
+
+	if(m_QualitySetting != snapshot.qualitySetting) {
+		// the user changed the project preferences
+		m_QualitySetting = snapshot.qualitySetting;
+		applyQualitySetting();
+	}
+}
+
+void Starsphere::applyQualitySetting()
+{
+	// opt-in quality feature
+	if(m_QualitySetting == BOINCClientAdapter::HighGraphicsQualitySetting) {
+		// some polishing
+		glShadeModel(GL_SMOOTH);
+		glEnable(GL_POINT_SMOOTH);
+		glEnable(GL_LINE_SMOOTH);
+		glHint(GL_POINT_SMOOTH_HINT, GL_NICEST);
+		glHint(GL_LINE_SMOOTH_HINT, GL_NICEST);
+	}
+	else {
+		glDisable(GL_POINT_SMOOTH);
+		glDisable(GL_LINE_SMOOTH);
+	}
+
+	// opt-in quality feature
+	if(m_QualitySetting == BOINCClientAdapter::MediumGraphicsQualitySetting ||
+	   m_QualitySetting == BOINCClientAdapter::HighGraphicsQualitySetting)
+	{
+		// fog aids depth perception
+		glEnable(GL_FOG);
+		glFogi(GL_FOG_MODE, GL_EXP2);
+		glFogf(GL_FOG_DENSITY, 0.085);
+		glHint(GL_FOG_HINT, GL_DONT_CARE);
+	}
+	else {
+		glDisable(GL_FOG);
+	}
+
+	// star field magnitude limit (faint stars are the bulk of the catalog)
+	if(m_QualitySetting == BOINCClientAdapter::HighGraphicsQualitySetting) {
+		m_StarField.setMagnitudeLimit(9.0);
+	}
+	else if(m_QualitySetting == BOINCClientAdapter::MediumGraphicsQualitySetting) {
+		m_StarField.setMagnitudeLimit(6.5);
+	}
+	else {
+		m_StarField.setMagnitudeLimit(4.5);
+	}
 }
@@ -38,9 +38,17 @@
 #include <oglft/OGLFT.h>
 
 #include <util.h>
+#include <boinc_api.h>
 
 #include "AbstractGraphicsEngine.h"
 #include "EinsteinS5R3Adapter.h"
+#include "VertexBatch.h"
+#include "SkyBatch.h"
+#include "StarCatalog.h"
+#include "StarField.h"
+#include "ViewFrustum.h"
+#include "SphericalCoordinates.h"
+#include "SnapshotBuffer.h"
 
 // SIN and COS take arguments in DEGREES
 #define PI 3.14159265
@@ -192,15 +200,72 @@ protected:
 	inline virtual void renderAdditionalObservatories();
 
 	/**
-	 * \brief This method has to be called in order to update the BOINC client information
+	 * \brief Generic HUD content prepared by AbstractGraphicsEngine::updateBOINCInformation()
+	 *
+	 * Science run specific engines derive their own snapshot type from this one
+	 * and hand it over to the render thread using a SnapshotBuffer.
+	 */
+	struct HUDSnapshot
+	{
+		/// User name to be displayed in "BOINC Information" panel
+		string userName;
+
+		/// Team name to be displayed in "BOINC Information" panel
+		string teamName;
+
+		/// User total credit to be displayed in "BOINC Information" panel
+		string userCredit;
+
+		/// User recent average credit to be displayed in "BOINC Information" panel
+		string userRACredit;
+
+		/// Right ascension of the search marker (gunsight)
+		double rightAscension;
+
+		/// Declination of the search marker (gunsight)
+		double declination;
+
+		/// Render quality setting of the project preferences
+		BOINCClientAdapter::GraphicsQualitySetting qualitySetting;
+	};
+
+	/**
+	 * \brief This method has to be called in order to fetch the BOINC client information
 	 *
 	 * This is the local/generic implementation which calls
 	 * AbstractGraphicsEngine::refreshLocalBOINCInformation() first and
-	 * refreshes the "BOINC Statistics" afterwards.
+	 * prepares the "BOINC Statistics" afterwards. It's called by the worker thread.
 	 *
+	 * Note: the search marker coordinates are left to the specializing classes.
+	 *
+	 * \param snapshot The snapshot to be filled
+	 *
+	 * \see AbstractGraphicsEngine::updateBOINCInformation()
 	 * \see AbstractGraphicsEngine::refreshLocalBOINCInformation()
 	 */
-	virtual void refreshLocalBOINCInformation();
+	void updateLocalBOINCInformation(HUDSnapshot &snapshot);
+
+	/**
+	 * \brief This method has to be called in order to apply a new BOINC client snapshot
+	 *
+	 * This is the local/generic implementation which stores the "BOINC Statistics"
+	 * and updates the search marker (if its coordinates changed). A changed quality
+	 * setting is applied as well (see \ref applyQualitySetting()). It's called by
+	 * the render thread.
+	 *
+	 * \param snapshot The snapshot picked up from the worker thread
+	 *
+	 * \see AbstractGraphicsEngine::refreshBOINCInformation()
+	 */
+	void applyLocalBOINCInformation(const HUDSnapshot &snapshot);
+
+	/**
+	 * \brief Sets the OpenGL state according to the active quality setting
+	 *
+	 * Opt-in quality features (smoothing and fog) are enabled or disabled as
+	 * required by \ref m_QualitySetting.
+	 */
+	void applyQualitySetting();
 
 	/**
 	 * \brief Generates the OpenGL call lists for the displayed observatories
@@ -227,7 +292,8 @@ protected:
 		AXES = 128,
 		SEARCHINFO = 256,
 		LOGO = 512,
-		MARKER = 1024
+		MARKER = 1024,
+		WATERFALL = 2048
 	};
 
 	/**
@@ -251,7 +317,7 @@ protected:
 	 * \see Starsphere::Features
 	 * \see Starsphere::setFeature()
 	 */
-	inline bool isFeature(const Features feature);
+	bool isFeature(const Features feature);
 
 	/**
 	 * \brief Computes the Right Ascension of the zenith at a given time (from
@@ -288,6 +354,56 @@ protected:
 	 */
 	void sphVertex(GLfloat RAdeg, GLfloat DEdeg);
 
+	/**
+	 * \brief Adds a vertex in 3D sky sphere coordinates to the given batch
+	 *
+	 * \param batch The vertex batch to be extended
+	 * \param RAdeg The right ascension of the new vertex
+	 * \param DEdeg The declination of the new vertex
+	 * \param radius The radius of the sky sphere
+	 */
+	void sphVertex3D(VertexBatch &batch, GLfloat RAdeg, GLfloat DEdeg, GLfloat radius);
+
+	/**
+	 * \brief Adds a vertex on the surface of the sky sphere to the given batch
+	 *
+	 * \param batch The vertex batch to be extended
+	 * \param RAdeg The right ascension of the new vertex
+	 * \param DEdeg The declination of the new vertex
+	 */
+	void sphVertex(VertexBatch &batch, GLfloat RAdeg, GLfloat DEdeg);
+
+	/**
+	 * \brief Adds all entries of a precompiled star catalog on the surface of the sky sphere to the given batch
+	 *
+	 * \param batch The vertex batch to be extended
+	 * \param catalog The star catalog (unit vectors, no trigonometry required)
+	 */
+	void catalogVertices(VertexBatch &batch, const StarCatalog &catalog);
+
+	/**
+	 * \brief Converts sky coordinates in bulk (see SphericalCoordinates)
+	 *
+	 * The results are stored in \ref m_SphereX, \ref m_SphereY and \ref m_SphereZ.
+	 *
+	 * \param RAdeg The right ascensions of the vertices
+	 * \param DEdeg The declinations of the vertices (same number as \c RAdeg)
+	 * \param radius The radius of the sky sphere
+	 */
+	void sphConvert(const vector<GLfloat> &RAdeg, const vector<GLfloat> &DEdeg, GLfloat radius);
+
+	/**
+	 * \brief Adds several vertices on the surface of the sky sphere to the given batch
+	 *
+	 * \param batch The vertex batch to be extended
+	 * \param RAdeg The right ascensions of the new vertices
+	 * \param DEdeg The declinations of the new vertices (same number as \c RAdeg)
+	 */
+	void sphVertices(VertexBatch &batch, const vector<GLfloat> &RAdeg, const vector<GLfloat> &DEdeg);
+
+	/// Cartesian coordinates of the most recent bulk conversion (see sphConvert())
+	vector<GLfloat> m_SphereX, m_SphereY, m_SphereZ;
+
 	/// Radius of the celestial sphere
 	GLfloat sphRadius;
 
@@ -359,6 +475,15 @@ protected:
 	/// Refresh indicator when the search marker (gunsight) coordinates changed
 	bool m_RefreshSearchMarker;
 
+	/// Active render quality setting
+	BOINCClientAdapter::GraphicsQualitySetting m_QualitySetting;
+
+	/// Time of the first rendered frame (animation origin, negative until first frame)
+	double m_AnimationStartTime;
+
+	/// Time of the previously rendered frame (negative until first frame)
+	double m_AnimationLastTime;
+
 private:
 	/// Generate OpenGL display list for stars
 	void make_stars();
@@ -388,14 +513,27 @@ private:
 	void make_search_marker(GLfloat RAdeg, GLfloat DEdeg, GLfloat size);
 
 	/**
-	 * \brief Generate a single star vertex
+	 * \brief Prints the average frame time of the active render path and resets the counters
 	 *
-	 * \param RAdeg Right ascension in degrees
-	 * \param DEdeg Declination in degrees
-	 * \param size Point size of the star
+	 * \see m_UseVertexBatches
 	 */
-	void star_marker(float RAdeg, float DEdeg, float size);
+	void reportRenderPathTiming();
 
+	/**
+	 * \brief Draws a sky layer, culled against \ref m_SkyFrustum if enabled
+	 *
+	 * \param batch The vertex batch of the layer
+	 *
+	 * \see m_CullLayers
+	 */
+	void drawSkyLayer(const SkyBatch &batch);
+
+	/**
+	 * \brief Prints the average number of drawn vs. total sky layer primitives and resets the counters
+	 *
+	 * \see m_CullLayers
+	 */
+	void reportCullingStatistics();
 
 	/// Feature display list ID's
 	GLuint Axes, Stars, Constellations, Pulsars, SNRs;
@@ -406,6 +544,42 @@ private:
 	/// Feature display list ID's
 	GLuint sphGrid, SearchMarker;
 
+	/// Feature vertex batches (static geometry)
+	SkyBatch m_StarsBatch, m_PulsarsBatch, m_SNRsBatch;
+
+	/// Feature vertex batches (static geometry)
+	SkyBatch m_ConstellationsBatch, m_GlobeBatch;
+
+	/// Feature vertex batch (static geometry, not rotated)
+	VertexBatch m_AxesBatch;
+
+	/// Magnitude-aware star field (replaces the constellation stars if a star catalog file is available)
+	StarField m_StarField;
+
+	/// View frustum in sky coordinates (updated every frame)
+	ViewFrustum m_SkyFrustum;
+
+	/// Render path indicator: vertex batches (TRUE) or display lists (FALSE)
+	bool m_UseVertexBatches;
+
+	/// Accumulated frame time (seconds) of the active render path
+	double m_RenderPathFrameTime;
+
+	/// Number of frames rendered with the active render path
+	int m_RenderPathFrameCount;
+
+	/// Sky layer culling indicator (vertex batch render path only)
+	bool m_CullLayers;
+
+	/// Accumulated number of sky layer primitives drawn
+	double m_CullingDrawnPrimitives;
+
+	/// Accumulated number of sky layer primitives of the enabled layers
+	double m_CullingTotalPrimitives;
+
+	/// Number of frames accounted for in the culling statistics
+	int m_CullingFrameCount;
+
 	/**
 	 * \brief Current state of all features (bitmask)
 	 * \see Starsphere::Features()
@@ -465,24 +639,6 @@ private:
 	void zoomSphere(const int relativeZoom);
 };
 
-/// Constellation & star coordinates (starlist.C)
-extern float star_info[][2];
-
-/// Total number of stars
-extern int Nstars;
-
-/// Pulsar coordinates are (pulsar_list.C)
-extern float pulsar_info[][2];
-
-/// Total number of pulsars
-extern int Npulsars;
-
-/// SNR coordinates (snr_list.C)
-extern float SNR_info[][2];
-
-/// Total number of SNRs
-extern int NSNRs;
-
 /**
  * @}
  */
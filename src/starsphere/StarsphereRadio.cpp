@@ -22,12 +22,20 @@
 
 StarsphereRadio::StarsphereRadio() :
 	Starsphere(EinsteinRadioAdapter::SharedMemoryIdentifier),
+	m_PowerSpectrumBinBatch(GL_LINES),
+	m_PowerSpectrumEnvelopeBatch(GL_LINES),
+	m_Waterfall(WaterfallColumns, WaterfallRows),
+	m_WaterfallRow(WaterfallColumns, 0),
+	m_WaterfallData(WaterfallColumns * WaterfallRows, 0),
 	m_EinsteinAdapter(&m_BoincAdapter)
 {
-	m_WUDispersionMeasureValue = -1.0;
 	m_PowerSpectrumCoordSystemList = 0;
-	m_PowerSpectrumBinList = 0;
-	m_PowerSpectrumFreqBins = 0;
+	m_WaterfallTexture = 0;
+	m_WaterfallGeneration = 0;
+	m_WaterfallRowCount = 0;
+	m_WaterfallNextRow = 0;
+	m_WaterfallTextureGeneration = 0;
+	m_WaterfallTextureRowCount = 0;
 }
 
 StarsphereRadio::~StarsphereRadio()
@@ -38,9 +46,6 @@ void StarsphereRadio::initialize(const int width, const int height, const Resour
 {
 	Starsphere::initialize(width, height, font, recycle);
 
-	// store quality setting
-	m_QualitySetting = m_BoincAdapter.graphicsQualitySetting();
-
 	// check whether we initialize the first time or have to recycle (required for windoze)
 	if(!recycle) {
 
@@ -70,12 +75,18 @@ void StarsphereRadio::initialize(const int width, const int height, const Resour
 		m_PowerSpectrumLabelYOffset = 15.0;
 		m_PowerSpectrumLabelXPos = m_PowerSpectrumXPos + m_PowerSpectrumLabelXOffset;
 		m_PowerSpectrumLabelYPos = m_PowerSpectrumYPos - m_PowerSpectrumLabelYOffset;
+		m_PowerSpectrumBinBatch.setSize(m_PowerSpectrumBinWidth);
+
+		// adjust waterfall config (below the power spectrum label)
+		m_WaterfallHeight = 64.0;
+		m_WaterfallOriginHeightOffset = 150.0;
+		m_WaterfallYPos = height - m_WaterfallOriginHeightOffset;
 	}
 
 	// create large font instances using font resource (base address + size)
 	m_FontLogo1 = new OGLFT::TranslucentTexture(
-								&m_FontResource->data()->at(0),
-								m_FontResource->data()->size(),
+								m_FontResource->data(),
+								m_FontResource->size(),
 								26, 78 );
 
 	if ( m_FontLogo1 == 0 || !m_FontLogo1->isValid() ) {
@@ -87,8 +98,8 @@ void StarsphereRadio::initialize(const int width, const int height, const Resour
 
 	// create medium font instances using font resource (base address + size)
 	m_FontLogo2 = new OGLFT::TranslucentTexture(
-								&m_FontResource->data()->at(0),
-								m_FontResource->data()->size(),
+								m_FontResource->data(),
+								m_FontResource->size(),
 								12, 72 );
 
 	if ( m_FontLogo2 == 0 || !m_FontLogo2->isValid() ) {
@@ -98,8 +109,14 @@ void StarsphereRadio::initialize(const int width, const int height, const Resour
 
 	m_FontLogo2->setForegroundColor(0.75, 0.75, 0.75, 1.0);
 
-	// prepare power spectrum
+	// prepare power spectrum (buffer objects of a previous context are invalid, their names might be reused)
+	m_PowerSpectrumBinBatch.invalidate();
+	m_PowerSpectrumEnvelopeBatch.invalidate();
 	generatePowerSpectrumCoordSystem(m_PowerSpectrumXPos, m_PowerSpectrumYPos);
+	generatePowerSpectrumBins(m_PowerSpectrumXPos, m_PowerSpectrumYPos);
+
+	// prepare waterfall (textures of a previous context are invalid)
+	generateWaterfallTexture();
 
 	// prepare base class observatories (dimmed to 33%)
 	generateObservatories(0.33);
@@ -118,6 +135,7 @@ void StarsphereRadio::resize(const int width, const int height)
 	m_PowerSpectrumYPos = height - m_PowerSpectrumOriginHeightOffset;
 	m_PowerSpectrumLabelXPos = m_PowerSpectrumXPos + m_PowerSpectrumLabelXOffset;
 	m_PowerSpectrumLabelYPos = m_PowerSpectrumYPos - m_PowerSpectrumLabelYOffset;
+	m_WaterfallYPos = height - m_WaterfallOriginHeightOffset;
 
 	generatePowerSpectrumCoordSystem(m_PowerSpectrumXPos, m_PowerSpectrumYPos);
 	generatePowerSpectrumBins(m_PowerSpectrumXPos, m_PowerSpectrumYPos);
@@ -127,10 +145,12 @@ void StarsphereRadio::renderAdditionalObservatories() {
 	glCallList(m_areciboObservatory);
 }
 
-void StarsphereRadio::refreshBOINCInformation()
+void StarsphereRadio::updateBOINCInformation()
 {
+	SearchSnapshot &snapshot = m_Snapshots.writeBuffer();
+
 	// call base class implementation
-	Starsphere::refreshLocalBOINCInformation();
+	Starsphere::updateLocalBOINCInformation(snapshot);
 
 	// update local/specific content
 	m_EinsteinAdapter.refresh();
@@ -142,52 +162,39 @@ void StarsphereRadio::refreshBOINCInformation()
 	buffer.fill('0');
 	buffer.setf(ios::right, ios::adjustfield);
 
-	// store content required for our HUD (search info)
-	if(m_CurrentRightAscension != m_EinsteinAdapter.wuSkyPosRightAscension()) {
-		// we've got a new position, update search marker and HUD
-		m_CurrentRightAscension = m_EinsteinAdapter.wuSkyPosRightAscension();
-		m_RefreshSearchMarker = true;
-		buffer << "Ascension: " << fixed << m_CurrentRightAscension << " deg" << ends;
-		m_WUSkyPosRightAscension = buffer.str();
-		buffer.str("");
-	}
+	// prepare content required for our HUD (search info)
+	snapshot.rightAscension = m_EinsteinAdapter.wuSkyPosRightAscension();
+	snapshot.declination = m_EinsteinAdapter.wuSkyPosDeclination();
 
-	if(m_CurrentDeclination != m_EinsteinAdapter.wuSkyPosDeclination()) {
-		// we've got a new position, update search marker and HUD
-		m_CurrentDeclination = m_EinsteinAdapter.wuSkyPosDeclination();
-		m_RefreshSearchMarker = true;
-		buffer << "Declination: " << fixed << m_CurrentDeclination << " deg" << ends;
-		m_WUSkyPosDeclination = buffer.str();
-		buffer.str("");
-	}
+	buffer << "Ascension: " << fixed << snapshot.rightAscension << " deg" << ends;
+	snapshot.wuSkyPosRightAscension = buffer.str();
+	buffer.str("");
 
-	if(m_WUDispersionMeasureValue != m_EinsteinAdapter.wuDispersionMeasure()) {
-		// we've got a new dispersion measure, update HUD
-		m_WUDispersionMeasureValue = m_EinsteinAdapter.wuDispersionMeasure();
-		buffer << "DM: " << fixed << m_WUDispersionMeasureValue << " pc/cm3" << ends;
-		m_WUDispersionMeasure = buffer.str();
-		buffer.str("");
-	}
+	buffer << "Declination: " << fixed << snapshot.declination << " deg" << ends;
+	snapshot.wuSkyPosDeclination = buffer.str();
+	buffer.str("");
 
-	// update the following information every time (no need to check first)
+	buffer << "DM: " << fixed << m_EinsteinAdapter.wuDispersionMeasure() << " pc/cm3" << ends;
+	snapshot.wuDispersionMeasure = buffer.str();
+	buffer.str("");
 
 	buffer.precision(3);
 	buffer << "Orb. Radius: " << fixed << m_EinsteinAdapter.wuTemplateOrbitalRadius() << " ls" << ends;
-	m_WUTemplateOrbitalRadius = buffer.str();
+	snapshot.wuTemplateOrbitalRadius = buffer.str();
 	buffer.str("");
 
 	buffer.precision(0);
 	buffer << "Orb. Period: " << fixed << m_EinsteinAdapter.wuTemplateOrbitalPeriod() << " s" << ends;
-	m_WUTemplateOrbitalPeriod = buffer.str();
+	snapshot.wuTemplateOrbitalPeriod = buffer.str();
 	buffer.str("");
 
 	buffer.precision(2);
 	buffer << "Orb. Phase: " << fixed << m_EinsteinAdapter.wuTemplateOrbitalPhase() << " rad" << ends;
-	m_WUTemplateOrbitalPhase = buffer.str();
+	snapshot.wuTemplateOrbitalPhase = buffer.str();
 	buffer.str("");
 
 	buffer << "WU Completed: " << fixed << m_EinsteinAdapter.wuFractionDone() * 100 << " %" << ends;
-	m_WUPercentDone = buffer.str();
+	snapshot.wuPercentDone = buffer.str();
 	buffer.str("");
 
 	// show WU's total CPU time (previously accumulated + current session)
@@ -200,10 +207,53 @@ void StarsphereRadio::refreshBOINCInformation()
 							  << right << setw(2) << min << ":"
 							  << right << setw(2) << sec << ends;
 
-	m_WUCPUTime = buffer.str();
+	snapshot.wuCPUTime = buffer.str();
 
-	// update power spectrum bin data
-	generatePowerSpectrumBins(m_PowerSpectrumXPos, m_PowerSpectrumYPos);
+	// copy power spectrum (the adapter's data is owned by this thread)
+	snapshot.powerSpectrum = *m_EinsteinAdapter.wuTemplatePowerSpectrum();
+
+	// waterfall history (file I/O stays off the render thread)
+	updateWaterfall(snapshot);
+
+	// hand over to render thread
+	m_Snapshots.publish();
+}
+
+void StarsphereRadio::refreshBOINCInformation()
+{
+	// nothing new since last time
+	if(!m_Snapshots.acquire()) return;
+
+	const SearchSnapshot &snapshot = m_Snapshots.readBuffer();
+
+	const BOINCClientAdapter::GraphicsQualitySetting previousQualitySetting = m_QualitySetting;
+
+	// call base class implementation
+	Starsphere::applyLocalBOINCInformation(snapshot);
+
+	// Arecibo uses FSAA depending on the quality setting
+	if(m_QualitySetting != previousQualitySetting) {
+		generateObservatories(0.33);
+	}
+
+	// store content required for our HUD (search info)
+	m_WUSkyPosRightAscension = snapshot.wuSkyPosRightAscension;
+	m_WUSkyPosDeclination = snapshot.wuSkyPosDeclination;
+	m_WUDispersionMeasure = snapshot.wuDispersionMeasure;
+	m_WUTemplateOrbitalRadius = snapshot.wuTemplateOrbitalRadius;
+	m_WUTemplateOrbitalPeriod = snapshot.wuTemplateOrbitalPeriod;
+	m_WUTemplateOrbitalPhase = snapshot.wuTemplateOrbitalPhase;
+	m_WUPercentDone = snapshot.wuPercentDone;
+	m_WUCPUTime = snapshot.wuCPUTime;
+
+	// update power spectrum bin data (only when it changed)
+	if(m_PowerSpectrumFreqBins != snapshot.powerSpectrum) {
+		m_PowerSpectrumFreqBins = snapshot.powerSpectrum;
+		generatePowerSpectrumBins(m_PowerSpectrumXPos, m_PowerSpectrumYPos);
+	}
+
+	// upload new waterfall rows
+	refreshWaterfallTexture(snapshot);
 }
 
 void StarsphereRadio::renderSearchInformation()
@@ -226,6 +276,8 @@ void StarsphereRadio::renderSearchInformation()
 	m_FontText->draw(m_XStartPosRight, m_Y5StartPosBottom, m_WUTemplateOrbitalPeriod.c_str());
 	m_FontText->draw(m_XStartPosRight, m_Y6StartPosBottom, m_WUTemplateOrbitalPhase.c_str());
 
+	m_Profiler.startPhase(FrameProfiler::PhasePowerSpectrum);
+
 	// power spectrum label
 	m_FontText->draw(m_PowerSpectrumLabelXPos, m_PowerSpectrumLabelYPos, "Radio Signal Power Spectrum");
 
@@ -240,7 +292,9 @@ void StarsphereRadio::renderSearchInformation()
 	glPushMatrix();
 	glLoadIdentity();
 	glCallList(m_PowerSpectrumCoordSystemList);
-	glCallList(m_PowerSpectrumBinList);
+	m_PowerSpectrumBinBatch.draw();
+	m_PowerSpectrumEnvelopeBatch.draw();
+	if(isFeature(WATERFALL)) renderWaterfall();
 	glPopMatrix();
 	glEnable(GL_BLEND);
 
@@ -249,6 +303,8 @@ void StarsphereRadio::renderSearchInformation()
 		glEnable(GL_POINT_SMOOTH);
 		glEnable(GL_LINE_SMOOTH);
 	}
+
+	m_Profiler.stopPhase(FrameProfiler::PhasePowerSpectrum);
 }
 
 void StarsphereRadio::generatePowerSpectrumCoordSystem(const int originX, const int originY)
@@ -295,43 +351,183 @@ void StarsphereRadio::generatePowerSpectrumBins(const int originX, const int ori
 	// set pixel normalization factor for maximum bin height
 	GLfloat normalizationFactor = 255.0 / (m_PowerSpectrumHeight - axesYOffset);
 
-	// fetch pointer to power spectrum data
-	m_PowerSpectrumFreqBins = m_EinsteinAdapter.wuTemplatePowerSpectrum();
-	if(!m_PowerSpectrumFreqBins) {
-		cerr << "Power spectrum data currently unavailable!" << endl;
+	// available space (number of bars respectively pixel columns)
+	const size_t bars = (size_t) ((m_PowerSpectrumWidth - axesXOffset) / binXOffset) + 1;
+	const size_t columns = (size_t) (m_PowerSpectrumWidth - axesXOffset);
+
+	// vertex data is regenerated, buffer objects are reused
+	m_PowerSpectrumBinBatch.reset();
+	m_PowerSpectrumEnvelopeBatch.reset();
+
+	// check power spectrum data (there's none until refreshBOINCInformation() got the first snapshot)
+	if(m_PowerSpectrumFreqBins.empty()) return;
+
+	if(m_PowerSpectrumFreqBins.size() <= bars) {
+		// draw frequency bins (one bar each)
+		VertexBatch &batch = m_PowerSpectrumBinBatch;
+
+		for(size_t i = 0; i < m_PowerSpectrumFreqBins.size(); ++i) {
+			// show potential candidates (power >= 100)...
+			if(m_PowerSpectrumFreqBins[i] >= 100) {
+				 // ...in bright white
+				batch.color(1.0, 1.0, 1.0);
+			}
+			else {
+				// ...in light grey
+				batch.color(0.66, 0.66, 0.66);
+			}
+			// lower vertex
+			batch.vertex(offsetX + axesXOffset + i*binXOffset,
+						 offsetY + axesYOffset, 0.0);
+			// upper vertex
+			batch.vertex(offsetX + axesXOffset + i*binXOffset,
+						 offsetY + axesYOffset + m_PowerSpectrumFreqBins[i] / normalizationFactor, 0.0);
+		}
+
+		batch.upload(GL_STREAM_DRAW_ARB);
 		return;
 	}
 
+	// too many bins: decimate to min/max envelope (one column per pixel)
+	PowerSpectrumEnvelope::compute(m_PowerSpectrumFreqBins, columns,
+								   m_PowerSpectrumEnvelopeMinimum, m_PowerSpectrumEnvelopeMaximum);
+
+	VertexBatch &batch = m_PowerSpectrumEnvelopeBatch;
+
+	for(size_t i = 0; i < m_PowerSpectrumEnvelopeMinimum.size(); ++i) {
+		const GLfloat x = offsetX + axesXOffset + i;
+		const GLfloat minimum = offsetY + axesYOffset + m_PowerSpectrumEnvelopeMinimum[i] / normalizationFactor;
+		const GLfloat maximum = offsetY + axesYOffset + m_PowerSpectrumEnvelopeMaximum[i] / normalizationFactor;
+
+		// columns without spread (e.g. covering a single bin) are drawn like regular bars
+		const bool spread = m_PowerSpectrumEnvelopeMinimum[i] < m_PowerSpectrumEnvelopeMaximum[i];
+
+		if(spread) {
+			// baseline up to the minimum in dark grey
+			batch.color(0.33, 0.33, 0.33);
+			batch.vertex(x, offsetY + axesYOffset, 0.0);
+			batch.vertex(x, minimum, 0.0);
+		}
+
+		// show columns containing potential candidates (power >= 100)...
+		if(m_PowerSpectrumEnvelopeMaximum[i] >= 100) {
+			 // ...in bright white
+			batch.color(1.0, 1.0, 1.0);
+		}
+		else {
+			// ...in light grey
+			batch.color(0.66, 0.66, 0.66);
+		}
+
+		// minimum (or baseline) up to the maximum (the actual envelope)
+		batch.vertex(x, spread ? minimum : offsetY + axesYOffset, 0.0);
+		batch.vertex(x, maximum, 0.0);
+	}
+
+	batch.upload(GL_STREAM_DRAW_ARB);
+}
+
+void StarsphereRadio::generateWaterfallTexture()
+{
 	// delete existing, create new (required for windoze)
-	if(m_PowerSpectrumBinList) glDeleteLists(m_PowerSpectrumBinList, 1);
-	m_PowerSpectrumBinList = glGenLists(1);
-	glNewList(m_PowerSpectrumBinList, GL_COMPILE);
+	if(m_WaterfallTexture) glDeleteTextures(1, &m_WaterfallTexture);
+	glGenTextures(1, &m_WaterfallTexture);
 
-		glLineWidth(m_PowerSpectrumBinWidth);
+	glBindTexture(GL_TEXTURE_2D, m_WaterfallTexture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
 
-		// draw frequency bins
-		glBegin(GL_LINES);
-			// iterate over all bins
-			for(int i = 0; i < POWERSPECTRUM_BINS; ++i) {
-				// show potential candidates (power >= 100)...
-				if(m_PowerSpectrumFreqBins->at(i) >= 100) {
-					 // ...in bright white
-					glColor4f(1.0, 1.0, 1.0, 1.0);
-				}
-				else {
-					// ...in light grey
-					glColor4f(0.66, 0.66, 0.66, 1.0);
-				}
-				// lower vertex
-				glVertex2f(offsetX + axesXOffset + i*binXOffset,
-						   offsetY + axesYOffset);
-				// upper vertex
-				glVertex2f(offsetX + axesXOffset + i*binXOffset,
-						   offsetY + axesYOffset + m_PowerSpectrumFreqBins->at(i) / normalizationFactor);
-			}
-		glEnd();
+	// the ring buffer scrolls by wrapping around vertically
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 
-	glEndList();
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE, WaterfallColumns, WaterfallRows, 0,
+				 GL_LUMINANCE, GL_UNSIGNED_BYTE, &m_WaterfallData[0]);
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void StarsphereRadio::updateWaterfall(SearchSnapshot &snapshot)
+{
+	// new work unit or restored history (persistence is opt-in)
+	if(m_Waterfall.setWorkunit(m_BoincAdapter.wuName(),
+							   m_BoincAdapter.graphicsFeature("starsphere", "waterfall_history", false))) {
+		++m_WaterfallGeneration;
+		m_WaterfallRowCount = 0;
+	}
+
+	// append new power spectrum (resampled, keep peaks)
+	if(!snapshot.powerSpectrum.empty() && snapshot.powerSpectrum != m_WaterfallSpectrum) {
+		m_WaterfallSpectrum = snapshot.powerSpectrum;
+		PowerSpectrumEnvelope::compute(m_WaterfallSpectrum, WaterfallColumns,
+									   m_WaterfallMinimum, m_WaterfallRow);
+		m_Waterfall.append(&m_WaterfallRow[0]);
+		++m_WaterfallRowCount;
+	}
+
+	// hand over the whole history (snapshots might be superseded)
+	snapshot.waterfall.assign(m_Waterfall.data(), m_Waterfall.data() + WaterfallColumns * WaterfallRows);
+	snapshot.waterfallNextRow = m_Waterfall.nextRow();
+	snapshot.waterfallGeneration = m_WaterfallGeneration;
+	snapshot.waterfallRowCount = m_WaterfallRowCount;
+}
+
+void StarsphereRadio::refreshWaterfallTexture(const SearchSnapshot &snapshot)
+{
+	const unsigned long rows = snapshot.waterfallRowCount - m_WaterfallTextureRowCount;
+
+	if(snapshot.waterfallGeneration != m_WaterfallTextureGeneration || rows >= (unsigned long) WaterfallRows) {
+		// new work unit or restored history: upload everything
+		m_WaterfallData = snapshot.waterfall;
+		generateWaterfallTexture();
+	}
+	else if(rows > 0) {
+		// upload the new rows only (usually just one)
+		glBindTexture(GL_TEXTURE_2D, m_WaterfallTexture);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+		for(unsigned long i = 0; i < rows; ++i) {
+			const size_t offset = ((m_WaterfallNextRow + i) % WaterfallRows) * WaterfallColumns;
+			memcpy(&m_WaterfallData[offset], &snapshot.waterfall[offset], WaterfallColumns);
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, offset / WaterfallColumns, WaterfallColumns, 1,
+							GL_LUMINANCE, GL_UNSIGNED_BYTE, &m_WaterfallData[offset]);
+		}
+
+		glBindTexture(GL_TEXTURE_2D, 0);
+	}
+
+	m_WaterfallNextRow = snapshot.waterfallNextRow;
+	m_WaterfallTextureGeneration = snapshot.waterfallGeneration;
+	m_WaterfallTextureRowCount = snapshot.waterfallRowCount;
+}
+
+void StarsphereRadio::renderWaterfall()
+{
+	// oldest row at the bottom, newest row at the top (sample texel centers to avoid wrapping seams)
+	const GLfloat bottom = (m_WaterfallNextRow + 0.5) / WaterfallRows;
+	const GLfloat top = (m_WaterfallNextRow + WaterfallRows - 0.5) / WaterfallRows;
+
+	const GLfloat left = m_PowerSpectrumXPos;
+	const GLfloat right = m_PowerSpectrumXPos + m_PowerSpectrumWidth;
+
+	glEnable(GL_TEXTURE_2D);
+	glBindTexture(GL_TEXTURE_2D, m_WaterfallTexture);
+	glColor4f(1.0, 1.0, 1.0, 1.0);
+
+	glBegin(GL_QUADS);
+		glTexCoord2f(0.0, bottom);
+		glVertex2f(left, m_WaterfallYPos);
+		glTexCoord2f(1.0, bottom);
+		glVertex2f(right, m_WaterfallYPos);
+		glTexCoord2f(1.0, top);
+		glVertex2f(right, m_WaterfallYPos + m_WaterfallHeight);
+		glTexCoord2f(0.0, top);
+		glVertex2f(left, m_WaterfallYPos + m_WaterfallHeight);
+	glEnd();
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glDisable(GL_TEXTURE_2D);
 }
 
 void StarsphereRadio::generateObservatories(float dimFactor)
@@ -348,7 +544,7 @@ void StarsphereRadio::generateObservatories(float dimFactor)
 	GLfloat domeRadius = 0.2; // radius of the Arecibo telescope receiver dome
 
 	// get current time and UTC offset (for zenith position)
-	m_ObservatoryDrawTimeLocal = dtime();
+	m_ObservatoryDrawTimeLocal = currentTime();
 	time_t local = m_ObservatoryDrawTimeLocal;
 	tm *utc = gmtime(&local);
 	double utcOffset = difftime(local, mktime(utc));
@@ -382,43 +578,44 @@ void StarsphereRadio::generateObservatories(float dimFactor)
 		// lines used to draw triangles
 		glLineWidth(1.0);
 
-		// draw antenna dish
-		float originX = RAdeg;
-		float originY = DEdeg;
-		float vectorY1 = originY;
-		float vectorX1 = originX;
-		float vectorX;
-		float vectorY;
+		// antenna dish and receiver dome outlines (converted at once)
+		vector<GLfloat> RAs, DEs;
 		float angle;
 
+		RAs.push_back(RAdeg);
+		DEs.push_back(DEdeg);
+		for(int i=0; i <= 360; i++) {
+			angle = ((double)i) * factorRadDeg;
+			RAs.push_back(RAdeg + dishRadius * (float)sin(angle));
+			DEs.push_back(DEdeg + dishRadius * (float)cos(angle));
+		}
+		for(int i=0; i <= 360; i++) {
+			angle = ((double)i) * factorRadDeg;
+			RAs.push_back(RAdeg + domeRadius * (float)sin(angle));
+			DEs.push_back(DEdeg + domeRadius * (float)cos(angle));
+		}
+
+		sphConvert(RAs, DEs, sphRadius);
+
 		// make sure both side are visible
 		glDisable(GL_CULL_FACE);
 
+		// draw antenna dish (triangle fan around the origin)
 		glBegin(GL_TRIANGLES);
-			for(int i=0; i <= 360; i++) {
-				angle = ((double)i) * factorRadDeg;
-				vectorX = originX + dishRadius * (float)sin(angle);
-				vectorY = originY + dishRadius * (float)cos(angle);
-				sphVertex(originX, originY);
-				sphVertex(vectorX1, vectorY1);
-				sphVertex(vectorX, vectorY);
-				vectorY1 = vectorY;
-				vectorX1 = vectorX;
+			for(int i=2; i <= 361; i++) {
+				glVertex3f(m_SphereX[0], m_SphereY[0], m_SphereZ[0]);
+				glVertex3f(m_SphereX[i-1], m_SphereY[i-1], m_SphereZ[i-1]);
+				glVertex3f(m_SphereX[i], m_SphereY[i], m_SphereZ[i]);
 			}
 		glEnd();
 
 		// draw receiver dome
 		glColor3f(0.5, 0.5, 0.5);
 		glBegin(GL_TRIANGLES);
-			for(int i=0; i <= 360; i++) {
-				angle = ((double)i) * factorRadDeg;
-				vectorX = originX + domeRadius * (float)sin(angle);
-				vectorY = originY + domeRadius * (float)cos(angle);
-				sphVertex(originX, originY);
-				sphVertex(vectorX1, vectorY1);
-				sphVertex(vectorX, vectorY);
-				vectorY1 = vectorY;
-				vectorX1 = vectorX;
+			for(int i=363; i <= 722; i++) {
+				glVertex3f(m_SphereX[0], m_SphereY[0], m_SphereZ[0]);
+				glVertex3f(m_SphereX[i-1], m_SphereY[i-1], m_SphereZ[i-1]);
+				glVertex3f(m_SphereX[i], m_SphereY[i], m_SphereZ[i]);
 			}
 		glEnd();
 
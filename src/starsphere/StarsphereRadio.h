@@ -21,11 +21,14 @@
 #ifndef STARSPHERERADIO_H_
 #define STARSPHERERADIO_H_
 
+#include <cstring>
 #include <sstream>
 #include <vector>
 
 #include "Starsphere.h"
 #include "EinsteinRadioAdapter.h"
+#include "PowerSpectrumEnvelope.h"
+#include "WaterfallHistory.h"
 
 //FIXME: these can be removed after FFT testing!
 #include <cstdlib>
@@ -87,19 +90,74 @@ public:
 	 */
 	void resize(const int width, const int height);
 
+	/**
+	 * \brief This method is called when the BOINC client information should be fetched
+	 *
+	 * This method implements AbstractGraphicsEngine::updateBOINCInformation() and calls
+	 * Starsphere::updateLocalBOINCInformation() first and "adds" the specialized
+	 * parts afterwards. The result is published as a new snapshot.
+	 *
+	 * \see AbstractGraphicsEngine::updateBOINCInformation()
+	 * \see Starsphere::updateLocalBOINCInformation()
+	 */
+	void updateBOINCInformation();
+
 	/**
 	 * \brief This method is called when the BOINC client information should be updated
 	 *
-	 * This method implements AbstractGraphicsEngine::refreshBOINCInformation() and calls
-	 * Starsphere::refreshLocalBOINCInformation() first and "adds" the specialized
-	 * parts afterwards.
+	 * This method implements AbstractGraphicsEngine::refreshBOINCInformation(). It picks
+	 * up the latest snapshot (if any) and calls Starsphere::applyLocalBOINCInformation()
+	 * first and "adds" the specialized parts afterwards, including the power spectrum.
 	 *
 	 * \see AbstractGraphicsEngine::refreshBOINCInformation()
-	 * \see Starsphere::refreshLocalBOINCInformation()
+	 * \see Starsphere::applyLocalBOINCInformation()
 	 */
 	void refreshBOINCInformation();
 
 private:
+	/// HUD content prepared by updateBOINCInformation()
+	struct SearchSnapshot : public HUDSnapshot
+	{
+		/// Formatted search parameter "Right-Ascension" (degrees)
+		string wuSkyPosRightAscension;
+
+		/// Formatted search parameter "Declination" (degrees)
+		string wuSkyPosDeclination;
+
+		/// Formatted search parameter "Dispersion measure"
+		string wuDispersionMeasure;
+
+		/// Formatted template parameter "Projected orbital radius"
+		string wuTemplateOrbitalRadius;
+
+		/// Formatted template parameter "Orbital period"
+		string wuTemplateOrbitalPeriod;
+
+		/// Formatted template parameter "Initial orbital phase"
+		string wuTemplateOrbitalPhase;
+
+		/// Formatted search parameter "Percent done"
+		string wuPercentDone;
+
+		/// Formatted search parameter "CPU Time"
+		string wuCPUTime;
+
+		/// Power spectrum bin values of the current template
+		vector<unsigned char> powerSpectrum;
+
+		/// Waterfall history rows (ring buffer, see \ref WaterfallHistory)
+		vector<unsigned char> waterfall;
+
+		/// Index of the waterfall row to be written next (i.e. the oldest row)
+		size_t waterfallNextRow;
+
+		/// Number of times the waterfall history got replaced (new work unit or restored history)
+		unsigned int waterfallGeneration;
+
+		/// Number of rows appended since the waterfall history got replaced
+		unsigned long waterfallRowCount;
+	};
+
 	/**
 	 * \brief Render science run specific logo
 	 *
@@ -133,13 +191,53 @@ private:
 	void generatePowerSpectrumCoordSystem(const int originX, const int originY);
 
 	/**
-	 * \brief Creates an OpenGL call list which contains the dynamic power spectrum frequency bins
+	 * \brief Generates the vertex batches which contain the dynamic power spectrum frequency bins
+	 *
+	 * Spectra that fit into the display are drawn as one bar per bin. Larger spectra
+	 * are decimated to a min/max envelope with one column per pixel (see \ref PowerSpectrumEnvelope),
+	 * hence the number of vertices doesn't depend on the number of bins.
 	 *
 	 * \param originX The x-screen coordinate of the power spectrum's origin
 	 * \param originY The y-screen coordinate of the power spectrum's origin
 	 */
 	void generatePowerSpectrumBins(const int originX, const int originY);
 
+	/**
+	 * \brief Creates the waterfall texture and uploads the whole history
+	 *
+	 * This is only required when the context got (re)created or the history got replaced.
+	 */
+	void generateWaterfallTexture();
+
+	/**
+	 * \brief Maintains the waterfall history and adds it to the given snapshot
+	 *
+	 * Called by updateBOINCInformation(), i.e. not by the render thread, as persisting the
+	 * history involves file I/O. A new power spectrum is resampled to \ref WaterfallColumns
+	 * columns (keeping the maximum of larger spectra) and appended to the history.
+	 *
+	 * \param snapshot The snapshot to be handed over to the render thread
+	 */
+	void updateWaterfall(SearchSnapshot &snapshot);
+
+	/**
+	 * \brief Updates the waterfall texture using the given snapshot
+	 *
+	 * Only the rows appended since the last snapshot are uploaded, unless the history
+	 * got replaced or too many rows were missed (the whole texture is regenerated then).
+	 *
+	 * \param snapshot The snapshot prepared by updateWaterfall()
+	 */
+	void refreshWaterfallTexture(const SearchSnapshot &snapshot);
+
+	/**
+	 * \brief Renders the waterfall (power spectrum history) below the power spectrum
+	 *
+	 * The newest spectrum is shown at the top. Scrolling is achieved solely by offsetting
+	 * the texture coordinates by the history's ring position (the texture repeats vertically).
+	 */
+	void renderWaterfall();
+
 	/**
 	 * \brief Generates the OpenGL call lists for the displayed observatories
 	 *
@@ -153,11 +251,68 @@ private:
 	/// ID of the OpenGL call list which contains the static power spectrum coordinate system
 	GLuint m_PowerSpectrumCoordSystemList;
 
-	/// ID of the OpenGL call list which contains the dynamic power spectrum frequency bins
-	GLuint m_PowerSpectrumBinList;
+	/// Vertex batch which contains the dynamic power spectrum frequency bins (one bar per bin)
+	VertexBatch m_PowerSpectrumBinBatch;
+
+	/// Vertex batch which contains the dynamic power spectrum envelope (one column per pixel)
+	VertexBatch m_PowerSpectrumEnvelopeBatch;
+
+	/// Minimum power per envelope column
+	vector<unsigned char> m_PowerSpectrumEnvelopeMinimum;
+
+	/// Maximum power per envelope column
+	vector<unsigned char> m_PowerSpectrumEnvelopeMaximum;
 
 	/// Byte vector to hold the current power spectrum bin values
-	const vector<unsigned char>* m_PowerSpectrumFreqBins;
+	vector<unsigned char> m_PowerSpectrumFreqBins;
+
+	/// Number of columns of the waterfall (texture width)
+	static const int WaterfallColumns = 256;
+
+	/// Number of spectra kept in the waterfall (texture height)
+	static const int WaterfallRows = 128;
+
+	/// Power spectrum history shown as waterfall (owned by the BOINC update worker)
+	WaterfallHistory m_Waterfall;
+
+	/// ID of the OpenGL texture which contains the waterfall (rows are stored as ring buffer)
+	GLuint m_WaterfallTexture;
+
+	/// Resampled power spectrum (one waterfall row, owned by the BOINC update worker)
+	vector<unsigned char> m_WaterfallRow;
+
+	/// Minimum power per waterfall column (not displayed, owned by the BOINC update worker)
+	vector<unsigned char> m_WaterfallMinimum;
+
+	/// Power spectrum appended last to the waterfall history (owned by the BOINC update worker)
+	vector<unsigned char> m_WaterfallSpectrum;
+
+	/// Number of times the waterfall history got replaced (owned by the BOINC update worker)
+	unsigned int m_WaterfallGeneration;
+
+	/// Number of rows appended since the waterfall history got replaced (owned by the BOINC update worker)
+	unsigned long m_WaterfallRowCount;
+
+	/// Copy of the waterfall history contained in the texture
+	vector<unsigned char> m_WaterfallData;
+
+	/// Index of the texture's waterfall row to be written next (i.e. the oldest row)
+	size_t m_WaterfallNextRow;
+
+	/// Waterfall history generation contained in the texture
+	unsigned int m_WaterfallTextureGeneration;
+
+	/// Number of waterfall rows contained in the texture (since the history got replaced)
+	unsigned long m_WaterfallTextureRowCount;
+
+	/// Waterfall configuration setting (height)
+	GLfloat m_WaterfallHeight;
+
+	/// Waterfall configuration setting (vertical position of the origin relative to the window height)
+	GLfloat m_WaterfallOriginHeightOffset;
+
+	/// Waterfall configuration setting (vertical position)
+	GLfloat m_WaterfallYPos;
 
 	/// Power Spectrum configuration setting (width)
 	GLfloat m_PowerSpectrumWidth;
@@ -198,12 +353,12 @@ private:
 	/// Power Spectrum label configuration setting (vertical position relative to the power spectrum origin)
 	GLfloat m_PowerSpectrumLabelYOffset;
 
-	/// Active render quality setting
-	BOINCClientAdapter::GraphicsQualitySetting m_QualitySetting;
-
 	/// Specialized BOINC client adapter instance for information retrieval
 	EinsteinRadioAdapter m_EinsteinAdapter;
 
+	/// Snapshots handed over from the BOINC update worker to the render thread
+	SnapshotBuffer<SearchSnapshot> m_Snapshots;
+
 	/// Formatted string copy of the current WU's search parameter "Right-Ascension" (degrees)
 	string m_WUSkyPosRightAscension;
 
@@ -213,9 +368,6 @@ private:
 	/// Formatted string copy of the current WU's search parameter "Dispersion measure"
 	string m_WUDispersionMeasure;
 
-	/// Local value copy of the current WU's search parameter "Dispersion measure"
-	double m_WUDispersionMeasureValue;
-
 	/// Formatted string copy of the current template's search parameter "Projected orbital radius"
 	string m_WUTemplateOrbitalRadius;
 
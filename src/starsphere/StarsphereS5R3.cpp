@@ -53,8 +53,8 @@ void StarsphereS5R3::initialize(const int width, const int height, const Resourc
 
 	// create large font instances using font resource (base address + size)
 	m_FontLogo1 = new OGLFT::TranslucentTexture(
-								&m_FontResource->data()->at(0),
-								m_FontResource->data()->size(),
+								m_FontResource->data(),
+								m_FontResource->size(),
 								24, 72 );
 
 	if ( m_FontLogo1 == 0 || !m_FontLogo1->isValid() ) {
@@ -66,8 +66,8 @@ void StarsphereS5R3::initialize(const int width, const int height, const Resourc
 
 	// create medium font instances using font resource (base address + size)
 	m_FontLogo2 = new OGLFT::TranslucentTexture(
-								&m_FontResource->data()->at(0),
-								m_FontResource->data()->size(),
+								m_FontResource->data(),
+								m_FontResource->size(),
 								13, 78 );
 
 	if ( m_FontLogo2 == 0 || !m_FontLogo2->isValid() ) {
@@ -90,10 +90,12 @@ void StarsphereS5R3::resize(const int width, const int height)
 	m_XStartPosClock = width - 98;
 }
 
-void StarsphereS5R3::refreshBOINCInformation()
+void StarsphereS5R3::updateBOINCInformation()
 {
+	SearchSnapshot &snapshot = m_Snapshots.writeBuffer();
+
 	// call base class implementation
-	Starsphere::refreshLocalBOINCInformation();
+	Starsphere::updateLocalBOINCInformation(snapshot);
 
 	// update local/specific content
 	m_EinsteinAdapter.refresh();
@@ -105,28 +107,20 @@ void StarsphereS5R3::refreshBOINCInformation()
 	buffer.fill('0');
 	buffer.setf(ios::right, ios::adjustfield);
 
-	// store content required for our HUD (search info)
-	if(m_CurrentRightAscension != m_EinsteinAdapter.wuSkyPosRightAscension()) {
-		// we've got a new position, update search marker and HUD
-		m_CurrentRightAscension = m_EinsteinAdapter.wuSkyPosRightAscension();
-		m_RefreshSearchMarker = true;
-		buffer.str("");
-		buffer << "Ascension: " << fixed << m_CurrentRightAscension << " deg" << ends;
-		m_WUSkyPosRightAscension = buffer.str();
-	}
+	// prepare content required for our HUD (search info)
+	snapshot.rightAscension = m_EinsteinAdapter.wuSkyPosRightAscension();
+	snapshot.declination = m_EinsteinAdapter.wuSkyPosDeclination();
 
-	if(m_CurrentDeclination != m_EinsteinAdapter.wuSkyPosDeclination()) {
-		// we've got a new position, update search marker and HUD
-		m_CurrentDeclination = m_EinsteinAdapter.wuSkyPosDeclination();
-		m_RefreshSearchMarker = true;
-		buffer.str("");
-		buffer << "Declination: " << fixed << m_CurrentDeclination << " deg" << ends;
-		m_WUSkyPosDeclination = buffer.str();
-	}
+	buffer << "Ascension: " << fixed << snapshot.rightAscension << " deg" << ends;
+	snapshot.wuSkyPosRightAscension = buffer.str();
+
+	buffer.str("");
+	buffer << "Declination: " << fixed << snapshot.declination << " deg" << ends;
+	snapshot.wuSkyPosDeclination = buffer.str();
 
 	buffer.str("");
 	buffer << "Completed: " << fixed << m_EinsteinAdapter.wuFractionDone() * 100 << " %" << ends;
-	m_WUPercentDone = buffer.str();
+	snapshot.wuPercentDone = buffer.str();
 
 	// show WU's total CPU time (previously accumulated + current session)
 	double timeCPU = m_BoincAdapter.wuCPUTimeSpent() + m_EinsteinAdapter.wuCPUTime();
@@ -139,15 +133,41 @@ void StarsphereS5R3::refreshBOINCInformation()
 							<< right << setw(2) << min << ":"
 							<< right << setw(2) << sec << ends;
 
-	m_WUCPUTime = buffer.str();
+	snapshot.wuCPUTime = buffer.str();
 
 	// update current time string (clock)
 	char cBuffer[10] = {0};
-	time_t timeNow = time(0);
-	struct tm* timeLocal = localtime(&timeNow);
-	strftime(cBuffer, sizeof(cBuffer) - 1, "%H:%M:%S", timeLocal);
+	time_t timeNow = (time_t) currentTime();
+	struct tm timeLocal;
+#ifdef _WIN32
+	timeLocal = *localtime(&timeNow);
+#else
+	localtime_r(&timeNow, &timeLocal);
+#endif
+	strftime(cBuffer, sizeof(cBuffer) - 1, "%H:%M:%S", &timeLocal);
+
+	snapshot.currentTime = string(cBuffer);
+
+	// hand over to render thread
+	m_Snapshots.publish();
+}
 
-	m_CurrentTime = string(cBuffer);
+void StarsphereS5R3::refreshBOINCInformation()
+{
+	// nothing new since last time
+	if(!m_Snapshots.acquire()) return;
+
+	const SearchSnapshot &snapshot = m_Snapshots.readBuffer();
+
+	// call base class implementation
+	Starsphere::applyLocalBOINCInformation(snapshot);
+
+	// store content required for our HUD (search info)
+	m_WUSkyPosRightAscension = snapshot.wuSkyPosRightAscension;
+	m_WUSkyPosDeclination = snapshot.wuSkyPosDeclination;
+	m_WUPercentDone = snapshot.wuPercentDone;
+	m_WUCPUTime = snapshot.wuCPUTime;
+	m_CurrentTime = snapshot.currentTime;
 }
 
 void StarsphereS5R3::renderSearchInformation()
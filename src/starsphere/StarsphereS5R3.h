@@ -80,19 +80,50 @@ public:
 	 */
 	void resize(const int width, const int height);
 
+	/**
+	 * \brief This method is called when the BOINC client information should be fetched
+	 *
+	 * This method implements AbstractGraphicsEngine::updateBOINCInformation() and calls
+	 * Starsphere::updateLocalBOINCInformation() first and "adds" the sepcialized
+	 * parts afterwards. The result is published as a new snapshot.
+	 *
+	 * \see AbstractGraphicsEngine::updateBOINCInformation()
+	 * \see Starsphere::updateLocalBOINCInformation()
+	 */
+	void updateBOINCInformation();
+
 	/**
 	 * \brief This method is called when the BOINC client information should be updated
 	 *
-	 * This method implements AbstractGraphicsEngine::refreshBOINCInformation() and calls
-	 * Starsphere::refreshLocalBOINCInformation() first and "adds" the sepcialized
-	 * parts afterwards.
+	 * This method implements AbstractGraphicsEngine::refreshBOINCInformation(). It picks
+	 * up the latest snapshot (if any) and calls Starsphere::applyLocalBOINCInformation()
+	 * first and "adds" the sepcialized parts afterwards.
 	 *
 	 * \see AbstractGraphicsEngine::refreshBOINCInformation()
-	 * \see Starsphere::refreshLocalBOINCInformation()
+	 * \see Starsphere::applyLocalBOINCInformation()
 	 */
 	void refreshBOINCInformation();
 
 private:
+	/// HUD content prepared by updateBOINCInformation()
+	struct SearchSnapshot : public HUDSnapshot
+	{
+		/// Search parameter "Right-Ascension" (degrees)
+		string wuSkyPosRightAscension;
+
+		/// Search parameter "Declination" (degrees)
+		string wuSkyPosDeclination;
+
+		/// Search parameter "Percent done"
+		string wuPercentDone;
+
+		/// Search parameter "CPU Time"
+		string wuCPUTime;
+
+		/// String representation of the current time
+		string currentTime;
+	};
+
 	/**
 	 * \brief Render science run specific logo
 	 *
@@ -121,6 +152,9 @@ private:
 	/// Specialized BOINC client adapter instance for information retrieval
 	EinsteinS5R3Adapter m_EinsteinAdapter;
 
+	/// Snapshots handed over from the BOINC update worker to the render thread
+	SnapshotBuffer<SearchSnapshot> m_Snapshots;
+
 	/// Local copy of the current WU's search parameter "Right-Ascension" (degrees)
 	string m_WUSkyPosRightAscension;
 
@@ -0,0 +1,222 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "VertexBatch.h"
+
+#include <cstring>
+
+bool VertexBatch::m_BufferObjectSupported = false;
+PFNGLGENBUFFERSARBPROC VertexBatch::m_glGenBuffers = NULL;
+PFNGLBINDBUFFERARBPROC VertexBatch::m_glBindBuffer = NULL;
+PFNGLBUFFERDATAARBPROC VertexBatch::m_glBufferData = NULL;
+PFNGLDELETEBUFFERSARBPROC VertexBatch::m_glDeleteBuffers = NULL;
+
+VertexBatch::VertexBatch(const GLenum mode, const GLfloat size)
+{
+	m_Mode = mode;
+	m_Size = size;
+	m_Buffer = 0;
+
+	m_Color[0] = 1.0;
+	m_Color[1] = 1.0;
+	m_Color[2] = 1.0;
+}
+
+VertexBatch::~VertexBatch()
+{
+	// note: the context might be gone already, deleting unknown names is harmless
+	if(m_Buffer && m_BufferObjectSupported) m_glDeleteBuffers(1, &m_Buffer);
+}
+
+bool VertexBatch::initializeExtensions()
+{
+	m_BufferObjectSupported = false;
+
+	// check extension string first (entry points might be exported anyway)
+	const char *extensions = (const char*) glGetString(GL_EXTENSIONS);
+	if(!extensions || !strstr(extensions, "GL_ARB_vertex_buffer_object")) {
+		cerr << "Vertex buffer objects not supported, using client-side vertex arrays..." << endl;
+		return false;
+	}
+
+	// resolve entry points (might differ per context on windoze)
+	m_glGenBuffers = (PFNGLGENBUFFERSARBPROC) getProcAddress("glGenBuffersARB");
+	m_glBindBuffer = (PFNGLBINDBUFFERARBPROC) getProcAddress("glBindBufferARB");
+	m_glBufferData = (PFNGLBUFFERDATAARBPROC) getProcAddress("glBufferDataARB");
+	m_glDeleteBuffers = (PFNGLDELETEBUFFERSARBPROC) getProcAddress("glDeleteBuffersARB");
+
+	if(!(m_glGenBuffers && m_glBindBuffer && m_glBufferData && m_glDeleteBuffers)) {
+		cerr << "Vertex buffer object entry points unavailable, using client-side vertex arrays..." << endl;
+		return false;
+	}
+
+	m_BufferObjectSupported = true;
+
+	return true;
+}
+
+void* VertexBatch::getProcAddress(const char *name)
+{
+#ifdef HAVE_OSMESA
+	// offscreen context (headless mode) isn't managed by SDL
+	if(OSMesaGetCurrentContext()) return (void*) OSMesaGetProcAddress(name);
+#endif
+
+	return SDL_GL_GetProcAddress(name);
+}
+
+bool VertexBatch::isBufferObjectSupported()
+{
+	return m_BufferObjectSupported;
+}
+
+void VertexBatch::clear()
+{
+	m_Vertices.clear();
+
+	if(m_Buffer && m_BufferObjectSupported) m_glDeleteBuffers(1, &m_Buffer);
+	m_Buffer = 0;
+}
+
+void VertexBatch::invalidate()
+{
+	m_Buffer = 0;
+}
+
+void VertexBatch::reset()
+{
+	m_Vertices.clear();
+}
+
+void VertexBatch::setSize(const GLfloat size)
+{
+	m_Size = size;
+}
+
+void VertexBatch::color(const GLfloat red, const GLfloat green, const GLfloat blue)
+{
+	m_Color[0] = red;
+	m_Color[1] = green;
+	m_Color[2] = blue;
+}
+
+void VertexBatch::vertex(const GLfloat x, const GLfloat y, const GLfloat z)
+{
+	m_Vertices.push_back(m_Color[0]);
+	m_Vertices.push_back(m_Color[1]);
+	m_Vertices.push_back(m_Color[2]);
+	m_Vertices.push_back(x);
+	m_Vertices.push_back(y);
+	m_Vertices.push_back(z);
+}
+
+void VertexBatch::vertices(const GLfloat *x, const GLfloat *y, const GLfloat *z, const size_t count)
+{
+	if(count == 0) return;
+
+	const size_t offset = m_Vertices.size();
+	m_Vertices.resize(offset + 6 * count);
+
+	GLfloat *vertex = &m_Vertices[0] + offset;
+	for(size_t i = 0; i < count; ++i, vertex += 6) {
+		vertex[0] = m_Color[0];
+		vertex[1] = m_Color[1];
+		vertex[2] = m_Color[2];
+		vertex[3] = x[i];
+		vertex[4] = y[i];
+		vertex[5] = z[i];
+	}
+}
+
+void VertexBatch::upload(const GLenum usage)
+{
+	// without buffer objects we'll use the client-side copy directly
+	if(!m_BufferObjectSupported || m_Vertices.empty()) return;
+
+	if(!m_Buffer) m_glGenBuffers(1, &m_Buffer);
+
+	m_glBindBuffer(GL_ARRAY_BUFFER_ARB, m_Buffer);
+	m_glBufferData(GL_ARRAY_BUFFER_ARB, m_Vertices.size() * sizeof(GLfloat), &m_Vertices[0], usage);
+	m_glBindBuffer(GL_ARRAY_BUFFER_ARB, 0);
+}
+
+void VertexBatch::draw() const
+{
+	draw(0, size());
+}
+
+void VertexBatch::draw(const GLint first, const GLsizei count) const
+{
+	if(count <= 0 || first < 0 || first + count > size()) return;
+
+	if(m_Mode == GL_POINTS) {
+		glPointSize(m_Size);
+	}
+	else {
+		glLineWidth(m_Size);
+	}
+
+	// glInterleavedArrays() enables the required client states itself
+	if(m_Buffer) {
+		m_glBindBuffer(GL_ARRAY_BUFFER_ARB, m_Buffer);
+		glInterleavedArrays(GL_C3F_V3F, 0, 0);
+	}
+	else {
+		glInterleavedArrays(GL_C3F_V3F, 0, &m_Vertices[0]);
+	}
+
+	glDrawArrays(m_Mode, first, count);
+
+	if(m_Buffer) m_glBindBuffer(GL_ARRAY_BUFFER_ARB, 0);
+
+	glDisableClientState(GL_COLOR_ARRAY);
+	glDisableClientState(GL_VERTEX_ARRAY);
+}
+
+GLuint VertexBatch::compile(GLuint list) const
+{
+	// delete existing, create new (required for windoze)
+	if(list) glDeleteLists(list, 1);
+	list = glGenLists(1);
+	glNewList(list, GL_COMPILE);
+
+		if(m_Mode == GL_POINTS) {
+			glPointSize(m_Size);
+		}
+		else {
+			glLineWidth(m_Size);
+		}
+
+		glBegin(m_Mode);
+			for(size_t i = 0; i < m_Vertices.size(); i += VertexStride) {
+				glColor3fv(&m_Vertices[i]);
+				glVertex3fv(&m_Vertices[i+3]);
+			}
+		glEnd();
+
+	glEndList();
+
+	return list;
+}
+
+GLsizei VertexBatch::size() const
+{
+	return m_Vertices.size() / VertexStride;
+}
@@ -0,0 +1,248 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef VERTEXBATCH_H_
+#define VERTEXBATCH_H_
+
+#include <vector>
+#include <iostream>
+
+#include <SDL.h>
+#include <SDL_opengl.h>
+
+#ifdef HAVE_OSMESA
+#include <GL/osmesa.h>
+#endif
+
+using namespace std;
+
+/**
+ * \addtogroup starsphere Starsphere
+ * @{
+ */
+
+/**
+ * \brief Container for static geometry that is drawn with a single OpenGL call
+ *
+ * A batch collects interleaved colour and position data (\c GL_C3F_V3F) using an
+ * interface that resembles OpenGL's immediate mode (\ref color() and \ref vertex()).
+ * Once \ref upload() has been called the data is stored in a vertex buffer object
+ * (\c GL_ARB_vertex_buffer_object) and subsequently rendered with one \c glDrawArrays()
+ * call. If vertex buffer objects aren't supported by the driver the batch falls back
+ * to client-side vertex arrays, which still requires only one draw call.
+ *
+ * For comparison purposes a batch can also be compiled into a classic display list
+ * (see \ref compile()).
+ *
+ * \author Oliver Bock\n
+ * Max-Planck-Institute for Gravitational Physics\n
+ * Hannover, Germany
+ */
+class VertexBatch
+{
+public:
+	/**
+	 * \brief Constructor
+	 *
+	 * \param mode The OpenGL primitive type used to render the batch (e.g. \c GL_POINTS)
+	 * \param size The point size or line width (depending on \c mode) used to render the batch
+	 */
+	VertexBatch(const GLenum mode, const GLfloat size = 1.0);
+
+	/// Destructor
+	virtual ~VertexBatch();
+
+	/**
+	 * \brief Resolves the vertex buffer object entry points of the current OpenGL context
+	 *
+	 * This method has to be called once the OpenGL context has been created and
+	 * every time it has been recreated (required for windoze).
+	 *
+	 * \return TRUE if vertex buffer objects are supported, otherwise FALSE
+	 */
+	static bool initializeExtensions();
+
+	/**
+	 * \brief Query the availability of vertex buffer objects
+	 *
+	 * \return TRUE if vertex buffer objects are supported, otherwise FALSE
+	 *
+	 * \see initializeExtensions()
+	 */
+	static bool isBufferObjectSupported();
+
+	/**
+	 * \brief Removes all vertices and releases the vertex buffer object (if any)
+	 */
+	void clear();
+
+	/**
+	 * \brief Forgets the vertex buffer object (if any) without releasing it
+	 *
+	 * Call this after the OpenGL context has been recreated (required for windoze): the
+	 * buffer object died with the previous context and its name might already be in use
+	 * again, so it must not be deleted. The vertices are kept, call \ref upload() again
+	 * to create a new buffer object.
+	 */
+	void invalidate();
+
+	/**
+	 * \brief Removes all vertices but keeps the vertex buffer object (if any)
+	 *
+	 * This is meant for dynamic geometry that's regenerated and uploaded regularly
+	 * (see \ref upload()): both the client-side storage and the buffer object are reused.
+	 */
+	void reset();
+
+	/**
+	 * \brief Sets the point size or line width (depending on the primitive type) used to render the batch
+	 *
+	 * \param size The new point size or line width
+	 */
+	void setSize(const GLfloat size);
+
+	/**
+	 * \brief Sets the colour used for all subsequently added vertices (like glColor3f)
+	 *
+	 * \param red The red colour component
+	 * \param green The green colour component
+	 * \param blue The blue colour component
+	 */
+	void color(const GLfloat red, const GLfloat green, const GLfloat blue);
+
+	/**
+	 * \brief Adds a vertex using the current colour (like glVertex3f)
+	 *
+	 * \param x The x-coordinate of the new vertex
+	 * \param y The y-coordinate of the new vertex
+	 * \param z The z-coordinate of the new vertex
+	 */
+	void vertex(const GLfloat x, const GLfloat y, const GLfloat z);
+
+	/**
+	 * \brief Adds several vertices using the current colour
+	 *
+	 * \param x Pointer to the x-coordinates of the new vertices
+	 * \param y Pointer to the y-coordinates of the new vertices
+	 * \param z Pointer to the z-coordinates of the new vertices
+	 * \param count The number of vertices to add
+	 */
+	void vertices(const GLfloat *x, const GLfloat *y, const GLfloat *z, const size_t count);
+
+	/**
+	 * \brief Transfers the collected vertices into a vertex buffer object
+	 *
+	 * \param usage The usage hint passed to the driver (\c GL_STATIC_DRAW_ARB for geometry
+	 * that is created once, \c GL_STREAM_DRAW_ARB for geometry that changes regularly)
+	 */
+	void upload(const GLenum usage = GL_STATIC_DRAW_ARB);
+
+	/**
+	 * \brief Renders the whole batch
+	 *
+	 * \see upload()
+	 */
+	void draw() const;
+
+	/**
+	 * \brief Renders a contiguous range of the batch
+	 *
+	 * This allows for sorted geometry to be drawn partially (e.g. up to a certain threshold)
+	 * or in parts with different render states, all sourced from the same buffer object.
+	 *
+	 * \param first The index of the first vertex to be rendered
+	 * \param count The number of vertices to be rendered (empty or invalid ranges are ignored)
+	 *
+	 * \see upload()
+	 */
+	void draw(const GLint first, const GLsizei count) const;
+
+	/**
+	 * \brief Compiles the batch into a display list using immediate mode calls
+	 *
+	 * \param list The display list ID to be used (0 creates a new one, an existing list is replaced)
+	 *
+	 * \return The display list ID
+	 */
+	GLuint compile(GLuint list) const;
+
+	/**
+	 * \brief Retrieve the number of vertices in this batch
+	 *
+	 * \return The number of vertices
+	 */
+	GLsizei size() const;
+
+protected:
+	/// Number of floats per interleaved vertex (C3F_V3F)
+	static const int VertexStride = 6;
+
+	/// The OpenGL primitive type
+	GLenum m_Mode;
+
+	/// The interleaved vertex data (client-side copy)
+	vector<GLfloat> m_Vertices;
+
+private:
+	/// Batches own their buffer object, hence copying is not supported
+	VertexBatch(const VertexBatch &other);
+
+	/// Batches own their buffer object, hence assignment is not supported
+	VertexBatch& operator=(const VertexBatch &other);
+
+	/**
+	 * \brief Resolves an OpenGL entry point of the current context
+	 *
+	 * \param name The name of the OpenGL function
+	 *
+	 * \return The function's address (NULL if not available)
+	 */
+	static void* getProcAddress(const char *name);
+
+	/// The point size or line width
+	GLfloat m_Size;
+
+	/// The current colour (red, green, blue)
+	GLfloat m_Color[3];
+
+	/// The ID of the vertex buffer object (0 if not uploaded)
+	GLuint m_Buffer;
+
+	/// Indicator for vertex buffer object support
+	static bool m_BufferObjectSupported;
+
+	/// \c glGenBuffersARB entry point
+	static PFNGLGENBUFFERSARBPROC m_glGenBuffers;
+
+	/// \c glBindBufferARB entry point
+	static PFNGLBINDBUFFERARBPROC m_glBindBuffer;
+
+	/// \c glBufferDataARB entry point
+	static PFNGLBUFFERDATAARBPROC m_glBufferData;
+
+	/// \c glDeleteBuffersARB entry point
+	static PFNGLDELETEBUFFERSARBPROC m_glDeleteBuffers;
+};
+
+/**
+ * @}
+ */
+
+#endif /*VERTEXBATCH_H_*/
@@ -0,0 +1,122 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "ViewFrustum.h"
+
+#include <cmath>
+
+ViewFrustum::ViewFrustum()
+{
+	for(int i = 0; i < 6; ++i) {
+		m_Planes[i][0] = 0.0;
+		m_Planes[i][1] = 0.0;
+		m_Planes[i][2] = 0.0;
+		m_Planes[i][3] = 1.0;
+	}
+
+	m_Eye[0] = 0.0;
+	m_Eye[1] = 0.0;
+	m_Eye[2] = 0.0;
+	m_PixelScale = 1.0;
+}
+
+void ViewFrustum::update()
+{
+	GLfloat projection[16], modelview[16], clip[16];
+	GLint viewport[4];
+
+	glGetFloatv(GL_PROJECTION_MATRIX, projection);
+	glGetFloatv(GL_MODELVIEW_MATRIX, modelview);
+	glGetIntegerv(GL_VIEWPORT, viewport);
+
+	// combined transformation (column-major: clip = projection * modelview)
+	for(int column = 0; column < 4; ++column) {
+		for(int row = 0; row < 4; ++row) {
+			clip[4*column + row] = projection[row] * modelview[4*column]
+								 + projection[4 + row] * modelview[4*column + 1]
+								 + projection[8 + row] * modelview[4*column + 2]
+								 + projection[12 + row] * modelview[4*column + 3];
+		}
+	}
+
+	// planes are sums/differences of the fourth and the other rows (left, right, bottom, top, near, far)
+	for(int i = 0; i < 6; ++i) {
+		const int row = i / 2;
+		const GLfloat sign = i % 2 ? -1.0 : 1.0;
+
+		for(int j = 0; j < 4; ++j) {
+			m_Planes[i][j] = clip[4*j + 3] + sign * clip[4*j + row];
+		}
+
+		const GLfloat length = sqrt(m_Planes[i][0] * m_Planes[i][0] +
+									m_Planes[i][1] * m_Planes[i][1] +
+									m_Planes[i][2] * m_Planes[i][2]);
+		if(length > 0.0) {
+			for(int j = 0; j < 4; ++j) m_Planes[i][j] /= length;
+		}
+	}
+
+	// eye position: inverse rotation applied to the negated translation (no scaling involved)
+	for(int i = 0; i < 3; ++i) {
+		m_Eye[i] = -(modelview[4*i] * modelview[12] + modelview[4*i + 1] * modelview[13] + modelview[4*i + 2] * modelview[14]);
+	}
+
+	// projection[5] is the cotangent of half the vertical field of view
+	m_PixelScale = 0.5 * viewport[3] * projection[5];
+}
+
+bool ViewFrustum::intersectsSphere(const GLfloat centre[3], const GLfloat radius) const
+{
+	for(int i = 0; i < 6; ++i) {
+		const GLfloat distance = m_Planes[i][0] * centre[0] + m_Planes[i][1] * centre[1] +
+								 m_Planes[i][2] * centre[2] + m_Planes[i][3];
+		if(distance < -radius) return false;
+	}
+
+	return true;
+}
+
+bool ViewFrustum::intersectsCap(const GLfloat axis[3], const GLfloat cosAngle, const GLfloat radius) const
+{
+	// caps exceeding a hemisphere are bounded by the whole sphere
+	if(cosAngle <= 0.0) {
+		const GLfloat origin[3] = {0.0, 0.0, 0.0};
+		return intersectsSphere(origin, radius);
+	}
+
+	// the cap lies within the sphere through its rim circle
+	const GLfloat centre[3] = {
+		axis[0] * radius * cosAngle,
+		axis[1] * radius * cosAngle,
+		axis[2] * radius * cosAngle
+	};
+
+	return intersectsSphere(centre, radius * sqrt(1.0f - cosAngle * cosAngle));
+}
+
+const GLfloat* ViewFrustum::eye() const
+{
+	return m_Eye;
+}
+
+GLfloat ViewFrustum::pixelScale() const
+{
+	return m_PixelScale;
+}
@@ -0,0 +1,113 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef VIEWFRUSTUM_H_
+#define VIEWFRUSTUM_H_
+
+#include <SDL.h>
+#include <SDL_opengl.h>
+
+/**
+ * \addtogroup starsphere Starsphere
+ * @{
+ */
+
+/**
+ * \brief View frustum of the current OpenGL transformation, used for visibility tests
+ *
+ * \ref update() extracts the six clipping planes from the current projection and
+ * modelview matrices, hence they're expressed in the coordinate system of the object
+ * being drawn (e.g. the rotated sky sphere). The eye position is provided in the same
+ * coordinate system, allowing for distance dependent level of detail decisions.
+ *
+ * \author Oliver Bock\n
+ * Max-Planck-Institute for Gravitational Physics\n
+ * Hannover, Germany
+ */
+class ViewFrustum
+{
+public:
+	/// Constructor (the frustum contains everything until the first update)
+	ViewFrustum();
+
+	/**
+	 * \brief Extracts the frustum from the current OpenGL matrices and viewport
+	 *
+	 * This has to be called after the camera and all object transformations have been applied.
+	 */
+	void update();
+
+	/**
+	 * \brief Checks whether a sphere intersects the frustum (conservative)
+	 *
+	 * \param centre The centre of the sphere
+	 * \param radius The radius of the sphere
+	 *
+	 * \return FALSE if the sphere is completely outside the frustum, otherwise TRUE
+	 */
+	bool intersectsSphere(const GLfloat centre[3], const GLfloat radius) const;
+
+	/**
+	 * \brief Checks whether a spherical cap intersects the frustum (conservative)
+	 *
+	 * The cap is given by its bounding cone (see SkyIndex::bounds()) and the radius
+	 * of the sphere it's located on (centred at the origin).
+	 *
+	 * \param axis The axis of the cone (unit vector)
+	 * \param cosAngle The cosine of the cone's half opening angle
+	 * \param radius The radius of the sphere
+	 *
+	 * \return FALSE if the cap is completely outside the frustum, otherwise TRUE
+	 */
+	bool intersectsCap(const GLfloat axis[3], const GLfloat cosAngle, const GLfloat radius) const;
+
+	/**
+	 * \brief Retrieve the eye position
+	 *
+	 * \return The eye position (object coordinates)
+	 */
+	const GLfloat* eye() const;
+
+	/**
+	 * \brief Retrieve the scale of projected sizes
+	 *
+	 * An object of size \c s at distance \c d from the eye covers approximately
+	 * <code>s / d * pixelScale()</code> pixels on screen (vertically).
+	 *
+	 * \return The number of pixels per unit of size over distance
+	 */
+	GLfloat pixelScale() const;
+
+private:
+	/// The clipping planes (a, b, c, d with normalized normals pointing inwards)
+	GLfloat m_Planes[6][4];
+
+	/// The eye position (object coordinates)
+	GLfloat m_Eye[3];
+
+	/// The scale of projected sizes
+	GLfloat m_PixelScale;
+};
+
+/**
+ * @}
+ */
+
+#endif /*VIEWFRUSTUM_H_*/
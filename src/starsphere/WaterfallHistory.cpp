@@ -0,0 +1,220 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "WaterfallHistory.h"
+
+#include <cstring>
+#include <iostream>
+
+#include <boinc_api.h>
+
+const char *WaterfallHistory::FileName = "starsphere_waterfall.dat";
+
+/// History file identifier
+static const char WaterfallMagic[4] = {'E', 'a', 'H', 'w'};
+
+/// History file format version
+static const unsigned int WaterfallVersion = 2;
+
+/// History file byte order mark (header fields are stored little-endian)
+static const unsigned int WaterfallByteOrder = 0x01020304;
+
+/// Maximum length of the stored work unit name (including the terminating zero)
+static const size_t WaterfallNameSize = 256;
+
+/// History file header layout (byte offsets, the row data follows the header)
+enum WaterfallHeaderLayout {
+	MagicOffset = 0,
+	VersionOffset = 4,
+	ByteOrderOffset = 8,
+	ColumnsOffset = 12,
+	RowsOffset = 16,
+	NextRowOffset = 20,
+	NameOffset = 24,
+	HeaderSize = NameOffset + WaterfallNameSize
+};
+
+/// Stores a header field (little-endian)
+static void encodeField(unsigned char *buffer, const unsigned int value)
+{
+	buffer[0] = value & 0xff;
+	buffer[1] = (value >> 8) & 0xff;
+	buffer[2] = (value >> 16) & 0xff;
+	buffer[3] = (value >> 24) & 0xff;
+}
+
+/// Retrieves a header field (little-endian)
+static unsigned int decodeField(const unsigned char *buffer)
+{
+	return buffer[0] | (buffer[1] << 8) | (buffer[2] << 16) | ((unsigned int) buffer[3] << 24);
+}
+
+WaterfallHistory::WaterfallHistory(const size_t columns, const size_t rows) :
+	m_Data(columns * rows, 0)
+{
+	m_Columns = columns;
+	m_Rows = rows;
+	m_NextRow = 0;
+	m_Persistent = false;
+	m_File = NULL;
+}
+
+WaterfallHistory::~WaterfallHistory()
+{
+	closeFile();
+}
+
+bool WaterfallHistory::setWorkunit(const string &wuName, const bool persistent)
+{
+	const bool changed = wuName != m_WUName;
+
+	// nothing to do
+	if(!changed && persistent == m_Persistent) return false;
+
+	// a new work unit starts with an empty history
+	if(changed) {
+		m_WUName = wuName;
+		m_NextRow = 0;
+		m_Data.assign(m_Data.size(), 0);
+	}
+
+	closeFile();
+	m_Persistent = persistent;
+
+	if(persistent) {
+		// a previously stored history replaces the current one
+		return openFile() || changed;
+	}
+
+	return changed;
+}
+
+size_t WaterfallHistory::append(const unsigned char *row)
+{
+	const size_t written = m_NextRow;
+
+	memcpy(&m_Data[written * m_Columns], row, m_Columns);
+	m_NextRow = (m_NextRow + 1) % m_Rows;
+
+	if(m_File) writeRow(written);
+
+	return written;
+}
+
+const unsigned char* WaterfallHistory::data() const
+{
+	return &m_Data[0];
+}
+
+size_t WaterfallHistory::nextRow() const
+{
+	return m_NextRow;
+}
+
+size_t WaterfallHistory::columns() const
+{
+	return m_Columns;
+}
+
+size_t WaterfallHistory::rows() const
+{
+	return m_Rows;
+}
+
+bool WaterfallHistory::openFile()
+{
+	unsigned char header[HeaderSize];
+
+	// the file lives in the slot directory
+	boinc_resolve_filename_s(FileName, m_FileName);
+
+	// try to restore existing history
+	m_File = fopen(m_FileName.c_str(), "r+b");
+	if(m_File) {
+		vector<unsigned char> data(m_Data.size());
+
+		if(fread(header, sizeof(header), 1, m_File) == 1 &&
+		   memcmp(header + MagicOffset, WaterfallMagic, sizeof(WaterfallMagic)) == 0 &&
+		   decodeField(header + VersionOffset) == WaterfallVersion &&
+		   decodeField(header + ByteOrderOffset) == WaterfallByteOrder &&
+		   decodeField(header + ColumnsOffset) == m_Columns &&
+		   decodeField(header + RowsOffset) == m_Rows &&
+		   decodeField(header + NextRowOffset) < m_Rows &&
+		   header[HeaderSize - 1] == '\0' &&
+		   m_WUName.compare(0, WaterfallNameSize - 1, (const char*) header + NameOffset) == 0 &&
+		   fread(&data[0], data.size(), 1, m_File) == 1) {
+
+			m_NextRow = decodeField(header + NextRowOffset);
+			m_Data.swap(data);
+			return true;
+		}
+
+		// different work unit or incompatible file
+		fclose(m_File);
+	}
+
+	// start a new history file (current contents)
+	m_File = fopen(m_FileName.c_str(), "w+b");
+	if(!m_File) {
+		cerr << "Could not create waterfall history file: " << m_FileName << endl;
+		return false;
+	}
+
+	memset(header, 0, sizeof(header));
+	memcpy(header + MagicOffset, WaterfallMagic, sizeof(WaterfallMagic));
+	encodeField(header + VersionOffset, WaterfallVersion);
+	encodeField(header + ByteOrderOffset, WaterfallByteOrder);
+	encodeField(header + ColumnsOffset, m_Columns);
+	encodeField(header + RowsOffset, m_Rows);
+	encodeField(header + NextRowOffset, m_NextRow);
+	strncpy((char*) header + NameOffset, m_WUName.c_str(), WaterfallNameSize - 1);
+
+	if(fwrite(header, sizeof(header), 1, m_File) != 1 ||
+	   fwrite(&m_Data[0], m_Data.size(), 1, m_File) != 1 ||
+	   fflush(m_File) != 0) {
+		cerr << "Could not write waterfall history file: " << m_FileName << endl;
+		closeFile();
+	}
+
+	return false;
+}
+
+void WaterfallHistory::closeFile()
+{
+	if(m_File) fclose(m_File);
+	m_File = NULL;
+}
+
+void WaterfallHistory::writeRow(const size_t row)
+{
+	// only the ring position of the header changes
+	unsigned char nextRow[4];
+	encodeField(nextRow, m_NextRow);
+	const long rowOffset = HeaderSize + row * m_Columns;
+
+	if(fseek(m_File, NextRowOffset, SEEK_SET) != 0 ||
+	   fwrite(nextRow, sizeof(nextRow), 1, m_File) != 1 ||
+	   fseek(m_File, rowOffset, SEEK_SET) != 0 ||
+	   fwrite(&m_Data[row * m_Columns], m_Columns, 1, m_File) != 1 ||
+	   fflush(m_File) != 0) {
+		cerr << "Could not update waterfall history file, persistence disabled!" << endl;
+		closeFile();
+	}
+}
@@ -0,0 +1,161 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Oliver Bock                                     *
+ *   oliver.bock[AT]aei.mpg.de                                             *
+ *                                                                         *
+ *   This file is part of Einstein@Home.                                   *
+ *                                                                         *
+ *   Einstein@Home is free software: you can redistribute it and/or modify *
+ *   it under the terms of the GNU General Public License as published     *
+ *   by the Free Software Foundation, version 2 of the License.            *
+ *                                                                         *
+ *   Einstein@Home is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the          *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Einstein@Home. If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef WATERFALLHISTORY_H_
+#define WATERFALLHISTORY_H_
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * \addtogroup starsphere Starsphere
+ * @{
+ */
+
+/**
+ * \brief Ring buffer holding the most recent power spectra of a work unit (waterfall/spectrogram)
+ *
+ * Every row contains one (resampled) power spectrum. Rows are stored in a ring, i.e. appending
+ * a row only overwrites the oldest one and \ref nextRow() tells where the ring currently starts.
+ * This layout is identical to the texture used to render the history, hence a new row can be
+ * uploaded directly.
+ *
+ * Optionally the history is persisted in the current (slot) directory: every appended row is
+ * written to \ref FileName together with the updated header, so the history survives restarts
+ * of the graphics application as long as the work unit stays the same. The file layout is
+ * fixed (little-endian header fields), files of a different version or byte order are discarded.
+ *
+ * Note: persistence implies blocking file I/O, hence the history must not be maintained by
+ * the render thread (see AbstractGraphicsEngine::updateBOINCInformation()).
+ *
+ * \author Oliver Bock\n
+ * Max-Planck-Institute for Gravitational Physics\n
+ * Hannover, Germany
+ */
+class WaterfallHistory
+{
+public:
+	/**
+	 * \brief Constructor
+	 *
+	 * \param columns The number of columns per row
+	 * \param rows The number of rows (spectra) kept
+	 */
+	WaterfallHistory(const size_t columns, const size_t rows);
+
+	/// Destructor
+	virtual ~WaterfallHistory();
+
+	/**
+	 * \brief Selects the work unit the history belongs to
+	 *
+	 * A different work unit clears the history. If persistence is requested a previously
+	 * stored history of the same work unit is restored, otherwise a new file is created.
+	 *
+	 * \param wuName The name of the current work unit
+	 * \param persistent TRUE if the history should be persisted, otherwise FALSE
+	 *
+	 * \return TRUE if the history's contents were replaced (i.e. need to be uploaded again)
+	 */
+	bool setWorkunit(const string &wuName, const bool persistent);
+
+	/**
+	 * \brief Appends a row (replacing the oldest one)
+	 *
+	 * \param row Pointer to the row data (\ref columns() bytes)
+	 *
+	 * \return The index of the row that has been written
+	 */
+	size_t append(const unsigned char *row);
+
+	/**
+	 * \brief Retrieves the history data (\ref rows() times \ref columns() bytes)
+	 *
+	 * \return Pointer to the first row (not necessarily the oldest one)
+	 */
+	const unsigned char* data() const;
+
+	/**
+	 * \brief Retrieves the index of the row to be written next (i.e. the oldest row)
+	 *
+	 * \return The index of the next row
+	 */
+	size_t nextRow() const;
+
+	/// Retrieves the number of columns per row
+	size_t columns() const;
+
+	/// Retrieves the number of rows
+	size_t rows() const;
+
+	/// Logical name of the file used to persist the history (resolved by the BOINC API)
+	static const char *FileName;
+
+private:
+	/**
+	 * \brief Restores a persisted history or creates a new file
+	 *
+	 * \return TRUE if a history was restored, otherwise FALSE
+	 */
+	bool openFile();
+
+	/// Closes the history file (if any)
+	void closeFile();
+
+	/**
+	 * \brief Writes the header and a single row to the history file
+	 *
+	 * \param row The index of the row to be written
+	 */
+	void writeRow(const size_t row);
+
+	/// Number of columns per row
+	size_t m_Columns;
+
+	/// Number of rows
+	size_t m_Rows;
+
+	/// Index of the row to be written next
+	size_t m_NextRow;
+
+	/// Row data (ring buffer)
+	vector<unsigned char> m_Data;
+
+	/// Name of the work unit the history belongs to
+	string m_WUName;
+
+	/// Indicator whether persistence was requested
+	bool m_Persistent;
+
+	/// Physical name of the history file
+	string m_FileName;
+
+	/// History file (NULL if the history isn't persisted or persisting it failed)
+	FILE *m_File;
+};
+
+/**
+ * @}
+ */
+
+#endif /*WATERFALLHISTORY_H_*/
@@ -19,6 +19,7 @@
  ***************************************************************************/
 
 #include <cstdlib>
+#include <cstdio>
 #include <iostream>
 
 #include <diagnostics.h>
@@ -28,10 +29,14 @@
 #include "../erp_git_version.h"
 
 #include "WindowManager.h"
+#include "HeadlessRenderer.h"
 #include "ResourceFactory.h"
 #include "AbstractGraphicsEngine.h"
 #include "GraphicsEngineFactory.h"
 
+// generated by orc (build directory)
+#include "resources.h"
+
 #ifdef __APPLE__
 #include "EaHMacIcon.h"
 #ifdef __cplusplus
@@ -46,16 +51,83 @@ extern "C" {
 
 int main(int argc, char **argv)
 {
-    // print version info
-    if(argc == 2) {
-        string param(argv[1]);
-        if(param == "--version" || param == "-v") {
-            cout << "Version information:" << endl;
-            cout << "Graphics Application Revision: " << ERP_GIT_VERSION << endl;
-            cout << "BOINC Revision: " << SVN_VERSION << endl;
-            exit(0);
-        }
-    }
+	// command line options
+	bool optionFullscreen = false;
+	bool optionDemo = false;
+	bool optionHeadless = false;
+	bool optionBenchmark = false;
+	double benchmarkDuration = 60.0;
+	int headlessFrames = 100;
+	int headlessWidth = 800;
+	int headlessHeight = 600;
+	double headlessFrameRate = 20.0;
+	double headlessStartTime = 0.0;
+	string headlessDumpPrefix;
+	string profileFilename;
+	string packFilename;
+
+	for(int i = 1; i < argc; ++i) {
+		string param(argv[i]);
+
+		// print version info
+		if(param == "--version" || param == "-v") {
+			cout << "Version information:" << endl;
+			cout << "Graphics Application Revision: " << ERP_GIT_VERSION << endl;
+			cout << "BOINC Revision: " << SVN_VERSION << endl;
+			exit(0);
+		}
+		else if(param == "--fullscreen") {
+			optionFullscreen = true;
+		}
+		else if(param == "--demo") {
+			optionDemo = true;
+		}
+		else if(param == "--headless") {
+			optionHeadless = true;
+		}
+		else if(param.find("--frames=") == 0) {
+			headlessFrames = atoi(param.substr(9).c_str());
+		}
+		else if(param.find("--fps=") == 0) {
+			headlessFrameRate = atof(param.substr(6).c_str());
+		}
+		else if(param.find("--time=") == 0) {
+			headlessStartTime = atof(param.substr(7).c_str());
+		}
+		else if(param.find("--size=") == 0) {
+			if(sscanf(param.substr(7).c_str(), "%dx%d", &headlessWidth, &headlessHeight) != 2) {
+				cerr << "Invalid size (expected WIDTHxHEIGHT): " << param << endl;
+				exit(1);
+			}
+		}
+		else if(param.find("--dump=") == 0) {
+			headlessDumpPrefix = param.substr(7);
+		}
+		else if(param == "--benchmark") {
+			optionBenchmark = true;
+		}
+		else if(param.find("--benchmark=") == 0) {
+			optionBenchmark = true;
+			benchmarkDuration = atof(param.substr(12).c_str());
+		}
+		else if(param == "--profile") {
+			profileFilename = "starsphere_profile.csv";
+		}
+		else if(param.find("--profile=") == 0) {
+			profileFilename = param.substr(10);
+		}
+		else if(param.find("--resources=") == 0) {
+			packFilename = param.substr(12);
+		}
+		else {
+			cerr << "Unknown command line option ignored: " << param << endl;
+		}
+	}
+
+	if(headlessFrameRate <= 0.0) {
+		cerr << "Invalid frame rate: " << headlessFrameRate << endl;
+		exit(1);
+	}
 
     // enable BOINC diagnostics
 	// TODO: we might want to optimize this for glibc- and mingw-based stacktraces!
@@ -85,6 +157,56 @@ int main(int argc, char **argv)
 		exit(1);
 	}
 
+	// use external resource pack (if available), falling back to the compiled-in resources
+	if(packFilename.empty()) {
+		boinc_resolve_filename_s("starsphere.pack", packFilename);
+	}
+	if(factory.loadPack(packFilename)) {
+		cerr << "Using resource pack: " << packFilename << endl;
+	}
+
+	// enable frame profiling (dump on exit and on signal)
+	if(!profileFilename.empty()) {
+		graphics->profiler().enable(profileFilename);
+		FrameProfiler::installSignalHandler();
+	}
+
+	// render offscreen with fixed clock (no window, no event loop)
+	if(optionHeadless) {
+		HeadlessRenderer headless;
+		if(!headless.initialize(headlessWidth, headlessHeight)) {
+			cerr << "Headless renderer could not be initialized!" << endl;
+			delete graphics;
+			exit(1);
+		}
+
+		const Resource *fontResource = factory.createInstance(CompiledResources::FontSansSerif);
+		if(fontResource == NULL || fontResource->size() <= 0) {
+			cerr << "Font resource could not be loaded!" << endl;
+			delete graphics;
+			if(fontResource) delete fontResource;
+			exit(1);
+		}
+
+		graphics->setFixedTime(headlessStartTime);
+		graphics->initialize(headless.windowWidth(), headless.windowHeight(), fontResource);
+		graphics->updateBOINCInformation();
+		graphics->refreshBOINCInformation();
+
+		bool result = headless.renderFrames(graphics,
+											headlessFrames,
+											headlessStartTime,
+											1.0 / headlessFrameRate,
+											headlessDumpPrefix);
+
+		graphics->profiler().dump();
+
+		delete graphics;
+		delete fontResource;
+
+		exit(result ? 0 : 1);
+	}
+
     // initialize window manager
     if(!window.initialize()) {
     	cerr << "Window manager could not be initialized!" << endl;
@@ -93,8 +215,8 @@ int main(int argc, char **argv)
     }
 
 	// create font and icon resource instances
-	const Resource *fontResource = factory.createInstance("FontSansSerif");
-	const Resource *iconResource = factory.createInstance("AppIconBMP");
+	const Resource *fontResource = factory.createInstance(CompiledResources::FontSansSerif);
+	const Resource *iconResource = factory.createInstance(CompiledResources::AppIconBMP);
 
 	if(fontResource == NULL) {
 		cerr << "Font resource could not be loaded!" << endl;
@@ -102,15 +224,15 @@ int main(int argc, char **argv)
 		exit(1);
 	}
 
-	if(fontResource->data()->size() <= 0) {
+	if(fontResource->size() <= 0) {
 		cerr << "Font resource could not be loaded!" << endl;
 		delete graphics;
 		delete fontResource;
 		exit(1);
 	}
 
-	if(iconResource != NULL && iconResource->data()->size() > 0) {
-		window.setWindowIcon(&iconResource->data()->at(0), iconResource->data()->size());
+	if(iconResource != NULL && iconResource->size() > 0) {
+		window.setWindowIcon(iconResource->data(), iconResource->size());
 		delete iconResource;
 	}
 	else {
@@ -122,28 +244,38 @@ int main(int argc, char **argv)
     // register starsphere as event observer
     window.registerEventObserver(graphics);
 
+	// the benchmark runs on a synthetic clock starting at 0 (reproducible results)
+	if(optionBenchmark) graphics->setFixedTime(0.0);
+
 	// pepare rendering
 	graphics->initialize(window.windowWidth(), window.windowHeight(), fontResource);
+	graphics->updateBOINCInformation();
 	graphics->refreshBOINCInformation();
 
 	// check optional command line parameters
-	if(argc == 2) {
-		string param(argv[1]);
-		if(param == "--fullscreen") {
-			// set non-interactive mode (must do this first on Apple)
-			window.setScreensaverMode(true);
-		}
-		if(param == "--fullscreen" || param == "--demo") {
-			// switch to fullscreen (on windoze: after init!)
-			window.toggleFullscreen();
+	if(optionFullscreen) {
+		// set non-interactive mode (must do this first on Apple)
+		window.setScreensaverMode(true);
+	}
+	if(optionFullscreen || optionDemo) {
+		// switch to fullscreen (on windoze: after init!)
+		window.toggleFullscreen();
 #ifdef __APPLE__
-			SetMacSSLevel();
+		SetMacSSLevel();
 #endif
-		}
 	}
 
-	// enter main event loop
-	window.eventLoop();
+	if(optionBenchmark) {
+		// run scripted benchmark instead of the interactive event loop
+		BenchmarkDriver driver(benchmarkDuration);
+		window.benchmarkLoop(driver);
+	}
+	else {
+		// enter main event loop
+		window.eventLoop();
+	}
+
+	graphics->profiler().dump();
 
 	// clean up end exit
 	window.unregisterEventObserver(graphics);